@@ -9,4 +9,10 @@ namespace libvoicefeat::audio
         std::vector<float> samples{};                // normalized [-1.0, 1.0]
         int                sampleRate{};             // ex. 16000
     };
+
+    struct MultichannelAudioBuffer
+    {
+        std::vector<std::vector<float>> channels{};  // planar: one normalized sample vector per channel
+        int                             sampleRate{};
+    };
 }
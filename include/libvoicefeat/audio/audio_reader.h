@@ -1,19 +1,55 @@
 #pragma once
 
 #include "audio_buffer.h"
+#include "audio_stream.h"
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
 #include <source_location>
 
 #include "libvoicefeat/compat/source_location.h"
 
 namespace libvoicefeat::audio
 {
+    enum class AudioFormat
+    {
+        Auto,       // detected from the leading bytes
+        Wav,
+        Mp3
+    };
+
     class IAudioReader
     {
     public:
         virtual ~IAudioReader() = default;
         virtual AudioBuffer load(const std::filesystem::path& inputFile,
                                  libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) = 0;
+        [[nodiscard]] virtual std::unique_ptr<IAudioStream> open(const std::filesystem::path& inputFile,
+                                 libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) = 0;
+
+        // Channel-preserving load: planar samples instead of the mono downmix load() returns.
+        virtual MultichannelAudioBuffer loadChannels(const std::filesystem::path& inputFile,
+                                 libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current())
+        {
+            auto stream = open(inputFile, loc);
+            return readAllPlanar(*stream);
+        }
+
+        // Decoding from encoded bytes already in memory, e.g. received over the network. The stream reads
+        // the bytes in place, so they must outlive it.
+        [[nodiscard]] virtual std::unique_ptr<IAudioStream> openMemory(const void* data, std::size_t size) = 0;
+        virtual AudioBuffer loadMemory(const void* data, std::size_t size)
+        {
+            auto stream = openMemory(data, size);
+            return readAllMono(*stream);
+        }
     };
+
+    // Picks the reader from the file extension (.wav / .mp3, case-insensitive).
+    [[nodiscard]] std::unique_ptr<IAudioReader> createAudioReader(const std::filesystem::path& path);
+    [[nodiscard]] std::unique_ptr<IAudioReader> createAudioReader(AudioFormat format);
+
+    // RIFF/WAVE header, or an ID3v2 tag or MPEG audio frame sync for MP3; throws std::invalid_argument otherwise.
+    [[nodiscard]] AudioFormat detectAudioFormat(const void* data, std::size_t size);
 }
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "audio_buffer.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace libvoicefeat::audio
+{
+    // Sequential decoder over an opened audio source. Samples are delivered as interleaved float frames
+    // normalized to [-1.0, 1.0].
+    class IAudioStream
+    {
+    public:
+        virtual ~IAudioStream() = default;
+
+        [[nodiscard]] virtual int sampleRate() const = 0;
+        [[nodiscard]] virtual int channels() const = 0;
+        [[nodiscard]] virtual std::size_t totalFrames() const = 0;     // 0 when unknown
+
+        // Reads up to maxFrames frames into out (maxFrames * channels() floats); returns 0 at end of stream.
+        virtual std::size_t read(float* out, std::size_t maxFrames) = 0;
+
+        // Moves the read position to the given frame; past the end, the next read returns 0.
+        virtual void seek(std::size_t frame) = 0;
+    };
+
+    // Averages interleaved frames into mono, summing the channels in order.
+    void downmixToMono(const float* interleaved, std::size_t frames, int channels, float* mono);
+
+    // beforeBlock, when set, runs before every block read and may throw to abandon decoding.
+    [[nodiscard]] AudioBuffer readAllMono(IAudioStream& stream, const std::function<void()>& beforeBlock = {});
+    [[nodiscard]] MultichannelAudioBuffer readAllPlanar(IAudioStream& stream);
+    // Up to maxFrames frames from the current position, downmixed like readAllMono.
+    [[nodiscard]] AudioBuffer readMono(IAudioStream& stream, std::size_t maxFrames);
+}
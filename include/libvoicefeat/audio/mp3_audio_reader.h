@@ -12,5 +12,9 @@ namespace libvoicefeat::audio
     public:
         AudioBuffer load(const std::filesystem::path& inputFile,
                          libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) override;
+        [[nodiscard]] std::unique_ptr<IAudioStream> open(const std::filesystem::path& inputFile,
+                         libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) override;
+        [[nodiscard]] std::unique_ptr<IAudioStream> openMemory(const void* data, std::size_t size) override;
+        AudioBuffer loadMemory(const void* data, std::size_t size) override;
     };
 }
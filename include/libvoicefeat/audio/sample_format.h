@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace libvoicefeat::audio
+{
+    // Little-endian sample encodings found in WAV data chunks.
+    enum class SampleFormat
+    {
+        UInt8,      // PCM, offset binary around 128
+        Int16,
+        Int24,      // packed, 3 bytes per sample
+        Int32,
+        Float32,
+        Float64,
+        MuLaw,      // G.711
+        ALaw        // G.711
+    };
+
+    [[nodiscard]] std::size_t bytesPerSample(SampleFormat format);
+
+    // Decodes count samples from raw (any alignment) to float. Integer PCM is scaled by 2^-(bits - 1), so
+    // full scale maps to [-1, 1); floats are taken as stored; G.711 codes go through their 256-entry
+    // expansion table scaled like 16-bit PCM. Blocks of samples run through vector code for the ISA
+    // detected at runtime; every path produces the same values as the scalar conversion.
+    void convertToFloat(const unsigned char* raw, std::size_t count, SampleFormat format, float* out);
+}
@@ -30,12 +30,27 @@ namespace libvoicefeat::audio
         uint16_t blockAlign;
         uint16_t bitsPerSample;
     };
+
+    // Follows FmtChunk when audioFormat is WAVE_FORMAT_EXTENSIBLE; the real format code is in the first two
+    // bytes of subFormat.
+    struct FmtExtension
+    {
+        uint16_t cbSize;
+        uint16_t validBitsPerSample;
+        uint32_t channelMask;
+        uint8_t subFormat[16];
+    };
 #pragma pack(pop)
 
+    // PCM 8/16/24/32-bit, IEEE float 32/64-bit and G.711 mu-law/A-law, plain or WAVE_FORMAT_EXTENSIBLE,
+    // any channel count. Samples are converted straight to float (see sample_format.h).
     class WavAudioReader : public IAudioReader
     {
     public:
         AudioBuffer load(const std::filesystem::path& inputFile,
                          libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) override;
+        [[nodiscard]] std::unique_ptr<IAudioStream> open(const std::filesystem::path& inputFile,
+                         libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current()) override;
+        [[nodiscard]] std::unique_ptr<IAudioStream> openMemory(const void* data, std::size_t size) override;
     };
 }
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libvoicefeat
+{
+    struct BatchOptions
+    {
+        std::size_t maxConcurrency   = 0;   // files decoded/extracted at the same time (0 = pool size)
+        std::size_t maxInFlightBytes = 0;   // cap on the estimated working set of in-flight files (0 = unlimited)
+    };
+
+    struct BatchResult
+    {
+        std::filesystem::path path{};
+        Feature feature{};
+        std::string error{};                // empty when extraction succeeded
+
+        [[nodiscard]] bool ok() const { return error.empty(); }
+    };
+
+    // Extracts features from many files on one work-stealing pool. Files are claimed dynamically, and the
+    // frame blocks of long files are stolen by workers that run out of files, so mixed 1 s / 1 h corpora
+    // keep every core busy. Results come back in input order; a failing file only sets its own error.
+    class BatchExtractor
+    {
+    public:
+        explicit BatchExtractor(const CepstralConfig& config, const BatchOptions& options = {});
+        BatchExtractor(const CepstralConfig& config, const BatchOptions& options, std::shared_ptr<ThreadPool> pool);
+
+        [[nodiscard]] std::vector<BatchResult> extract(const std::vector<std::filesystem::path>& paths);
+
+    private:
+        [[nodiscard]] std::size_t estimateWorkingSet(const std::filesystem::path& path) const;
+
+        CepstralConfig _config{};
+        BatchOptions _options{};
+        std::shared_ptr<ThreadPool> _pool{};
+        CepstralExtractor _extractor;                   // shared by every file, so tables are built once
+    };
+}
@@ -46,6 +46,13 @@ namespace libvoicefeat {
         LPC
     };
 
+    enum class VadMode
+    {
+        Off,
+        Drop,
+        Floor
+    };
+
     // --------------------------
     // SUB-CONFIGS (OPTIONS)
     // --------------------------
@@ -61,6 +68,7 @@ namespace libvoicefeat {
         FilterbankType filterbank       = FilterbankType::Mel;    // filterbank type: Mel / Linear / Gammatone / Bark
         MelScale melScale               = MelScale::Slaney;       // mel frequency scale formula (HTK or Slaney)
         CompressionType compressionType = CompressionType::Log;
+        CepstralTransform transform     = CepstralTransform::DCT; // bands to cepstra: DCT-II, or LPC (autocorrelation -> all-pole model -> cepstrum)
     };
 
     struct FramingOptions {
@@ -80,6 +88,31 @@ namespace libvoicefeat {
         float preEmphasisCoeff              = 0.97f;               // pre-emphasis coefficient (typically 0.95–0.97)
     };
 
+    struct ThreadingOptions {
+        int numThreads                      = 1;                   // worker threads for frame-parallel compute (1 = serial)
+        bool chunkedResampling              = false;               // resample long inputs in parallel chunks (not bit-exact vs. single pass)
+    };
+
+    struct ResamplingOptions {
+        bool nativeRate                     = false;               // above sampleRate: scale framing/filterbank to the input rate instead of resampling
+    };
+
+    struct VadOptions {
+        VadMode mode                        = VadMode::Off;        // Drop: non-speech frames produce no row; Floor: they get the row of a silent frame
+        double energyThresholdDb            = -55.0;               // speech above this mean frame power (dB re full scale, after pre-emphasis and window)
+        double zcrMarginDb                  = 10.0;                // ... or up to this far below it with a high zero-crossing rate (unvoiced consonants)
+        double zeroCrossingRate             = 4800.0;              // zero crossings per second that count as high
+        int hangoverFrames                  = 10;                  // frames kept as speech after the last frame above the thresholds
+    };
+
+    // Outputs of one StageExtractor pass; stages after the last one selected are not computed.
+    struct StageSelection {
+        bool powerSpectrum                  = false;               // |X|^2 over all nFft / 2 + 1 bins
+        bool filterbankEnergies             = false;               // linear band energies (PNCC: channel powers), one column per filter
+        bool compressedEnergies             = false;               // bands after log / cube root / power normalization, e.g. log-mel
+        bool cepstra                        = true;                // the rows CepstralExtractor returns, energy and deltas included
+    };
+
     struct CepstralConfig {
         CepstralType type               = CepstralType::MFCC;     // type of cepstral feature (MFCC, LFCC, GFCC, PNCC, PLP)
 
@@ -87,6 +120,9 @@ namespace libvoicefeat {
         FeatureOptions feature {};                                 // feature-specific spectral/cepstral layout
         DeltaOptions delta {};                                     // delta / delta-delta options
         PreEmphasisOptions preemphasis {};                         // pre-emphasis options
+        ThreadingOptions threading {};                             // parallel execution options
+        ResamplingOptions resampling {};                           // handling of inputs at other sample rates
+        VadOptions vad {};                                         // voice activity gate in front of the FFT
     };
 
 
@@ -2,12 +2,28 @@
 
 #include "transformer.h"
 
+#include <cstddef>
+
 namespace libvoicefeat::dsp
 {
     class FFTTransformer : public ITransformer {
     public:
+        FFTTransformer() = default;
+        // Precomputes bit-reversal and twiddle tables for frames of frameSize samples (zero-padded to the
+        // next power of two). Other frame sizes fall back to the recursive transform; both give identical
+        // results.
+        explicit FFTTransformer(std::size_t frameSize);
+
         [[nodiscard]] std::vector<std::complex<float>> transform(const std::vector<float>& frame) const override;
+        // Complex input of exactly size() points, transformed in place.
+        void transformInPlace(std::vector<std::complex<float>>& data) const;
+        [[nodiscard]] std::size_t size() const { return _size; }
     private:
         void fft(std::vector<std::complex<float>>& data) const;
+        void fftPlanned(std::vector<std::complex<float>>& data) const;
+
+        std::size_t _size = 0;
+        std::vector<std::size_t> _bitReverse;
+        std::vector<std::complex<float>> _twiddles;    // stage of size m holds m/2 entries, stages in order
     };
-}
\ No newline at end of file
+}
@@ -23,4 +23,23 @@ namespace libvoicefeat::dsp
     private:
         int _windowSize = 0, _hopSize = 0;
     };
-}
\ No newline at end of file
+
+    // Incremental counterpart of FixedFrameExtractor: samples arrive in blocks and frames come out at the
+    // same positions the batch extractor would produce for the whole signal.
+    class StreamingFrameExtractor
+    {
+    public:
+        StreamingFrameExtractor(int windowSize, int hopSize);
+
+        // Appends every frame completed by these samples to out.
+        void push(const float* samples, std::size_t count, std::vector<Frame>& out);
+
+        [[nodiscard]] std::size_t framesEmitted() const { return _framesEmitted; }
+
+    private:
+        int _windowSize = 0, _hopSize = 0;
+        std::vector<float> _pending;
+        std::size_t _skip = 0;
+        std::size_t _framesEmitted = 0;
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "fft_transformer.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace libvoicefeat::dsp
+{
+    // Bins [binBegin, binEnd) of the nFft-point DFT of a real frame (zero-padded), for filterbanks that never
+    // look at the rest of the spectrum. One of two methods, the cheaper by operation count:
+    //
+    //   HalfLength  even and odd samples packed as one complex signal of nFft / 2 points and transformed with
+    //               the planned FFT; the split into the real spectrum, X[k] = E[k] + W^k O[k], runs only for
+    //               the requested bins
+    //   Goertzel    a second-order recursion per bin, one pass over the frame each, for a handful of bins
+    //
+    // transform() keeps the FFTTransformer layout (nFft values) with the other bins left at zero. The value
+    // of a bin depends only on nFft and the method, not on the range, and matches the full FFT to float
+    // rounding.
+    class PrunedTransformer : public ITransformer
+    {
+    public:
+        enum class Method
+        {
+            HalfLength,
+            Goertzel
+        };
+
+        PrunedTransformer(std::size_t nFft, std::size_t binBegin, std::size_t binEnd);
+        PrunedTransformer(std::size_t nFft, std::size_t binBegin, std::size_t binEnd, Method method);
+
+        [[nodiscard]] std::vector<std::complex<float>> transform(const std::vector<float>& frame) const override;
+
+        // Pruning pays off once the bins cover at most half of the nFft / 2 + 1 unique ones; wider bands keep
+        // the full FFT.
+        [[nodiscard]] static bool worthPruning(std::size_t nFft, std::size_t binBegin, std::size_t binEnd);
+
+        // The method the three-argument constructor picks for these bins.
+        [[nodiscard]] static Method cheaperMethod(std::size_t nFft, std::size_t binBegin, std::size_t binEnd);
+
+        // True when FFTTransformer pads frames of frameSize samples to size() points, so this transform can
+        // stand in for it.
+        [[nodiscard]] inline bool coversFrame(std::size_t frameSize) const
+        {
+            return frameSize <= _size && 2 * frameSize > _size;
+        }
+
+        [[nodiscard]] inline Method getMethod() const { return _method; }
+        [[nodiscard]] inline std::size_t getBinBegin() const { return _binBegin; }
+        [[nodiscard]] inline std::size_t getBinEnd() const { return _binEnd; }
+        [[nodiscard]] inline std::size_t size() const { return _size; }
+
+    private:
+        void halfLength(const std::vector<float>& frame, std::vector<std::complex<float>>& out) const;
+        void goertzel(const std::vector<float>& frame, std::vector<std::complex<float>>& out) const;
+
+        std::size_t _size = 0;
+        std::size_t _binBegin = 0, _binEnd = 0;
+        Method _method = Method::HalfLength;
+
+        FFTTransformer _half;                           // nFft / 2 points (HalfLength)
+        std::vector<std::complex<float>> _twiddles;     // W^k = exp(-2 pi i k / nFft) per requested bin (HalfLength)
+        std::vector<double> _cos, _sin;                 // cos and sin of 2 pi k / nFft per requested bin (Goertzel)
+    };
+}
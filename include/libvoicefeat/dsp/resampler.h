@@ -1,11 +1,57 @@
 #pragma once
 #include "libvoicefeat/audio/audio_buffer.h"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace libvoicefeat::utils
+{
+    class ThreadPool;
+}
+
 namespace libvoicefeat::dsp
 {
     class Resampler
     {
     public:
         [[nodiscard]] static audio::AudioBuffer resampleTo(const audio::AudioBuffer& in, int targetSampleRate);
+
+        // Chunk-parallel variant for long inputs. Chunks start on multiples of the rate period
+        // (inputRate / gcd(inputRate, targetRate)) so every chunk maps to a whole number of output samples,
+        // and each one is resampled with extra input on both sides that covers the sinc filter before the
+        // overlap is trimmed. The result matches single-pass resampleTo to within float rounding of the
+        // filter (about 1e-5). chunkSamples = 0 picks a size from the pool width. checkpoint, when set, runs
+        // before every chunk; an exception from it stops the call.
+        [[nodiscard]] static audio::AudioBuffer resampleTo(const audio::AudioBuffer& in, int targetSampleRate,
+                                                           utils::ThreadPool& pool, std::size_t chunkSamples = 0,
+                                                           const std::function<void()>& checkpoint = {});
+
+        // Input samples to keep on each side of a span, rounded up to a multiple of the rate period, so that
+        // resampling the extended window reproduces the single-pass output over the span (to float rounding).
+        // A window starting at input sample k * period starts at output sample k * targetRate / gcd.
+        [[nodiscard]] static std::size_t contextSamples(int inputSampleRate, int targetSampleRate);
+    };
+
+    // Block-wise mono resampler keeping filter state between calls, for pipelined decoding. Output matches
+    // Resampler::resampleTo up to float rounding inside the sinc filter.
+    class StreamingResampler
+    {
+    public:
+        StreamingResampler(int inputSampleRate, int targetSampleRate);
+        ~StreamingResampler();
+
+        StreamingResampler(const StreamingResampler&) = delete;
+        StreamingResampler& operator=(const StreamingResampler&) = delete;
+
+        // Appends the output produced for this block to out; pass endOfInput with the last block to flush.
+        void process(const std::vector<float>& in, bool endOfInput, std::vector<float>& out);
+        void process(const float* in, std::size_t count, bool endOfInput, std::vector<float>& out);
+
+    private:
+        struct State;
+        std::unique_ptr<State> _state;
+        double _ratio = 1.0;
     };
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "frame.h"
+#include "libvoicefeat/config.h"
+
+#include <vector>
+
+namespace libvoicefeat::dsp
+{
+    // Frame-level speech/non-speech decision from two time-domain measures, run on the frames handed to the
+    // transformer, so a gated frame costs one pass over its samples instead of an FFT. A frame is active when
+    // its mean power reaches options.energyThresholdDb, or reaches it less zcrMarginDb while crossing zero at
+    // least zeroCrossingRate times per second (quiet fricatives). Active frames start speech at once;
+    // speech then lasts hangoverFrames past the last active frame, which bridges short pauses and keeps
+    // word endings. Decisions depend only on the current and earlier frames, so streaming and batch agree.
+    class VoiceActivityDetector
+    {
+    public:
+        VoiceActivityDetector(const VadOptions& options, int sampleRate);
+
+        // Classifies the next frame in signal order.
+        [[nodiscard]] bool push(const Frame& frame);
+
+        // One decision per frame, in order.
+        [[nodiscard]] static std::vector<bool> detect(const std::vector<Frame>& frames, const VadOptions& options,
+                                                      int sampleRate);
+
+    private:
+        double _powerThreshold = 0.0;           // linear mean power
+        double _quietPowerThreshold = 0.0;      // linear mean power for frames with many zero crossings
+        double _crossingRate = 0.0;             // crossings per sample
+        int _hangoverFrames = 0;
+        int _remaining = 0;                     // hangover frames left after the last active frame
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace libvoicefeat
+{
+    enum class CacheKeyMode
+    {
+        AudioContent,       // hash of the audio file's bytes: renamed or copied files still hit
+        FileStat            // hash of canonical path, mtime and size: no read at all, misses after a touch
+    };
+
+    struct FeatureCacheOptions
+    {
+        std::filesystem::path directory{};                  // cache root, created if missing
+        std::uint64_t maxBytes = 1ull << 30;                // LRU cap on stored entries (0 = unlimited)
+        CacheKeyMode keyMode   = CacheKeyMode::AudioContent;
+    };
+
+    struct FeatureCacheStats
+    {
+        std::size_t hits      = 0;
+        std::size_t misses    = 0;
+        std::size_t evictions = 0;
+    };
+
+    // Canonical hash of every CepstralConfig field that can change the output. numThreads only counts with
+    // chunkedResampling, where the pool size sets the chunk layout; otherwise any thread count shares entries.
+    [[nodiscard]] std::uint64_t hashConfig(const CepstralConfig& config);
+
+    // Content-addressed cache in front of CepstralExtractor::extractFromFile. An entry is keyed by the
+    // audio key (see CacheKeyMode) and hashConfig(), and stores the final matrix, deltas included, as a
+    // small header plus raw floats, followed by the voice activity gate's speech frames when it is on.
+    // Entries are written to a temporary file and renamed into place, so concurrent writers, including other
+    // processes sharing the directory, never expose a partial entry; the eviction scan removes temporaries
+    // more than an hour old, left by writers that died before the rename. Hits are read through a memory
+    // map; their access time is the file's mtime, which is what the LRU eviction orders by once the
+    // directory grows past maxBytes. Instances in one process share the size count of a directory; entries
+    // written by other processes are counted at the next eviction scan.
+    class CachedExtractor
+    {
+    public:
+        CachedExtractor(const CepstralConfig& config, const FeatureCacheOptions& options);
+        CachedExtractor(std::shared_ptr<const CepstralExtractor> extractor, const FeatureCacheOptions& options);
+
+        [[nodiscard]] Feature extractFromFile(const std::string& path) const;
+
+        // Removes every entry in the directory.
+        void clear();
+
+        [[nodiscard]] FeatureCacheStats getStats() const;
+        [[nodiscard]] inline const CepstralExtractor& getExtractor() const { return *_extractor; }
+        [[nodiscard]] inline const std::filesystem::path& getDirectory() const { return _options.directory; }
+
+    private:
+        [[nodiscard]] std::filesystem::path entryPath(const std::filesystem::path& audioPath) const;
+        [[nodiscard]] std::optional<Feature> load(const std::filesystem::path& entry) const;
+        void store(const std::filesystem::path& entry, const Feature& feature) const;
+        // Called with the directory state's mutex held.
+        void evict() const;
+
+        std::shared_ptr<const CepstralExtractor> _extractor;
+        FeatureCacheOptions _options{};
+        std::uint64_t _configHash = 0;
+
+        // size accounting shared by every instance on the same directory in this process
+        struct DirectoryState;
+        [[nodiscard]] static std::shared_ptr<DirectoryState> sharedState(const std::filesystem::path& directory,
+                                                                         std::uint64_t scannedBytes);
+        std::shared_ptr<DirectoryState> _state;
+        mutable std::atomic<std::size_t> _hits{0};
+        mutable std::atomic<std::size_t> _misses{0};
+        mutable std::atomic<std::size_t> _evictions{0};
+    };
+}
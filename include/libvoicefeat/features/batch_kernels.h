@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace libvoicefeat::features::batch
+{
+    // Cross-frame kernels. Data for a group of frames is stored transposed, element-major with one lane per
+    // frame (value i of lane j at [i * width + j]), so every stage runs full-width vectors over frames no
+    // matter how many filters or coefficients there are. Each lane performs exactly the operations of the
+    // per-frame code in the same order, so results are bitwise identical to it.
+
+    // Frames per lane group for the ISA detected at runtime: 8 with AVX-512, 4 with AVX2, 2 otherwise.
+    [[nodiscard]] std::size_t laneWidth();
+
+    // bandsT[m][lane] = sum over k of magT[k][lane] * filters[m][k], for binBegin <= k < min(filter size,
+    // binEnd). Only rows k in that range of magT are read.
+    void filterbank(const std::vector<std::vector<double>>& filters, const double* magT, std::size_t binBegin,
+                    std::size_t binEnd, double* bandsT, std::size_t width);
+
+    // outT[k][lane] = sum over n of inT[n][lane] * basis[k][n], for n < min(basis row size, numInputs).
+    void dct(const std::vector<std::vector<double>>& basis, const double* inT, std::size_t numInputs,
+             double* outT, std::size_t width);
+
+    // Regression delta over one coefficient track (consecutive frames), with frame indices clamped at
+    // the edges: out[t] = norm * sum over n in 1..N of n * (track[t + n] - track[t - n]).
+    void deltaTrack(const float* track, std::size_t frames, int N, double norm, float* out);
+}
@@ -2,6 +2,14 @@
 
 #include "libvoicefeat/config.h"
 
+#include <cstddef>
+#include <deque>
+
+namespace libvoicefeat::utils
+{
+    class ThreadPool;
+}
+
 namespace libvoicefeat::features {
 
     [[nodiscard]] FeatureMatrix computeDelta(const FeatureMatrix& feature, int N = 2);
@@ -13,4 +21,59 @@ namespace libvoicefeat::features {
         int N = 2
     );
 
-}
\ No newline at end of file
+    // Row-parallel variants; every row is computed exactly as in the serial versions.
+    [[nodiscard]] FeatureMatrix computeDelta(const FeatureMatrix& feature, int N, utils::ThreadPool& pool);
+    [[nodiscard]] FeatureMatrix appendDeltas(
+        const FeatureMatrix& base,
+        bool useDelta,
+        bool useDeltaDelta,
+        int N,
+        utils::ThreadPool& pool
+    );
+
+    // Incremental appendDeltas() for callers that never hold the whole matrix: rows go in one at a time and
+    // come back with their deltas appended once N frames of lookahead (2N with delta-deltas) have arrived;
+    // finish() flushes the tail. Output is bitwise identical to appendDeltas() over all rows.
+    class StreamingDeltas
+    {
+    public:
+        StreamingDeltas(bool useDelta, bool useDeltaDelta, int N = 2);
+
+        // Appends every row completed by this one to out.
+        void push(FeatureVector row, FeatureMatrix& out);
+        void finish(FeatureMatrix& out);
+
+    private:
+        // One regression pass over a stream of rows, edges clamped like computeDelta().
+        class Stage
+        {
+        public:
+            Stage(int N, double norm) : _N(N), _norm(norm) {}
+
+            void push(FeatureVector row, FeatureMatrix& out);
+            void finish(FeatureMatrix& out);
+
+        private:
+            void emit(std::size_t last, FeatureMatrix& out);
+
+            int _N = 0;
+            double _norm = 0.0;
+            std::deque<FeatureVector> _window;      // inputs from index _first on
+            std::size_t _first = 0;
+            std::size_t _pushed = 0;
+            std::size_t _next = 0;                  // next output index
+        };
+
+        void feedDeltas(FeatureMatrix& deltas);
+        void assemble(FeatureMatrix& out);
+
+        bool _useDelta = false;
+        bool _useDeltaDelta = false;
+        Stage _delta;
+        Stage _deltaDelta;
+        std::deque<FeatureVector> _base;
+        std::deque<FeatureVector> _deltas;
+        std::deque<FeatureVector> _deltaDeltas;
+    };
+
+}
@@ -1,24 +1,108 @@
 #pragma once
 
+#include "feature_plan.h"
 #include "filterbanks/filterbank.h"
 #include "libvoicefeat/config.h"
 #include "libvoicefeat/audio/audio_buffer.h"
 #include "libvoicefeat/dsp/frame.h"
 #include "libvoicefeat/dsp/transformer.h"
 
+#include <deque>
+#include <memory>
+
+namespace libvoicefeat::utils
+{
+    class ThreadPool;
+}
+
 namespace libvoicefeat::features
 {
     using namespace libvoicefeat::dsp;
 
+    class PnccStage;
+
+    // One frame's values at the stages Feature::computeStages() ran; stages it skipped stay empty.
+    struct FrameStages
+    {
+        std::vector<double> power{};            // |X|^2, nFreqs bins
+        std::vector<double> bands{};            // filterbank outputs
+        std::vector<double> compressed{};       // compressed bands; empty for PowerNormalized (cross-frame)
+        FeatureVector row{};                    // computeFrame()'s row
+    };
+
     class Feature
     {
     public:
         FeatureMatrix compute(const std::vector<Frame>& frames,
                                             const ITransformer& transformer);
+        // Frame-parallel compute: each frame is written into its own output row, deltas run as a second
+        // parallel pass. The result is bitwise identical to the serial overload.
+        FeatureMatrix compute(const std::vector<Frame>& frames,
+                              const ITransformer& transformer,
+                              utils::ThreadPool& pool);
+
+        // Incremental compute for streaming callers: prepare() once from the first frame, computeFrame()
+        // from any number of threads, then hand every row back in frame order to finish() for deltas.
+        // With PowerNormalized compression, rows from computeFrame() hold the channel powers (then log
+        // energy) and only finish() or StreamingCepstra turn them into cepstra.
+        void prepare(const ITransformer& transformer, const Frame& firstFrame);
+        void prepare(int nFft);
+        [[nodiscard]] FeatureVector computeFrame(const Frame& frame, const ITransformer& transformer) const;
+        // Rows for frames [begin, end) through the cross-frame batched kernels (see batch_kernels.h), lane
+        // groups sized for the runtime ISA; bitwise identical to computeFrame() on each frame.
+        [[nodiscard]] FeatureMatrix computeFrames(const std::vector<Frame>& frames, std::size_t begin, std::size_t end,
+                                                  const ITransformer& transformer) const;
+        const FeatureMatrix& finish(FeatureMatrix rows);
+        const FeatureMatrix& finish(FeatureMatrix rows, utils::ThreadPool& pool);
+
+        // Voice activity gate (see VoiceActivityDetector), used by compute() when setVoiceActivity() enables it.
+        // detectVoiceActivity() classifies a prepared feature's frames, empty when the gate is off. The masked
+        // computeFrames() transforms only speech frames and gives the others the plan's silence row; the
+        // masked finish() records the speech frames and, in VadMode::Drop, removes the other rows before
+        // PNCC and the deltas, which then run over the speech frames as one sequence.
+        [[nodiscard]] std::vector<bool> detectVoiceActivity(const std::vector<Frame>& frames) const;
+        [[nodiscard]] FeatureMatrix computeFrames(const std::vector<Frame>& frames, std::size_t begin, std::size_t end,
+                                                  const ITransformer& transformer, const std::vector<bool>& voiced) const;
+        const FeatureMatrix& finish(FeatureMatrix rows, const std::vector<bool>& voiced);
+        const FeatureMatrix& finish(FeatureMatrix rows, const std::vector<bool>& voiced, utils::ThreadPool& pool);
+
+        // Spectrum-level entry point so several features can share one FFT per frame: magnitudeSpectrum()
+        // once, then computeFromSpectrum() on every prepared feature with the same FFT size.
+        [[nodiscard]] static std::vector<double> magnitudeSpectrum(const std::vector<std::complex<float>>& spec,
+                                                                   int nFreqs);
+        [[nodiscard]] FeatureVector computeFromSpectrum(const Frame& frame, const std::vector<double>& magnitude) const;
+        // Magnitudes in [binBegin, binEnd) only, zero elsewhere.
+        [[nodiscard]] static std::vector<double> magnitudeSpectrum(const std::vector<std::complex<float>>& spec,
+                                                                   int nFreqs, std::size_t binBegin,
+                                                                   std::size_t binEnd);
+        // nFreqs magnitudes of one frame over the plan's filter support (zero elsewhere). When the plan carries a
+        // pruned transform and the transformer is the planned FFT of the same size, only the support is computed.
+        [[nodiscard]] std::vector<double> frameMagnitude(const Frame& frame, const ITransformer& transformer) const;
+
+        // The stages up to the last one selected, for callers that want more than the cepstra (see
+        // StageExtractor). row is filled only when cepstra are selected and is bitwise computeFrame()'s row for
+        // the same magnitudes. The power spectrum covers every bin, so selecting it bypasses the plan's pruned
+        // transform. silenceStages() is the same for an all-zero frame.
+        [[nodiscard]] FrameStages computeStages(const Frame& frame, const ITransformer& transformer,
+                                                const StageSelection& stages) const;
+        [[nodiscard]] FrameStages silenceStages(const StageSelection& stages) const;
+
+        // Tables for this feature's options at the given FFT size. A plan set with setPlan() is reused by
+        // prepare() as long as the FFT size matches; changing any option drops it.
+        [[nodiscard]] std::shared_ptr<const FeaturePlan> makePlan(int nFft) const;
+        void setPlan(std::shared_ptr<const FeaturePlan> plan);
+        [[nodiscard]] inline const std::shared_ptr<const FeaturePlan>& getPlan() const { return _plan; }
 
         [[nodiscard]] inline FeatureOptions getOptions() const { return _options; }
         [[nodiscard]] inline CepstralType getCepstralType() const { return _cepstralType; }
         [[nodiscard]] inline const FeatureMatrix& getComputedMatrix() const { return _computed; }
+        // Restores rows computed earlier (e.g. read back from a cache); deltas must already be appended.
+        void setComputedMatrix(FeatureMatrix matrix);
+        // Frames the gate classified as speech, ascending; in VadMode::Drop row i of the matrix is frame
+        // getVoicedFrames()[i]. Empty when the gate is off.
+        [[nodiscard]] inline const std::vector<std::size_t>& getVoicedFrames() const { return _voicedFrames; }
+        void setVoicedFrames(std::vector<std::size_t> frames);
+        [[nodiscard]] inline const VadOptions& getVoiceActivity() const { return _vad; }
 
         void setOptions(const FeatureOptions& options);
         void setSampleRate(int sampleRate);
@@ -31,33 +115,58 @@ namespace libvoicefeat::features
         void setMelScale(MelScale melScale);
         void setCepstralType(CepstralType cepstralType);
         void setCompressionType(CompressionType compressionType);
+        void setCepstralTransform(CepstralTransform transform);
         void useDeltas(bool use);
         void useDeltaDeltas(bool use);
+        void setVoiceActivity(const VadOptions& vad);
 
         void applyPreEmphasis(std::vector<float>& samples, float coeff);
 
     private:
-        void normalizeFrequencyRange();
-        void setupFbParams(const int nFft);
-        [[nodiscard]] std::vector<double> magnitude(const std::vector<std::complex<float>>& spec, int nFreqs);
-        [[nodiscard]] std::vector<double> applyFilterbank(const std::vector<std::vector<double>>& filters,
-                                                          const std::vector<double>& mag);
-        void applyCompression(std::vector<double>& v, libvoicefeat::CompressionType type);
-
-        void processFrame(const Frame& frame,
-                          const std::vector<std::complex<float>>& spec, const std::vector<std::vector<double>>& filters,
-                          const int nFreqs);
-        void log(std::vector<double>& v);
-        void cubeRoot(std::vector<double>& v);
-        void powerNormalized(std::vector<double>& v);
-
-        void meanPowerNormalization(std::vector<double>& v);
-        void asymmetricNonlinear(std::vector<double>& v);
-        void spectralFloor(std::vector<double>& v);
-        [[nodiscard]] std::vector<double> dctII(const std::vector<double>& v, int numCoeffs);
-        // TODO: Real LPV/PLP implementation
-        std::vector<double> plpCepstraPlaceholder(const std::vector<double>& barkEnergies,
-                                                  int numCoeffs);
+        static void normalizeFrequencyRange(FeatureOptions& options);
+        // Sums over the plan's filter support only; weights outside it are zero.
+        [[nodiscard]] std::vector<double> applyFilterbank(const FeaturePlan& plan,
+                                                          const std::vector<double>& mag) const;
+        // Elementwise, so v may be one frame's bands or a band-major group of them (see batch_kernels.h).
+        void applyCompression(std::vector<double>& v, libvoicefeat::CompressionType type) const;
+        [[nodiscard]] inline bool isPowerNormalized() const
+        {
+            return _options.compressionType == CompressionType::PowerNormalized;
+        }
+
+        // Rows for frames[selected[0]], frames[selected[1]], ... through the batched kernels.
+        [[nodiscard]] FeatureMatrix computeSelected(const std::vector<Frame>& frames,
+                                                    const std::vector<std::size_t>& selected,
+                                                    const ITransformer& transformer) const;
+        // Records the speech frames of a mask over rows and drops the others in VadMode::Drop.
+        [[nodiscard]] FeatureMatrix gateRows(FeatureMatrix rows, const std::vector<bool>& voiced);
+
+        [[nodiscard]] FeatureVector processFrame(const Frame& frame,
+                                                 const std::vector<double>& mag,
+                                                 const FeaturePlan& plan) const;
+        // Filterbank outputs of one frame's magnitudes, on |X|^2 when the plan asks for it.
+        [[nodiscard]] std::vector<double> bandEnergies(const std::vector<double>& mag, const FeaturePlan& plan) const;
+        [[nodiscard]] FrameStages stagesFromMagnitude(const Frame& frame, const std::vector<double>& mag,
+                                                      const StageSelection& stages) const;
+        // DCT-II or LPC cepstra of compressed bands, per the plan's transform.
+        [[nodiscard]] FeatureVector cepstra(const std::vector<double>& bands, const FeaturePlan& plan) const;
+        // Rows from computeFrame() to cepstra; only PowerNormalized rows change.
+        [[nodiscard]] FeatureMatrix completeRows(FeatureMatrix rows) const;
+        void log(std::vector<double>& v) const;
+        void cubeRoot(std::vector<double>& v) const;
+        [[nodiscard]] static double logEnergy(const Frame& frame, const FeaturePlan& plan);
+        [[nodiscard]] static std::vector<std::vector<double>> buildDctBasis(int numInputs, int numCoeffs);
+        [[nodiscard]] std::vector<double> dctII(const std::vector<double>& v,
+                                                const std::vector<std::vector<double>>& basis) const;
+        // Equal-loudness weight (Hermansky 1990) of each filter's centre frequency, for power spectra.
+        [[nodiscard]] static std::vector<double> equalLoudness(const std::vector<std::vector<double>>& filters,
+                                                               int nFft, int sampleRate);
+        // Cosine basis that turns numInputs compressed bands into autocorrelation lags 0..order. The bands are
+        // taken as samples of a symmetric spectrum over [0, pi], padded with a copy of the first and last band.
+        [[nodiscard]] static std::vector<std::vector<double>> buildIdftBasis(int numInputs, int order);
+        // Autocorrelation via the IDFT basis, Levinson-Durbin for the predictor, then the LPC-to-cepstrum
+        // recursion: numCoeffs values with c0 = log of the prediction error.
+        [[nodiscard]] static std::vector<double> lpcCepstra(const std::vector<double>& bands, const FeaturePlan& plan);
 
         FeatureOptions _options{};
         CepstralType _cepstralType{CepstralType::MFCC};
@@ -65,6 +174,33 @@ namespace libvoicefeat::features
 
         bool _useDeltas{false}, _useDelteDeltas{false};
 
-        FilterbankParams _fbParams{};
+        VadOptions _vad{};
+        std::vector<std::size_t> _voicedFrames{};
+
+        std::shared_ptr<const FeaturePlan> _plan{};
+
+        friend class StreamingCepstra;
+    };
+
+    // Incremental counterpart of Feature::finish() before the deltas: rows from computeFrame() go in in
+    // frame order and come back as cepstra, bitwise identical to finish(). Only PowerNormalized rows are
+    // held back, by PnccStage::kMediumWindow frames; everything else passes straight through. The feature
+    // must be prepared and outlive the stream.
+    class StreamingCepstra
+    {
+    public:
+        explicit StreamingCepstra(const Feature& feature);
+        ~StreamingCepstra();
+
+        // Appends every row completed by this one to out.
+        void push(FeatureVector row, FeatureMatrix& out);
+        void finish(FeatureMatrix& out);
+
+    private:
+        void emit(std::vector<std::vector<double>>& channels, FeatureMatrix& out);
+
+        const Feature& _feature;
+        std::unique_ptr<PnccStage> _pncc;
+        std::deque<float> _energies;            // c0 of the rows still inside the medium-time window
     };
 }
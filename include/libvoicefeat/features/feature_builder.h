@@ -21,8 +21,10 @@ namespace libvoicefeat::features
         [[nodiscard]] FeatureBuilder setMelScale(const MelScale& melScale);
         [[nodiscard]] FeatureBuilder setCepstralType(const CepstralType& cepstralType);
         [[nodiscard]] FeatureBuilder setCompressionType(const CompressionType& compressionType);
+        [[nodiscard]] FeatureBuilder setCepstralTransform(const CepstralTransform& transform);
         [[nodiscard]] FeatureBuilder useDeltas(bool use);
         [[nodiscard]] FeatureBuilder useDeltaDeltas(bool use);
+        [[nodiscard]] FeatureBuilder setVoiceActivity(const VadOptions& vad);
 
         [[nodiscard]] Feature build() const;
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "libvoicefeat/config.h"
+#include "libvoicefeat/dsp/pruned_transformer.h"
+
+#include <memory>
+#include <vector>
+
+namespace libvoicefeat::features
+{
+    // Immutable per-configuration tables shared by every Feature computed with the same options and FFT
+    // size. Built once by Feature::makePlan and safe to read from any number of threads.
+    struct FeaturePlan
+    {
+        FeatureOptions options{};                       // options after range normalization
+        int nFft = 0;
+        int nFreqs = 0;                                 // nFft / 2 + 1
+        std::vector<std::vector<double>> filters{};     // numFilters x nFreqs
+        std::vector<std::vector<double>> dct{};         // DCT-II basis, numCoeffs x numFilters
+        bool powerSpectrum = false;                     // filters applied to |X|^2 instead of |X| (LPC, PNCC)
+        std::vector<std::vector<double>> idft{};        // LPC transform: autocorrelation lags 0..order x numFilters
+        double energyScale = 1.0;                       // applied to frame energy before the log (c0)
+        std::size_t binBegin = 0, binEnd = 0;           // bins with a nonzero filter weight; the rest is never read
+        std::shared_ptr<const dsp::PrunedTransformer> pruned{};     // only the support, when it is narrow enough
+        FeatureVector silence{};                        // row of an all-zero frame, for frames the voice activity gate skips
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace libvoicefeat::features
+{
+    // Cross-frame part of power-normalized cepstral coefficients (Kim & Stern, 2016), run on gammatone
+    // channel powers P[m, l] in frame order:
+    //
+    //   medium-time power  Q[m, l] = mean of P[m, l - M .. l + M]
+    //   noise removal      asymmetric low-pass lower envelope of Q subtracted and half-wave rectified,
+    //                      temporal masking on the result, a slow floor where the channel is not excited
+    //   channel weighting  the ratio of processed to medium-time power, averaged over neighbouring
+    //                      channels, scales the short-time power P
+    //   normalization      division by a running mean of the total power (forgetting factor 0.999)
+    //   nonlinearity       power law x^(1/15)
+    //
+    // Every channel keeps a few scalars of recursive state plus the 2M + 1 frames of the medium-time
+    // window, so each frame costs O(channels) and output lags input by M frames. Pushing the rows of a
+    // whole file and calling finish() gives exactly what any other split of the same rows gives.
+    class PnccStage
+    {
+    public:
+        static constexpr std::size_t kMediumWindow = 2;     // M: frames on each side of the medium-time mean
+
+        explicit PnccStage(std::size_t channels);
+
+        // One frame of channel powers; appends the output of every frame completed by it to out.
+        void push(const std::vector<double>& power, std::vector<std::vector<double>>& out);
+        // Emits the last M frames, with the medium-time window clamped to the frames that exist.
+        void finish(std::vector<std::vector<double>>& out);
+
+        [[nodiscard]] inline std::size_t getChannels() const { return _channels; }
+
+    private:
+        void emit(std::size_t last, std::vector<std::vector<double>>& out);
+
+        std::size_t _channels = 0;
+        std::vector<std::vector<double>> _window;   // ring of the last 2M + 1 power frames, by frame % size
+        std::size_t _pushed = 0;
+        std::size_t _next = 0;                      // next frame to emit
+
+        std::vector<double> _lowerEnvelope;         // asymmetric low-pass of Q, the noise level estimate
+        std::vector<double> _floor;                 // asymmetric low-pass of the rectified power
+        std::vector<double> _peak;                  // decaying peak for temporal masking
+        double _meanPower = 0.0;
+        bool _started = false;
+
+        std::vector<double> _medium, _processed;    // per-frame scratch
+    };
+}
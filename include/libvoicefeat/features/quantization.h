@@ -0,0 +1,41 @@
+#pragma once
+
+#include "libvoicefeat/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace libvoicefeat::features
+{
+    enum class QuantizationType
+    {
+        Float16,        // IEEE half, about 3 significant digits; no scale/offset
+        Int8,           // per-column affine, 256 levels between the column's min and max
+        Int16           // per-column affine, 65536 levels
+    };
+
+    [[nodiscard]] std::size_t bytesPerElement(QuantizationType type);
+
+    // Compact row-major copy of a FeatureMatrix. For the integer types, element (r, c) stands for
+    // offset[c] + scale[c] * q with q the stored signed integer, so the reconstruction error of any element
+    // is at most scale[c] / 2. Float16 leaves scale and offset empty.
+    struct QuantizedMatrix
+    {
+        QuantizationType type = QuantizationType::Int8;
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+        std::vector<float> scale{};
+        std::vector<float> offset{};
+        std::vector<std::uint8_t> data{};         // rows * cols * bytesPerElement(type), little-endian
+
+        [[nodiscard]] inline bool empty() const { return rows == 0; }
+        [[nodiscard]] float at(std::size_t row, std::size_t col) const;
+        void dequantizeRow(std::size_t row, float* out) const;
+        [[nodiscard]] FeatureMatrix dequantize() const;
+    };
+
+    // Per-column ranges come from the matrix itself, so quantizing needs all rows; a constant column gets
+    // scale 1 and reconstructs exactly.
+    [[nodiscard]] QuantizedMatrix quantize(const FeatureMatrix& matrix, QuantizationType type);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "libvoicefeat/config.h"
+#include "libvoicefeat/utils/mapped_file.h"
+
+namespace libvoicefeat::io
+{
+    // Compressed container for many feature matrices ("LVFA"). Each matrix is cut into chunks of a fixed
+    // number of frames that are compressed independently and losslessly: every value's float bits minus
+    // those of the same column one frame earlier, byte-shuffled into four planes, each plane Huffman coded
+    // on its own (or stored as is when that does not pay off). The gain comes from the sign/exponent plane;
+    // mantissa bytes of cepstra are close to random, so expect roughly 80-85 % of the float32 size, less
+    // for smooth or constant tracks. Chunks that would not shrink are stored raw. A footer index maps each
+    // key to its chunks, so reading a frame range only decodes the chunks that overlap it.
+
+    // Writes the chunks sequentially and the index on close() (or in the destructor). Keys must be
+    // non-empty and unique within the archive.
+    class FeatureArchiveWriter
+    {
+    public:
+        explicit FeatureArchiveWriter(const std::filesystem::path& path, std::size_t chunkFrames = 256);
+        ~FeatureArchiveWriter();
+
+        FeatureArchiveWriter(const FeatureArchiveWriter&) = delete;
+        FeatureArchiveWriter& operator=(const FeatureArchiveWriter&) = delete;
+
+        void write(const std::string& key, const FeatureMatrix& matrix);
+        void write(const std::string& key, const float* data, std::size_t rows, std::size_t cols);
+        void close();
+
+        [[nodiscard]] inline std::size_t getNumWritten() const { return _entries.size(); }
+        // Feature bytes as float32 and as stored, chunks only.
+        [[nodiscard]] inline std::uint64_t getRawBytes() const { return _rawBytes; }
+        [[nodiscard]] inline std::uint64_t getStoredBytes() const { return _storedBytes; }
+
+    private:
+        struct Chunk
+        {
+            std::uint64_t offset = 0;
+            std::uint32_t size = 0;
+            std::uint8_t codec = 0;
+        };
+
+        struct Entry
+        {
+            std::string key;
+            std::uint64_t rows = 0;
+            std::uint32_t cols = 0;
+            std::vector<Chunk> chunks;
+        };
+
+        void writeChunk(const float* frames, std::size_t count, std::size_t cols, Entry& entry);
+
+        std::string _name;
+        std::ofstream _out;
+        std::size_t _chunkFrames = 0;
+        std::uint64_t _offset = 0;
+        std::uint64_t _rawBytes = 0;
+        std::uint64_t _storedBytes = 0;
+        std::vector<Entry> _entries;
+        std::unordered_set<std::string> _keys;
+        std::vector<unsigned char> _scratch;
+    };
+
+    // Maps an archive and reads matrices or frame ranges by key. Const members may be called from any
+    // number of threads.
+    class FeatureArchiveReader
+    {
+    public:
+        explicit FeatureArchiveReader(const std::filesystem::path& path);
+
+        [[nodiscard]] bool contains(const std::string& key) const;
+        // Both throw std::out_of_range for an unknown key.
+        [[nodiscard]] std::size_t getRows(const std::string& key) const;
+        [[nodiscard]] std::size_t getCols(const std::string& key) const;
+
+        [[nodiscard]] FeatureMatrix read(const std::string& key) const;
+        // Frames [firstFrame, firstFrame + count), decoding only the chunks they fall in; throws
+        // std::out_of_range past the end of the matrix.
+        [[nodiscard]] FeatureMatrix readFrames(const std::string& key, std::size_t firstFrame, std::size_t count) const;
+
+        // Keys in write order.
+        [[nodiscard]] inline const std::vector<std::string>& getKeys() const { return _keys; }
+        [[nodiscard]] inline std::size_t size() const { return _keys.size(); }
+        [[nodiscard]] inline std::size_t getChunkFrames() const { return _chunkFrames; }
+        // Chunks decoded since the reader was opened.
+        [[nodiscard]] inline std::size_t getNumChunksDecoded() const { return _chunksDecoded.load(); }
+
+    private:
+        struct Chunk
+        {
+            std::uint64_t offset = 0;
+            std::uint32_t size = 0;
+            std::uint8_t codec = 0;
+        };
+
+        struct Entry
+        {
+            std::size_t rows = 0;
+            std::size_t cols = 0;
+            std::vector<Chunk> chunks;
+        };
+
+        [[nodiscard]] const Entry& entry(const std::string& key) const;
+
+        utils::MappedFile _file;
+        std::size_t _chunkFrames = 0;
+        std::unordered_map<std::string, Entry> _entries;
+        std::vector<std::string> _keys;
+        mutable std::atomic<std::size_t> _chunksDecoded{0};
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "libvoicefeat/config.h"
+#include "libvoicefeat/utils/mapped_file.h"
+
+namespace libvoicefeat::io
+{
+    // Kaldi binary float matrix as stored in an archive: "<key> \0BFM " followed by the row and column
+    // counts (each a size byte of 4 and a little-endian int32) and rows * cols floats in row-major order.
+
+    // Zero-copy view of one matrix inside a mapped archive; valid while the reader that returned it lives.
+    class MatrixView
+    {
+    public:
+        MatrixView() = default;
+        MatrixView(const unsigned char* bytes, std::size_t rows, std::size_t cols)
+            : _bytes(bytes), _rows(rows), _cols(cols)
+        {
+        }
+
+        [[nodiscard]] inline std::size_t rows() const { return _rows; }
+        [[nodiscard]] inline std::size_t cols() const { return _cols; }
+        [[nodiscard]] inline bool empty() const { return _rows == 0 || _cols == 0; }
+
+        // Points straight into the mapping. Kaldi does not pad its headers, so the data is 4-byte aligned
+        // only when the key length is a multiple of 4; on strict-alignment targets check isAligned() first
+        // or go through at() / copyRow().
+        [[nodiscard]] inline const float* data() const { return reinterpret_cast<const float*>(_bytes); }
+        [[nodiscard]] inline bool isAligned() const
+        {
+            return reinterpret_cast<std::uintptr_t>(_bytes) % alignof(float) == 0;
+        }
+
+        [[nodiscard]] float at(std::size_t row, std::size_t col) const;
+        void copyRow(std::size_t row, float* out) const;
+        [[nodiscard]] FeatureMatrix toMatrix() const;
+
+    private:
+        const unsigned char* _bytes = nullptr;
+        std::size_t _rows = 0;
+        std::size_t _cols = 0;
+    };
+
+    // Appends matrices to a binary ark in a single sequential pass and, if scpPath is given, writes the
+    // matching "<key> <ark>:<offset>" index line for each of them. Keys must be non-empty and contain no
+    // whitespace. The archive is flushed and closed by close() or the destructor.
+    class KaldiArchiveWriter
+    {
+    public:
+        explicit KaldiArchiveWriter(const std::filesystem::path& arkPath, const std::filesystem::path& scpPath = {});
+        ~KaldiArchiveWriter();
+
+        KaldiArchiveWriter(const KaldiArchiveWriter&) = delete;
+        KaldiArchiveWriter& operator=(const KaldiArchiveWriter&) = delete;
+
+        void write(const std::string& key, const FeatureMatrix& matrix);
+        void write(const std::string& key, const float* data, std::size_t rows, std::size_t cols);
+        void close();
+
+        [[nodiscard]] inline std::size_t getNumWritten() const { return _numWritten; }
+
+    private:
+        void writeHeader(const std::string& key, std::size_t rows, std::size_t cols);
+
+        std::string _arkName;
+        std::ofstream _ark;
+        std::ofstream _scp;
+        std::uint64_t _offset = 0;
+        std::size_t _numWritten = 0;
+    };
+
+    // Random access to matrices by key. openArchive() maps one ark and indexes it by walking the headers;
+    // openScp() reads an index and maps each referenced archive once. Lookups never copy matrix data.
+    class KaldiArchiveReader
+    {
+    public:
+        [[nodiscard]] static KaldiArchiveReader openArchive(const std::filesystem::path& arkPath);
+        [[nodiscard]] static KaldiArchiveReader openScp(const std::filesystem::path& scpPath);
+
+        [[nodiscard]] bool contains(const std::string& key) const;
+        // Throws std::out_of_range for an unknown key.
+        [[nodiscard]] MatrixView get(const std::string& key) const;
+
+        // Keys in archive (or scp) order.
+        [[nodiscard]] inline const std::vector<std::string>& getKeys() const { return _keys; }
+        [[nodiscard]] inline std::size_t size() const { return _keys.size(); }
+
+    private:
+        struct Entry
+        {
+            std::size_t archive = 0;
+            std::size_t dataOffset = 0;
+            std::size_t rows = 0;
+            std::size_t cols = 0;
+        };
+
+        KaldiArchiveReader() = default;
+
+        std::size_t mapArchive(const std::filesystem::path& path);
+        void addEntry(const std::string& key, const Entry& entry);
+
+        std::vector<utils::MappedFile> _archives;
+        std::unordered_map<std::string, std::size_t> _archiveIndex;
+        std::unordered_map<std::string, Entry> _entries;
+        std::vector<std::string> _keys;
+    };
+}
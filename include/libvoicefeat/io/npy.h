@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "libvoicefeat/config.h"
+
+namespace libvoicefeat::io
+{
+    // Element type of the written array; both are little-endian ('<f4', '<f2').
+    enum class NpyDType
+    {
+        Float32,
+        Float16
+    };
+
+    // NumPy .npy (format 1.0) holding a C-order rows x cols array. The header is padded to a multiple of
+    // 64 bytes, so the data of a file loaded with np.load(mmap_mode='r') is aligned. A FeatureMatrix must
+    // not be ragged; the float* overloads take contiguous row-major data (e.g. a Kaldi MatrixView) as is.
+    [[nodiscard]] std::vector<unsigned char> serializeNpy(const FeatureMatrix& matrix,
+                                                          NpyDType dtype = NpyDType::Float32);
+    [[nodiscard]] std::vector<unsigned char> serializeNpy(const float* data, std::size_t rows, std::size_t cols,
+                                                          NpyDType dtype = NpyDType::Float32);
+    void writeNpy(const std::filesystem::path& path, const FeatureMatrix& matrix, NpyDType dtype = NpyDType::Float32);
+    void writeNpy(const std::filesystem::path& path, const float* data, std::size_t rows, std::size_t cols,
+                  NpyDType dtype = NpyDType::Float32);
+
+    // Writes a .npy one row at a time without knowing the row count up front: the header reserves room
+    // for any count and close() patches in the final shape. Memory use is independent of the row count,
+    // which is what lets PipelineExtractor's row sink export matrices larger than RAM.
+    class NpyWriter
+    {
+    public:
+        explicit NpyWriter(const std::filesystem::path& path, NpyDType dtype = NpyDType::Float32);
+        ~NpyWriter();
+
+        NpyWriter(const NpyWriter&) = delete;
+        NpyWriter& operator=(const NpyWriter&) = delete;
+
+        // The first row fixes the column count.
+        void appendRow(const FeatureVector& row);
+        void appendRow(const float* row, std::size_t cols);
+        void close();
+
+        [[nodiscard]] inline std::size_t getRows() const { return _rows; }
+
+    private:
+        std::string _name;
+        std::ofstream _out;
+        NpyDType _dtype = NpyDType::Float32;
+        std::size_t _cols = 0;
+        std::size_t _rows = 0;
+        std::size_t _headerBytes = 0;
+        std::vector<std::uint16_t> _halves;
+    };
+
+    // Uncompressed (stored) .npz: a zip with one .npy per add(), readable by np.load(). Each array is
+    // streamed into the archive and its CRC patched in afterwards. No ZIP64, so the archive must stay
+    // below 4 GiB; use NpyWriter for anything larger.
+    class NpzWriter
+    {
+    public:
+        explicit NpzWriter(const std::filesystem::path& path);
+        ~NpzWriter();
+
+        NpzWriter(const NpzWriter&) = delete;
+        NpzWriter& operator=(const NpzWriter&) = delete;
+
+        // name is the key in np.load(...); ".npy" is appended when missing.
+        void add(const std::string& name, const FeatureMatrix& matrix, NpyDType dtype = NpyDType::Float32);
+        void add(const std::string& name, const float* data, std::size_t rows, std::size_t cols,
+                 NpyDType dtype = NpyDType::Float32);
+        void close();
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            std::uint32_t crc = 0;
+            std::uint32_t size = 0;
+            std::uint32_t offset = 0;
+        };
+
+        template <typename RowAt>
+        void addEntry(const std::string& name, std::size_t rows, std::size_t cols, NpyDType dtype, RowAt rowAt);
+
+        std::string _name;
+        std::ofstream _out;
+        std::vector<Entry> _entries;
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "libvoicefeat/features/quantization.h"
+
+#include <filesystem>
+
+namespace libvoicefeat::io
+{
+    // Single quantized matrix on disk: a 32-byte header ("LVFQ", version, type, rows, cols), the per-column
+    // scale and offset for the integer types, then the elements as stored in QuantizedMatrix::data.
+    void writeQuantized(const std::filesystem::path& path, const features::QuantizedMatrix& matrix);
+    [[nodiscard]] features::QuantizedMatrix readQuantized(const std::filesystem::path& path);
+
+    // readQuantized(path).dequantize().
+    [[nodiscard]] FeatureMatrix readDequantized(const std::filesystem::path& path);
+}
@@ -2,8 +2,20 @@
 
 #include "libvoicefeat/config.h"
 
+#include "audio/audio_reader.h"
+#include "dsp/fft_transformer.h"
+#include "dsp/window_functiion.h"
 #include "features/feature.h"
+#include "features/quantization.h"
+#include "utils/cancellation.h"
 #include "utils/path.h"
+#include "utils/thread_pool.h"
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 
 namespace libvoicefeat
 {
@@ -12,22 +24,124 @@ namespace libvoicefeat
     using namespace utils;
     using namespace dsp;
 
+    // Runs a task on some other thread. The default executors post to a ThreadPool.
+    using Executor = std::function<void(std::function<void()>)>;
+    // Receives the feature, or a default Feature and the error (OperationCancelled, DeadlineExceeded, ...).
+    using CompletionCallback = std::function<void(Feature feature, std::exception_ptr error)>;
+
+    struct AsyncOptions
+    {
+        CancellationToken cancellation{};       // cancel() from any thread stops the call at its next checkpoint
+        std::optional<Deadline> deadline{};     // checked at the same checkpoints
+        Executor executor{};                    // empty = the extractor's pool, or a shared library pool without one
+    };
+
+    // Configured once and immutable afterwards: the FFT, window, filterbank and DCT tables are built in the
+    // constructor, and extraction is a const operation that keeps all scratch per call. One instance can
+    // be shared by any number of threads.
     class CepstralExtractor
     {
     public:
         explicit CepstralExtractor(const CepstralConfig& config);
+        // Runs frame-parallel compute on a caller-owned pool instead of one sized by config.threading.
+        CepstralExtractor(const CepstralConfig& config, std::shared_ptr<ThreadPool> pool);
+
+        [[nodiscard]] Feature extractFromFile(const std::string& path) const;
+        [[nodiscard]] Feature extractFromAudioBuffer(const AudioBuffer& audio) const;
+        // Encoded WAV or MP3 bytes, decoded in place: same result as writing them to a file and calling
+        // extractFromFile, without the file.
+        [[nodiscard]] Feature extractFromMemory(const void* data, std::size_t size,
+                                                AudioFormat format = AudioFormat::Auto) const;
+        // Rows of extractFromFile(path) for the frames starting in [startSec, endSec). Only the range is decoded,
+        // after a seek, plus the context the resampler filter, pre-emphasis and delta window need, so rows
+        // are identical to the full-file ones, or within float rounding of the sinc filter when resampling.
+        // PNCC's trackers remember the whole signal, so its rows are close but not identical. The voice activity
+        // gate's speech frames are counted from the start of the range; VadMode::Drop is rejected.
+        [[nodiscard]] Feature extractRange(const std::string& path, double startSec, double endSec) const;
+        // extractFromFile() stored as float16 or per-column int8/int16 (see quantization.h): 2x or 4x smaller
+        // than float32, dequantized with QuantizedMatrix::dequantize() or io::readDequantized().
+        [[nodiscard]] QuantizedMatrix extractQuantized(const std::string& path, QuantizationType type) const;
+
+        // One feature per channel, without downmixing. Channels run concurrently on the extractor's pool
+        // (config.threading) and share its tables.
+        [[nodiscard]] std::vector<Feature> extractChannelsFromFile(const std::string& path) const;
+        [[nodiscard]] std::vector<Feature> extractFromMultichannelBuffer(const MultichannelAudioBuffer& audio) const;
 
-        [[nodiscard]] Feature extractFromFile(const std::string& path);
-        [[nodiscard]] Feature extractFromAudioBuffer(const AudioBuffer& audio);
+        // Non-blocking extraction on options.executor, with the same result as the blocking calls. Cancellation
+        // and the deadline are checked between blocks of every stage (64k input samples for decoding,
+        // resampling, pre-emphasis and framing, 64 frames for features), so stopped work frees its thread
+        // within milliseconds. Jobs run on the extractor's pool share it with their own frame blocks, but a
+        // job waiting on its blocks never runs another job inline (see ThreadPool::parallelFor). The
+        // extractor must outlive its pending calls.
+        [[nodiscard]] std::future<Feature> extractAsync(const std::string& path, AsyncOptions options = {}) const;
+        [[nodiscard]] std::future<Feature> extractAsync(AudioBuffer audio, AsyncOptions options = {}) const;
+        void extractAsync(const std::string& path, AsyncOptions options, CompletionCallback onComplete) const;
+        void extractAsync(AudioBuffer audio, AsyncOptions options, CompletionCallback onComplete) const;
+
+        // Resampled, pre-emphasized, framed and windowed input, ready for the transformer. Always resamples,
+        // also in native-rate mode.
+        [[nodiscard]] std::vector<Frame> extractFrames(const AudioBuffer& audio) const;
+
+        // Native-rate mode (config.resampling.nativeRate): frames, window, FFT and the pre-emphasis delay are
+        // scaled by inputRate / sampleRate and the filterbank is built at the input rate over the same
+        // frequency range. nativeFraming() is empty unless the mode applies to inputSampleRate, i.e. it is on
+        // and the input is above sampleRate. Extractors built on this one use these to follow the same path.
+        struct NativeFraming
+        {
+            int sampleRate = 0;                 // the input rate, at which frames are cut
+            int frameSize  = 0;
+            int frameStep  = 0;
+            double scale   = 1.0;               // inputRate / sampleRate, also the pre-emphasis delay
+        };
+        [[nodiscard]] std::optional<NativeFraming> nativeFraming(int inputSampleRate) const;
+        // Pre-emphasized, framed and windowed input at the input rate, ready for FFTTransformer(frameSize).
+        [[nodiscard]] std::vector<Frame> extractNativeFrames(const AudioBuffer& audio,
+                                                             const NativeFraming& framing) const;
+        // feature's plan rebuilt at the input rate for an nFft-point transform, with band gains and the energy
+        // scale that keep it comparable to the configured rate. A feature without a plan is planned at the
+        // configured FFT size first.
+        [[nodiscard]] std::shared_ptr<const FeaturePlan> makeNativePlan(const Feature& feature,
+                                                                        const NativeFraming& framing, int nFft) const;
+
+        [[nodiscard]] inline const FFTTransformer& getTransformer() const { return _transformer; }
+        [[nodiscard]] inline const std::shared_ptr<ThreadPool>& getThreadPool() const { return _pool; }
+
+        [[nodiscard]] inline const CepstralConfig& getConfig() const { return _config; }
 
     private:
-        [[nodiscard]] static AudioBuffer loadAudio(const std::filesystem::path& path);
-        static void applyPreEmphasis(std::vector<float>& samples, float coeff);
-        void buildOptions(int sampleRate);
+        // Empty in blocking calls; in async calls it throws once the call is cancelled or past its deadline.
+        using Checkpoint = std::function<void()>;
+
+        [[nodiscard]] Feature extract(const AudioBuffer& audio, const Checkpoint& checkpoint) const;
+        [[nodiscard]] std::vector<Frame> extractFrames(const AudioBuffer& audio, const Checkpoint& checkpoint) const;
+        [[nodiscard]] static AudioBuffer copyAudio(const AudioBuffer& audio, const Checkpoint& checkpoint);
+        // Resampling to the configured rate in blocks of input, checked between blocks; blocking and async
+        // calls take the same path, so they produce the same samples, which match the one-shot
+        // Resampler::resampleTo up to float rounding inside the sinc filter.
+        [[nodiscard]] AudioBuffer resampleAudio(const AudioBuffer& audio, const Checkpoint& checkpoint) const;
+        [[nodiscard]] static std::vector<Frame> frameSignal(const AudioBuffer& audio, int frameSize, int frameStep,
+                                                            const WindowFunction& window, const Checkpoint& checkpoint);
+        void computeFeature(Feature& feature, const std::vector<Frame>& frames, const FFTTransformer& transformer,
+                            const Checkpoint& checkpoint) const;
+        void runAsync(AsyncOptions options, CompletionCallback onComplete,
+                      std::function<Feature(const Checkpoint&)> work) const;
+
+        [[nodiscard]] static AudioBuffer loadAudio(const std::filesystem::path& path, const Checkpoint& checkpoint = {});
+        static void applyPreEmphasis(std::vector<float>& samples, float coeff, const Checkpoint& checkpoint = {});
+        // Pre-emphasis with the previous sample of the configured rate, delay input samples back.
+        static void applyPreEmphasis(std::vector<float>& samples, float coeff, double delay,
+                                     const Checkpoint& checkpoint = {});
 
-        // TODO: void resampleTo();
+        [[nodiscard]] Feature extractAtNativeRate(const AudioBuffer& audio, const NativeFraming& framing,
+                                                  const Checkpoint& checkpoint) const;
+        [[nodiscard]] std::vector<Frame> extractNativeFrames(const AudioBuffer& audio, const NativeFraming& framing,
+                                                             const WindowFunction& window,
+                                                             const Checkpoint& checkpoint) const;
 
         CepstralConfig _config{};
-        FeatureOptions _options{};
+        std::shared_ptr<ThreadPool> _pool{};
+        FFTTransformer _transformer;
+        WindowFunction _window;
+        Feature _prototype{};                           // configured feature carrying the shared plan
     };
 }
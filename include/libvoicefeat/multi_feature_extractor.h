@@ -0,0 +1,45 @@
+#pragma once
+
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libvoicefeat
+{
+    // Extracts several cepstral types in one pass. Resampling, pre-emphasis, framing, windowing and the
+    // FFT run once per frame; the magnitude spectrum is then fanned out to each type's filterbank,
+    // compression and DCT head. Heads whose plans prune the spectrum the same way share one pruned
+    // transform over the union of their bins, as long as the cost model still picks that method for the
+    // union; other heads get a transform of their own. Native-rate input (config.resampling.nativeRate)
+    // takes CepstralExtractor's native path, with every head planned at the input rate. Every matrix is
+    // bitwise identical to a separate CepstralExtractor run with config.type set to that type. The results are keyed by type, so each
+    // type may be requested once; duplicates throw std::invalid_argument.
+    class MultiFeatureExtractor
+    {
+    public:
+        MultiFeatureExtractor(const CepstralConfig& config, const std::vector<CepstralType>& types);
+        MultiFeatureExtractor(const CepstralConfig& config, const std::vector<CepstralType>& types,
+                              std::shared_ptr<ThreadPool> pool);
+
+        [[nodiscard]] std::map<CepstralType, Feature> extractFromFile(const std::string& path) const;
+        [[nodiscard]] std::map<CepstralType, Feature> extractFromAudioBuffer(const AudioBuffer& audio) const;
+
+    private:
+        // Heads fed by one spectrum: the full FFT (pruned unset) or one pruned method over their bins.
+        struct SpectrumGroup
+        {
+            std::shared_ptr<const dsp::PrunedTransformer> pruned{};
+            std::size_t binBegin = 0, binEnd = 0;
+            std::vector<std::size_t> heads{};
+        };
+
+        [[nodiscard]] static std::vector<SpectrumGroup> groupSpectra(const std::vector<Feature>& heads);
+
+        CepstralExtractor _frontEnd;                    // shared preprocessing, transformer and pool
+        std::vector<Feature> _heads{};                  // one planned prototype per requested type
+        std::vector<SpectrumGroup> _spectra{};
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libvoicefeat
+{
+    // Only the extract stage takes a thread count. Decoding reads one stream in order, and the resample
+    // stage carries the resampler's filter history, the pre-emphasis sample and the framer's overlap from
+    // one block to the next, so a second thread in either would have to wait for the first block's state.
+    struct PipelineOptions
+    {
+        std::size_t decodeBlockFrames = 16384;  // decoded audio frames per block sent to the resample stage
+        std::size_t framesPerBlock    = 256;    // analysis frames per block sent to the extract stage
+        std::size_t queueCapacity     = 8;      // blocks buffered between two neighbouring stages
+        int extractThreads            = 1;      // threads computing feature rows
+    };
+
+    struct StageStats
+    {
+        std::size_t blocks        = 0;          // blocks the stage produced
+        std::size_t items         = 0;          // samples (decode / resample) or frames (extract) produced
+        double busySeconds        = 0.0;        // time spent working, queue waits excluded (summed over threads)
+        std::size_t maxQueueDepth = 0;          // deepest input queue seen by the stage (0 for decode)
+        double meanQueueDepth     = 0.0;        // input queue depth averaged over pushes
+
+        [[nodiscard]] double throughput() const { return busySeconds > 0.0 ? items / busySeconds : 0.0; }
+    };
+
+    struct PipelineStats
+    {
+        StageStats decode{};
+        StageStats resample{};                  // includes pre-emphasis, framing and windowing
+        StageStats extract{};
+        double wallSeconds = 0.0;
+    };
+
+    // Runs decode, resample and feature extraction as concurrent stages connected by bounded block queues,
+    // so DSP overlaps with I/O and MP3 decoding and no stage keeps a full copy of the audio. Decoding and
+    // resampling walk the signal in order and run on one thread each; extraction scales with
+    // extractThreads. Native-rate input (config.resampling.nativeRate) skips the resampler and is framed
+    // and planned at the input rate, as CepstralExtractor does it. Output equals CepstralExtractor up to
+    // the block-wise resampler's float rounding, and is bitwise identical when no resampling is needed.
+    class PipelineExtractor
+    {
+    public:
+        explicit PipelineExtractor(const CepstralConfig& config, const PipelineOptions& options = {});
+
+        [[nodiscard]] Feature extractFromFile(const std::string& path);
+
+        // Streams finished rows, deltas included, to sink in frame order instead of collecting them, so the
+        // output never has to fit in memory (e.g. straight into an io::NpyWriter). The sink runs on one
+        // of the extract threads, one call at a time; exceptions it throws abort the run. Returns the
+        // number of rows delivered. Rows equal those of extractFromFile(); with VadMode::Drop only speech
+        // rows are delivered.
+        using RowSink = std::function<void(const FeatureVector& row)>;
+        std::size_t extractFromFile(const std::string& path, const RowSink& sink);
+
+        // Statistics of the last extractFromFile call.
+        [[nodiscard]] const PipelineStats& getStats() const { return _stats; }
+
+    private:
+        // Runs the stages over the file; onBlock receives every extracted block with its voice activity
+        // mask, serialized but in completion order.
+        using BlockSink = std::function<void(std::size_t firstFrame, FeatureMatrix rows, std::vector<bool> voiced)>;
+        void run(const std::string& path, Feature& feature, const BlockSink& onBlock);
+
+        CepstralConfig _config{};
+        CepstralExtractor _frontEnd;                    // native-rate framing and plans; its pool is unused
+        PipelineOptions _options{};
+        PipelineStats _stats{};
+    };
+}
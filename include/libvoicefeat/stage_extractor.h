@@ -0,0 +1,43 @@
+#pragma once
+
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <memory>
+#include <string>
+
+namespace libvoicefeat
+{
+    // Matrices of one StageExtractor pass, one row per frame (per speech frame in VadMode::Drop); those not
+    // selected are empty.
+    struct StageMatrices
+    {
+        FeatureMatrix powerSpectrum{};                  // nFft / 2 + 1 columns
+        FeatureMatrix filterbankEnergies{};             // one column per filter
+        FeatureMatrix compressedEnergies{};             // one column per filter
+        Feature cepstra{};                              // what CepstralExtractor returns for the same config
+    };
+
+    // Several stages of one feature from a single pass: framing and the FFT run once per frame, and each
+    // frame goes only as far as the last selected stage, so a log-mel request never reaches the DCT.
+    // Cepstra are bitwise identical to CepstralExtractor unless the power spectrum is selected together with
+    // a band-limited filterbank, which then reads the full FFT instead of the pruned one. Compressed PNCC
+    // energies come out of the same cross-frame power normalization as its cepstra; the voice activity gate
+    // applies to every matrix. Native-rate input (config.resampling.nativeRate) is framed and planned at the
+    // input rate, so the power spectrum then has the larger FFT's nFft / 2 + 1 columns.
+    class StageExtractor
+    {
+    public:
+        StageExtractor(const CepstralConfig& config, const StageSelection& stages);
+        StageExtractor(const CepstralConfig& config, const StageSelection& stages, std::shared_ptr<ThreadPool> pool);
+
+        [[nodiscard]] StageMatrices extractFromFile(const std::string& path) const;
+        [[nodiscard]] StageMatrices extractFromAudioBuffer(const AudioBuffer& audio) const;
+
+        [[nodiscard]] inline const StageSelection& getStages() const { return _stages; }
+
+    private:
+        CepstralExtractor _frontEnd;                    // shared preprocessing, transformer and pool
+        StageSelection _stages{};
+        Feature _prototype{};                           // planned feature for config.type
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace libvoicefeat::utils
+{
+    // Blocking FIFO with a fixed capacity, used to connect pipeline stages. close() wakes every waiter:
+    // producers stop (push returns false) and consumers drain what is left before pop returns nullopt.
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue(std::size_t capacity)
+            : _capacity(std::max<std::size_t>(1, capacity))
+        {
+        }
+
+        bool push(T item)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notFull.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+            if (_closed)
+                return false;
+
+            _items.push_back(std::move(item));
+            _maxDepth = std::max(_maxDepth, _items.size());
+            _depthSum += _items.size();
+            ++_pushes;
+
+            lock.unlock();
+            _notEmpty.notify_one();
+            return true;
+        }
+
+        [[nodiscard]] std::optional<T> pop()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this]() { return _closed || !_items.empty(); });
+            if (_items.empty())
+                return std::nullopt;
+
+            T item = std::move(_items.front());
+            _items.pop_front();
+
+            lock.unlock();
+            _notFull.notify_one();
+            return item;
+        }
+
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+            }
+            _notFull.notify_all();
+            _notEmpty.notify_all();
+        }
+
+        [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+        [[nodiscard]] std::size_t maxDepth() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _maxDepth;
+        }
+
+        // Average number of queued items seen right after each push.
+        [[nodiscard]] double meanDepth() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _pushes == 0 ? 0.0 : static_cast<double>(_depthSum) / static_cast<double>(_pushes);
+        }
+
+    private:
+        std::size_t _capacity = 1;
+        std::deque<T> _items;
+        mutable std::mutex _mutex;
+        std::condition_variable _notFull;
+        std::condition_variable _notEmpty;
+        bool _closed = false;
+
+        std::size_t _maxDepth = 0;
+        std::size_t _depthSum = 0;
+        std::size_t _pushes = 0;
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace libvoicefeat::utils
+{
+    // Thrown from a cancellation checkpoint once its token has been cancelled.
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled() : std::runtime_error("Operation cancelled") {}
+    };
+
+    // Thrown from a cancellation checkpoint once its deadline has passed.
+    class DeadlineExceeded : public std::runtime_error
+    {
+    public:
+        DeadlineExceeded() : std::runtime_error("Deadline exceeded") {}
+    };
+
+    // Copyable handle to a shared flag: every copy observes cancel() on any of them. A default-constructed
+    // token has its own flag, so it is never cancelled unless cancel() is called on it or a copy.
+    class CancellationToken
+    {
+    public:
+        CancellationToken() : _cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() const { _cancelled->store(true, std::memory_order_relaxed); }
+        [[nodiscard]] bool isCancelled() const { return _cancelled->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> _cancelled;
+    };
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    // Throws OperationCancelled / DeadlineExceeded when the token is cancelled or the deadline has passed.
+    inline void throwIfStopped(const CancellationToken& token, const std::optional<Deadline>& deadline)
+    {
+        if (token.isCancelled())
+            throw OperationCancelled();
+        if (deadline && std::chrono::steady_clock::now() >= *deadline)
+            throw DeadlineExceeded();
+    }
+}
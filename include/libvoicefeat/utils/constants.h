@@ -21,6 +21,6 @@ namespace libvoicefeat::constants
     constexpr int DEFAULT_MFCC_MIN_FREQ = 0.0f;
     constexpr int DEFAULT_GFCC_MIN_FREQ = 50.0f;
     constexpr int DEFAULT_LFCC_MIN_FREQ = 0.0f;
-    constexpr int DEFAULT_PNCC_MIN_FREQ = 20.0f;
+    constexpr int DEFAULT_PNCC_MIN_FREQ = 200.0f;
     constexpr int DEFAULT_PLP_MIN_FREQ  = 0.0f;
 }
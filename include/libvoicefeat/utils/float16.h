@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace libvoicefeat::utils
+{
+    // IEEE 754 binary16 conversions, round-to-nearest-even. Values past the half range become infinity,
+    // NaN stays NaN.
+    inline std::uint16_t floatToHalf(float value)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+        const std::uint32_t magnitude = bits & 0x7fffffffu;
+
+        if (magnitude >= 0x7f800000u)
+            return static_cast<std::uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u : 0u));
+        // 65520 and above round past the largest half (65504)
+        if (magnitude >= 0x477ff000u)
+            return static_cast<std::uint16_t>(sign | 0x7c00u);
+
+        if (magnitude < 0x38800000u)
+        {
+            // below 2^-14 the half is subnormal: the value in units of 2^-24, rounded; scaling is exact
+            float absValue = 0.0f;
+            std::memcpy(&absValue, &magnitude, sizeof(absValue));
+            return static_cast<std::uint16_t>(sign | static_cast<std::uint16_t>(std::nearbyint(absValue * 16777216.0f)));
+        }
+
+        const std::uint32_t exponent = (magnitude >> 23) - 127u + 15u;
+        const std::uint32_t mantissa = magnitude & 0x7fffffu;
+        std::uint32_t half = (exponent << 10) | (mantissa >> 13);
+
+        // a carry out of the mantissa correctly bumps the exponent
+        const std::uint32_t rest = mantissa & 0x1fffu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+            ++half;
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    inline float halfToFloat(std::uint16_t half)
+    {
+        const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+        const std::uint32_t exponent = (half >> 10) & 0x1fu;
+        const std::uint32_t mantissa = half & 0x3ffu;
+
+        std::uint32_t bits = 0;
+        if (exponent == 0x1fu)
+        {
+            bits = sign | 0x7f800000u | (mantissa << 13);
+        }
+        else if (exponent == 0)
+        {
+            const float magnitude = static_cast<float>(mantissa) / 16777216.0f;
+            std::memcpy(&bits, &magnitude, sizeof(bits));
+            bits |= sign;
+        }
+        else
+        {
+            bits = sign | ((exponent - 15u + 127u) << 23) | (mantissa << 13);
+        }
+
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace libvoicefeat::utils
+{
+    // Streaming XXH64: four independent 64-bit lanes over 32-byte stripes, several GB/s, so hashing a file
+    // costs far less than decoding it. Values are stable across runs and platforms of the same endianness.
+    class Hasher
+    {
+    public:
+        explicit Hasher(std::uint64_t seed = 0);
+
+        void update(const void* data, std::size_t size);
+
+        // Trivially copyable values are hashed by their bytes; strings by length and contents.
+        template <typename T>
+        std::enable_if_t<std::is_trivially_copyable_v<T>> add(const T& value)
+        {
+            update(&value, sizeof(value));
+        }
+        void add(const std::string& value);
+
+        [[nodiscard]] std::uint64_t digest() const;
+
+    private:
+        std::uint64_t _seed = 0;
+        std::uint64_t _lanes[4]{};
+        unsigned char _stripe[32]{};
+        std::size_t _stripeSize = 0;
+        std::uint64_t _total = 0;
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace libvoicefeat::utils
+{
+    // Read-only view of a whole file. On POSIX the file is memory-mapped so pages are only read when they
+    // are touched; elsewhere the contents are loaded into memory once. Move-only, unmapped on destruction.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] inline const unsigned char* data() const { return _data; }
+        [[nodiscard]] inline std::size_t size() const { return _size; }
+        [[nodiscard]] inline bool empty() const { return _size == 0; }
+
+    private:
+        void release() noexcept;
+
+        const unsigned char* _data = nullptr;
+        std::size_t _size = 0;
+        bool _mapped = false;
+        std::vector<unsigned char> _fallback;
+    };
+}
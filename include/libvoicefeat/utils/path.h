@@ -6,6 +6,31 @@
 
 namespace libvoicefeat::utils {
 
+    enum class PathResolution
+    {
+        Literal,            // the path as given; relative paths are opened against the working directory
+        BaseDirectory,      // relative paths are joined to PathResolutionPolicy::baseDirectory
+        SearchFromCallsite  // resolve_from_callsite(), with the matching ancestor cached per call site
+    };
+
+    struct PathResolutionPolicy
+    {
+        PathResolution mode = PathResolution::SearchFromCallsite;
+        std::filesystem::path baseDirectory{};                      // for BaseDirectory
+    };
+
+    // Process-wide policy used by the audio readers, the batch extractor and the feature cache. Literal and
+    // BaseDirectory do no filesystem calls at all, so opening the file is the only syscall per path.
+    void set_path_resolution(const PathResolutionPolicy& policy);
+    [[nodiscard]] PathResolutionPolicy get_path_resolution();
+
+    // Resolves p under the current policy. In SearchFromCallsite mode the ancestor directory that matched is
+    // remembered per call-site directory and parent of p, and checked with a single exists() on later
+    // calls; a miss falls back to the full walk.
+    [[nodiscard]] std::filesystem::path resolve_path(
+        const std::filesystem::path& p,
+        libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current());
+
     inline std::filesystem::path resolve_from_callsite(
         const std::filesystem::path& p,
         libvoicefeat::compat::source_location loc = libvoicefeat::compat::source_location::current())
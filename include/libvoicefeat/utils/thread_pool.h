@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace libvoicefeat::utils
+{
+    // Work-stealing pool: each worker owns a deque it pushes to and pops from at the back, idle workers
+    // steal from the front of other deques. Tasks submitted from outside the pool go to a shared queue.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t numThreads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] std::size_t size() const { return _workers.size(); }
+
+        template <typename F>
+        [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& task);
+
+        // Splits [begin, end) into contiguous blocks and runs body(blockBegin, blockEnd) for each of them.
+        // The calling thread runs blocks of this call alongside the workers, never other queued tasks, and
+        // returns once all blocks are done; the first exception thrown by a block is rethrown here.
+        void parallelFor(std::size_t begin, std::size_t end,
+                         const std::function<void(std::size_t, std::size_t)>& body,
+                         std::size_t grain = 0);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void enqueue(std::function<void()> task);
+        [[nodiscard]] bool popTask(std::function<void()>& task);
+        bool runPendingTask();
+        void workerLoop(std::size_t index);
+
+        std::vector<std::thread> _workers;
+        std::vector<std::unique_ptr<WorkQueue>> _queues;
+        WorkQueue _injected;
+        std::atomic<std::size_t> _pending{0};
+        std::mutex _sleepMutex;
+        std::condition_variable _cv;
+        bool _stopping{false};
+    };
+
+    template <typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::submit(F&& task)
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        auto future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+}
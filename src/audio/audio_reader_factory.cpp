@@ -0,0 +1,60 @@
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include "libvoicefeat/audio/mp3_audio_reader.h"
+#include "libvoicefeat/audio/wav_audio_reader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace libvoicefeat::audio
+{
+    std::unique_ptr<IAudioReader> createAudioReader(const std::filesystem::path& path)
+    {
+        const auto extStr = path.extension().string();
+        std::string ext;
+        ext.resize(extStr.size());
+        std::transform(extStr.begin(), extStr.end(), ext.begin(), [](unsigned char c)
+        {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        if (ext == ".wav")
+            return std::make_unique<WavAudioReader>();
+        if (ext == ".mp3")
+            return std::make_unique<Mp3AudioReader>();
+
+        throw std::invalid_argument("Unsupported audio format: " + path.string());
+    }
+
+    std::unique_ptr<IAudioReader> createAudioReader(AudioFormat format)
+    {
+        switch (format)
+        {
+        case AudioFormat::Wav:
+            return std::make_unique<WavAudioReader>();
+        case AudioFormat::Mp3:
+            return std::make_unique<Mp3AudioReader>();
+        case AudioFormat::Auto:
+            break;
+        }
+        throw std::invalid_argument("createAudioReader needs a concrete format; use detectAudioFormat first");
+    }
+
+    AudioFormat detectAudioFormat(const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        if (bytes != nullptr && size >= 12 && std::memcmp(bytes, "RIFF", 4) == 0 && std::memcmp(bytes + 8, "WAVE", 4) == 0)
+            return AudioFormat::Wav;
+        if (bytes != nullptr && size >= 3 && std::memcmp(bytes, "ID3", 3) == 0)
+            return AudioFormat::Mp3;
+        // MPEG audio frame header: 11 sync bits, then a valid version (not 01) and layer (not 00)
+        if (bytes != nullptr && size >= 2 && bytes[0] == 0xFF && (bytes[1] & 0xE0) == 0xE0 &&
+            (bytes[1] & 0x18) != 0x08 && (bytes[1] & 0x06) != 0x00)
+            return AudioFormat::Mp3;
+
+        throw std::invalid_argument("Unrecognized audio data: neither RIFF/WAVE nor MP3");
+    }
+}
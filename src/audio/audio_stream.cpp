@@ -0,0 +1,90 @@
+#include "libvoicefeat/audio/audio_stream.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace libvoicefeat::audio
+{
+    namespace
+    {
+        constexpr std::size_t kReadBlockFrames = 1 << 16;
+    }
+
+    AudioBuffer readAllMono(IAudioStream& stream, const std::function<void()>& beforeBlock)
+    {
+        AudioBuffer buf;
+        buf.sampleRate = stream.sampleRate();
+        buf.samples.reserve(stream.totalFrames());
+
+        const int channels = stream.channels();
+        std::vector<float> block(kReadBlockFrames * channels);
+        while (true)
+        {
+            if (beforeBlock)
+                beforeBlock();
+
+            const std::size_t frames = stream.read(block.data(), kReadBlockFrames);
+            if (frames == 0)
+                break;
+
+            const std::size_t offset = buf.samples.size();
+            buf.samples.resize(offset + frames);
+            downmixToMono(block.data(), frames, channels, buf.samples.data() + offset);
+        }
+
+        return buf;
+    }
+
+    MultichannelAudioBuffer readAllPlanar(IAudioStream& stream)
+    {
+        const int channels = stream.channels();
+
+        MultichannelAudioBuffer buf;
+        buf.sampleRate = stream.sampleRate();
+        buf.channels.resize(static_cast<std::size_t>(channels));
+        for (auto& channel : buf.channels)
+            channel.reserve(stream.totalFrames());
+
+        std::vector<float> block(kReadBlockFrames * channels);
+        while (true)
+        {
+            const std::size_t frames = stream.read(block.data(), kReadBlockFrames);
+            if (frames == 0)
+                break;
+
+            for (int c = 0; c < channels; ++c)
+            {
+                auto& channel = buf.channels[static_cast<std::size_t>(c)];
+                const std::size_t offset = channel.size();
+                channel.resize(offset + frames);
+                for (std::size_t i = 0; i < frames; ++i)
+                    channel[offset + i] = block[i * channels + c];
+            }
+        }
+
+        return buf;
+    }
+
+    AudioBuffer readMono(IAudioStream& stream, std::size_t maxFrames)
+    {
+        AudioBuffer buf;
+        buf.sampleRate = stream.sampleRate();
+        buf.samples.resize(maxFrames);
+
+        const int channels = stream.channels();
+        std::vector<float> block(std::min(maxFrames, kReadBlockFrames) * channels);
+        std::size_t done = 0;
+        while (done < maxFrames)
+        {
+            const std::size_t frames = stream.read(block.data(), std::min(maxFrames - done, kReadBlockFrames));
+            if (frames == 0)
+                break;
+
+            downmixToMono(block.data(), frames, channels, buf.samples.data() + done);
+            done += frames;
+        }
+
+        buf.samples.resize(done);
+        return buf;
+    }
+}
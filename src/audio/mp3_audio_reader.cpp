@@ -3,55 +3,126 @@
 #include <filesystem>
 
 #include "minimp3_ex.h"
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 #include "libvoicefeat/utils/path.h"
 
 using libvoicefeat::compat::source_location;
-using libvoicefeat::utils::resolve_from_callsite;
+using libvoicefeat::utils::resolve_path;
 
 namespace libvoicefeat::audio
 {
-    AudioBuffer Mp3AudioReader::load(const std::filesystem::path& inputFile, source_location loc)
+    namespace
     {
-        const auto resolvedPath = resolve_from_callsite(inputFile, loc);
-        const std::string path = resolvedPath.string();
+        class Mp3AudioStream : public IAudioStream
+        {
+        public:
+            explicit Mp3AudioStream(const std::string& path)
+            {
+                if (path.empty())
+                    throw std::invalid_argument("path is empty");
 
-        if (path.empty())
-            throw std::invalid_argument("path is empty");
+                if (mp3dec_ex_open(&_dec, path.c_str(), MP3D_SEEK_TO_SAMPLE) != 0)
+                {
+                    throw std::runtime_error("Cannot open mp3: " + path);
+                }
+                checkChannels(path);
+            }
 
-        mp3dec_ex_t dec{};
-        if (mp3dec_ex_open(&dec, path.c_str(), MP3D_SEEK_TO_SAMPLE) != 0)
-        {
-            throw std::runtime_error("Cannot open mp3: " + path);
-        }
+            // minimp3 decodes the buffer in place; it must outlive the stream.
+            Mp3AudioStream(const unsigned char* data, std::size_t size)
+            {
+                if (data == nullptr || size == 0)
+                    throw std::invalid_argument("mp3 buffer is empty");
 
-        std::vector<short> pcm16(dec.samples);
-        size_t samplesRead = mp3dec_ex_read(&dec, pcm16.data(), dec.samples);
-        if (samplesRead == 0)
-        {
-            mp3dec_ex_close(&dec);
-            throw std::runtime_error("Empty mp3: " + path);
-        }
+                if (mp3dec_ex_open_buf(&_dec, data, size, MP3D_SEEK_TO_SAMPLE) != 0)
+                {
+                    throw std::runtime_error("Cannot decode mp3 from memory buffer");
+                }
+                checkChannels("memory buffer");
+            }
 
-        AudioBuffer buf;
-        buf.sampleRate = dec.info.hz;
-        int channels = dec.info.channels;
+            ~Mp3AudioStream() override
+            {
+                mp3dec_ex_close(&_dec);
+            }
 
-        buf.samples.reserve(samplesRead / channels);
+            Mp3AudioStream(const Mp3AudioStream&) = delete;
+            Mp3AudioStream& operator=(const Mp3AudioStream&) = delete;
 
-        for (size_t i = 0; i < samplesRead; i += channels)
-        {
-            float mono = 0.f;
-            for (int c = 0; c < channels; ++c)
+            [[nodiscard]] int sampleRate() const override { return _dec.info.hz; }
+            [[nodiscard]] int channels() const override { return _dec.info.channels; }
+            [[nodiscard]] std::size_t totalFrames() const override
             {
-                mono += pcm16[i + c] / 32768.f;
+                return static_cast<std::size_t>(_dec.samples) / static_cast<std::size_t>(_dec.info.channels);
+            }
+
+            std::size_t read(float* out, std::size_t maxFrames) override
+            {
+                const std::size_t channels = static_cast<std::size_t>(_dec.info.channels);
+                _pcm16.resize(maxFrames * channels);
+
+                const size_t samplesRead = mp3dec_ex_read(&_dec, _pcm16.data(), _pcm16.size());
+                for (size_t i = 0; i < samplesRead; ++i)
+                {
+                    out[i] = _pcm16[i] / 32768.f;
+                }
+                return samplesRead / channels;
             }
-            mono /= channels;
-            buf.samples.push_back(mono);
-        }
 
-        mp3dec_ex_close(&dec);
+            void seek(std::size_t frame) override
+            {
+                // sample accurate thanks to MP3D_SEEK_TO_SAMPLE; the position counts interleaved samples
+                frame = std::min(frame, totalFrames());
+                if (mp3dec_ex_seek(&_dec, static_cast<uint64_t>(frame) * static_cast<uint64_t>(_dec.info.channels)) != 0)
+                    throw std::runtime_error("mp3 seek failed");
+            }
+
+        private:
+            void checkChannels(const std::string& name)
+            {
+                if (_dec.info.channels <= 0)
+                {
+                    mp3dec_ex_close(&_dec);
+                    throw std::runtime_error("Invalid channel count in mp3: " + name);
+                }
+            }
+
+            mp3dec_ex_t _dec{};
+            std::vector<short> _pcm16;
+        };
+    }
+
+    AudioBuffer Mp3AudioReader::load(const std::filesystem::path& inputFile, source_location loc)
+    {
+        auto stream = open(inputFile, loc);
+        auto buf = readAllMono(*stream);
+        if (buf.samples.empty())
+            throw std::runtime_error("Empty mp3: " + resolve_path(inputFile, loc).string());
+
+        return buf;
+    }
+
+    std::unique_ptr<IAudioStream> Mp3AudioReader::open(const std::filesystem::path& inputFile, source_location loc)
+    {
+        const auto resolvedPath = resolve_path(inputFile, loc);
+        return std::make_unique<Mp3AudioStream>(resolvedPath.string());
+    }
+
+    AudioBuffer Mp3AudioReader::loadMemory(const void* data, std::size_t size)
+    {
+        auto stream = openMemory(data, size);
+        auto buf = readAllMono(*stream);
+        if (buf.samples.empty())
+            throw std::runtime_error("Empty mp3 in memory buffer");
+
         return buf;
     }
+
+    std::unique_ptr<IAudioStream> Mp3AudioReader::openMemory(const void* data, std::size_t size)
+    {
+        return std::make_unique<Mp3AudioStream>(static_cast<const unsigned char*>(data), size);
+    }
 }
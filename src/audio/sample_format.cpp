@@ -0,0 +1,248 @@
+#include "libvoicefeat/audio/sample_format.h"
+#include "libvoicefeat/audio/audio_stream.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBVOICEFEAT_X86_DISPATCH 1
+#define LIBVOICEFEAT_INLINE inline __attribute__((always_inline))
+#else
+#define LIBVOICEFEAT_INLINE inline
+#endif
+
+namespace libvoicefeat::audio
+{
+    namespace
+    {
+        // Samples per block; the inner loops have this fixed trip count, so they lower to straight vector
+        // code in the ISA of the wrapper they are inlined into. Tails run the same statements one by one.
+        constexpr std::size_t kBlock = 16;
+
+        // scaling by a power of two is exact, so these match the plain division by full scale
+        constexpr float kScale8 = 1.0f / 128.0f;
+        constexpr float kScale16 = 1.0f / 32768.0f;
+        constexpr float kScale24 = 1.0f / 8388608.0f;
+        constexpr float kScale32 = 1.0f / 2147483648.0f;
+
+        std::array<float, 256> makeMuLawTable()
+        {
+            std::array<float, 256> table{};
+            for (int code = 0; code < 256; ++code)
+            {
+                const int u = ~code & 0xff;
+                const int exponent = (u >> 4) & 0x07;
+                const int magnitude = ((((u & 0x0f) << 3) + 0x84) << exponent) - 0x84;
+                table[static_cast<std::size_t>(code)] = static_cast<float>((u & 0x80) ? -magnitude : magnitude) * kScale16;
+            }
+            return table;
+        }
+
+        std::array<float, 256> makeALawTable()
+        {
+            std::array<float, 256> table{};
+            for (int code = 0; code < 256; ++code)
+            {
+                const int a = code ^ 0x55;
+                const int exponent = (a >> 4) & 0x07;
+                const int mantissa = a & 0x0f;
+                const int magnitude = exponent == 0 ? (mantissa << 4) + 8 : ((mantissa << 4) + 0x108) << (exponent - 1);
+                table[static_cast<std::size_t>(code)] = static_cast<float>((a & 0x80) ? magnitude : -magnitude) * kScale16;
+            }
+            return table;
+        }
+
+        const std::array<float, 256> kMuLaw = makeMuLawTable();
+        const std::array<float, 256> kALaw = makeALawTable();
+
+        template <SampleFormat F>
+        LIBVOICEFEAT_INLINE float decode(const unsigned char* p)
+        {
+            if constexpr (F == SampleFormat::UInt8)
+            {
+                return static_cast<float>(static_cast<int>(*p) - 128) * kScale8;
+            }
+            else if constexpr (F == SampleFormat::Int16)
+            {
+                std::int16_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return static_cast<float>(v) * kScale16;
+            }
+            else if constexpr (F == SampleFormat::Int24)
+            {
+                // top-aligned in 32 bits, then an arithmetic shift restores the sign
+                const auto bits = static_cast<std::uint32_t>(p[0]) << 8 | static_cast<std::uint32_t>(p[1]) << 16 |
+                                  static_cast<std::uint32_t>(p[2]) << 24;
+                return static_cast<float>(static_cast<std::int32_t>(bits) >> 8) * kScale24;
+            }
+            else if constexpr (F == SampleFormat::Int32)
+            {
+                std::int32_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return static_cast<float>(v) * kScale32;
+            }
+            else if constexpr (F == SampleFormat::Float32)
+            {
+                float v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+            else if constexpr (F == SampleFormat::Float64)
+            {
+                double v;
+                std::memcpy(&v, p, sizeof(v));
+                return static_cast<float>(v);
+            }
+            else if constexpr (F == SampleFormat::MuLaw)
+            {
+                return kMuLaw[*p];
+            }
+            else
+            {
+                return kALaw[*p];
+            }
+        }
+
+        template <SampleFormat F, std::size_t Bytes>
+        LIBVOICEFEAT_INLINE void convertLoop(const unsigned char* raw, std::size_t count, float* out)
+        {
+            std::size_t i = 0;
+            for (; i + kBlock <= count; i += kBlock)
+            {
+                for (std::size_t j = 0; j < kBlock; ++j)
+                    out[i + j] = decode<F>(raw + (i + j) * Bytes);
+            }
+            for (; i < count; ++i)
+                out[i] = decode<F>(raw + i * Bytes);
+        }
+
+        LIBVOICEFEAT_INLINE void convertAny(const unsigned char* raw, std::size_t count, SampleFormat format, float* out)
+        {
+            switch (format)
+            {
+            case SampleFormat::UInt8: convertLoop<SampleFormat::UInt8, 1>(raw, count, out); break;
+            case SampleFormat::Int16: convertLoop<SampleFormat::Int16, 2>(raw, count, out); break;
+            case SampleFormat::Int24: convertLoop<SampleFormat::Int24, 3>(raw, count, out); break;
+            case SampleFormat::Int32: convertLoop<SampleFormat::Int32, 4>(raw, count, out); break;
+            case SampleFormat::Float32: convertLoop<SampleFormat::Float32, 4>(raw, count, out); break;
+            case SampleFormat::Float64: convertLoop<SampleFormat::Float64, 8>(raw, count, out); break;
+            case SampleFormat::MuLaw: convertLoop<SampleFormat::MuLaw, 1>(raw, count, out); break;
+            case SampleFormat::ALaw: convertLoop<SampleFormat::ALaw, 1>(raw, count, out); break;
+            }
+        }
+
+        // Sums the channels of each frame in order from 0.f and divides by the count, like the scalar code.
+        template <int C>
+        LIBVOICEFEAT_INLINE void downmixLoop(const float* interleaved, std::size_t frames, float* mono)
+        {
+            const auto mix = [interleaved](std::size_t frame)
+            {
+                float sum = 0.f;
+                for (int c = 0; c < C; ++c)
+                    sum += interleaved[frame * C + c];
+                return sum / C;
+            };
+
+            std::size_t i = 0;
+            for (; i + kBlock <= frames; i += kBlock)
+            {
+                for (std::size_t j = 0; j < kBlock; ++j)
+                    mono[i + j] = mix(i + j);
+            }
+            for (; i < frames; ++i)
+                mono[i] = mix(i);
+        }
+
+        LIBVOICEFEAT_INLINE void downmixAny(const float* interleaved, std::size_t frames, int channels, float* mono)
+        {
+            switch (channels)
+            {
+            case 1:
+                std::memcpy(mono, interleaved, frames * sizeof(float));
+                return;
+            case 2:
+                downmixLoop<2>(interleaved, frames, mono);
+                return;
+            default:
+                break;
+            }
+
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                float sum = 0.f;
+                for (int c = 0; c < channels; ++c)
+                    sum += interleaved[i * channels + c];
+                mono[i] = sum / channels;
+            }
+        }
+
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        __attribute__((target("avx2")))
+        void convertAvx2(const unsigned char* raw, std::size_t count, SampleFormat format, float* out)
+        {
+            convertAny(raw, count, format, out);
+        }
+
+        __attribute__((target("avx2")))
+        void downmixAvx2(const float* interleaved, std::size_t frames, int channels, float* mono)
+        {
+            downmixAny(interleaved, frames, channels, mono);
+        }
+
+        bool hasAvx2()
+        {
+            static const bool supported = []()
+            {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+            }();
+            return supported;
+        }
+#endif
+    }
+
+    std::size_t bytesPerSample(SampleFormat format)
+    {
+        switch (format)
+        {
+        case SampleFormat::UInt8:
+        case SampleFormat::MuLaw:
+        case SampleFormat::ALaw:
+            return 1;
+        case SampleFormat::Int16: return 2;
+        case SampleFormat::Int24: return 3;
+        case SampleFormat::Int32:
+        case SampleFormat::Float32:
+            return 4;
+        case SampleFormat::Float64: return 8;
+        }
+        throw std::invalid_argument("Unknown sample format");
+    }
+
+    void convertToFloat(const unsigned char* raw, std::size_t count, SampleFormat format, float* out)
+    {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        if (hasAvx2())
+        {
+            convertAvx2(raw, count, format, out);
+            return;
+        }
+#endif
+        convertAny(raw, count, format, out);
+    }
+
+    // declared in audio_stream.h; lives here to share the dispatch
+    void downmixToMono(const float* interleaved, std::size_t frames, int channels, float* mono)
+    {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        if (hasAvx2())
+        {
+            downmixAvx2(interleaved, frames, channels, mono);
+            return;
+        }
+#endif
+        downmixAny(interleaved, frames, channels, mono);
+    }
+}
@@ -2,10 +2,17 @@
 
 #include "stdexcept"
 #include "fstream"
+#include "libvoicefeat/audio/sample_format.h"
 #include "libvoicefeat/utils/path.h"
 
+#include <algorithm>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
 using libvoicefeat::compat::source_location;
-using libvoicefeat::utils::resolve_from_callsite;
+using libvoicefeat::utils::resolve_path;
 
 namespace libvoicefeat::audio
 {
@@ -14,83 +21,248 @@ namespace libvoicefeat::audio
         return id[0] == s[0] && id[1] == s[1] && id[2] == s[2] && id[3] == s[3];
     }
 
-    AudioBuffer WavAudioReader::load(const std::filesystem::path& inputFile, source_location loc)
+    namespace
     {
-        const auto resolvedPath = resolve_from_callsite(inputFile, loc);
-        const std::string path = resolvedPath.string();
+        constexpr uint16_t kFormatPcm = 0x0001;
+        constexpr uint16_t kFormatIeeeFloat = 0x0003;
+        constexpr uint16_t kFormatALaw = 0x0006;
+        constexpr uint16_t kFormatMuLaw = 0x0007;
+        constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+        SampleFormat resolveSampleFormat(uint16_t formatTag, uint16_t bitsPerSample, const std::string& path)
+        {
+            switch (formatTag)
+            {
+            case kFormatPcm:
+                if (bitsPerSample == 8) return SampleFormat::UInt8;
+                if (bitsPerSample == 16) return SampleFormat::Int16;
+                if (bitsPerSample == 24) return SampleFormat::Int24;
+                if (bitsPerSample == 32) return SampleFormat::Int32;
+                break;
+            case kFormatIeeeFloat:
+                if (bitsPerSample == 32) return SampleFormat::Float32;
+                if (bitsPerSample == 64) return SampleFormat::Float64;
+                break;
+            case kFormatALaw:
+                if (bitsPerSample == 8) return SampleFormat::ALaw;
+                break;
+            case kFormatMuLaw:
+                if (bitsPerSample == 8) return SampleFormat::MuLaw;
+                break;
+            default:
+                break;
+            }
+            throw std::runtime_error("Unsupported wav encoding (format " + std::to_string(formatTag) + ", " +
+                                     std::to_string(bitsPerSample) + " bits): " + path);
+        }
 
-        std::ifstream in(path, std::ios::binary);
-        if (!in)
-            throw std::runtime_error("Cannot open wav file: " + path);
+        // Read-only, seekable view of borrowed bytes, so the header parser runs unchanged on memory.
+        class MemoryStreamBuf : public std::streambuf
+        {
+        public:
+            MemoryStreamBuf(const unsigned char* data, std::size_t size)
+            {
+                char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+                setg(begin, begin, begin + size);
+            }
 
-        RiffHeader riff{};
-        in.read(reinterpret_cast<char*>(&riff), sizeof(riff));
-        if (!fourcc_eq(riff.riff, "RIFF") || !fourcc_eq(riff.wave, "WAVE"))
-            throw std::runtime_error("Not a RIFF/WAVE file: " + path);
+        protected:
+            pos_type seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode) override
+            {
+                const off_type base = dir == std::ios::beg ? 0 : dir == std::ios::cur ? gptr() - eback() : egptr() - eback();
+                const off_type target = base + off;
+                if (target < 0 || target > egptr() - eback())
+                    return pos_type(off_type(-1));
 
-        uint16_t numChannels = 0;
-        uint32_t sampleRate = 0;
-        uint16_t bitsPerSample = 0;
+                setg(eback(), eback() + target, egptr());
+                return pos_type(target);
+            }
 
-        std::vector<uint8_t> dataChunk;
+            pos_type seekpos(pos_type pos, std::ios::openmode which) override
+            {
+                return seekoff(off_type(pos), std::ios::beg, which);
+            }
+        };
 
-        while (in)
+        class WavAudioStream : public IAudioStream
         {
-            ChunkHeader ch{};
-            in.read(reinterpret_cast<char*>(&ch), sizeof(ch));
-            if (!in) break;
+        public:
+            explicit WavAudioStream(const std::string& path)
+                : _file(path, std::ios::binary)
+            {
+                if (!_file)
+                    throw std::runtime_error("Cannot open wav file: " + path);
+
+                const uint32_t dataSize = parseHeader(_file, path);
+                _dataOffset = static_cast<std::streamoff>(_file.tellg());
+                _totalFrames = dataSize / _frameBytes;
+                _remainingFrames = _totalFrames;
+            }
 
-            if (fourcc_eq(ch.id, "fmt "))
+            // Samples are converted straight from data, without a copy.
+            WavAudioStream(const unsigned char* data, std::size_t size)
+                : _memory(data)
             {
-                FmtChunk fmt{};
-                in.read(reinterpret_cast<char*>(&fmt), sizeof(FmtChunk));
+                if (data == nullptr && size != 0)
+                    throw std::invalid_argument("data is null");
+
+                MemoryStreamBuf buffer(data, size);
+                std::istream in(&buffer);
+                const uint32_t dataSize = parseHeader(in, "memory buffer");
+                _dataOffset = static_cast<std::streamoff>(in.tellg());
+
+                // a truncated buffer ends at its last whole frame, like a truncated file
+                const std::size_t available = std::min<std::size_t>(dataSize, size - static_cast<std::size_t>(_dataOffset));
+                _totalFrames = available / _frameBytes;
+                _remainingFrames = _totalFrames;
+            }
 
-                numChannels = fmt.numChannels;
-                sampleRate = fmt.sampleRate;
-                bitsPerSample = fmt.bitsPerSample;
+            [[nodiscard]] int sampleRate() const override { return static_cast<int>(_sampleRate); }
+            [[nodiscard]] int channels() const override { return _numChannels; }
+            [[nodiscard]] std::size_t totalFrames() const override { return _totalFrames; }
 
-                uint32_t fmtExtra = ch.size - sizeof(FmtChunk);
-                if (fmtExtra > 0)
+            std::size_t read(float* out, std::size_t maxFrames) override
+            {
+                const std::size_t wanted = std::min(maxFrames, _remainingFrames);
+                if (wanted == 0)
+                    return 0;
+
+                if (_memory)
                 {
-                    in.seekg(fmtExtra, std::ios::cur);
+                    const std::size_t position = _totalFrames - _remainingFrames;
+                    convertToFloat(_memory + _dataOffset + position * _frameBytes, wanted * _numChannels, _format, out);
+                    _remainingFrames -= wanted;
+                    return wanted;
                 }
+
+                _raw.resize(wanted * _frameBytes);
+                _file.read(reinterpret_cast<char*>(_raw.data()), static_cast<std::streamsize>(_raw.size()));
+                const std::size_t frames = static_cast<std::size_t>(_file.gcount()) / _frameBytes;
+                _remainingFrames = frames < wanted ? 0 : _remainingFrames - frames;
+
+                convertToFloat(_raw.data(), frames * _numChannels, _format, out);
+                return frames;
             }
-            else if (fourcc_eq(ch.id, "data"))
+
+            void seek(std::size_t frame) override
             {
-                dataChunk.resize(ch.size);
-                in.read(reinterpret_cast<char*>(dataChunk.data()), ch.size);
-                break;
+                frame = std::min(frame, _totalFrames);
+                _remainingFrames = _totalFrames - frame;
+                if (!_memory)
+                {
+                    _file.clear();
+                    _file.seekg(_dataOffset + static_cast<std::streamoff>(frame * _frameBytes));
+                }
             }
-            else
+
+        private:
+            // Reads the chunks up to the data chunk, leaving in at its first sample; returns the data size.
+            uint32_t parseHeader(std::istream& in, const std::string& path)
             {
-                in.seekg(ch.size, std::ios::cur);
-            }
-        }
+                RiffHeader riff{};
+                in.read(reinterpret_cast<char*>(&riff), sizeof(riff));
+                if (!in || !fourcc_eq(riff.riff, "RIFF") || !fourcc_eq(riff.wave, "WAVE"))
+                    throw std::runtime_error("Not a RIFF/WAVE file: " + path);
 
-        if (dataChunk.empty())
-            throw std::runtime_error("No data chunk in wav: " + path);
+                uint32_t dataSize = 0;
+                bool haveFormat = false;
+                while (in)
+                {
+                    ChunkHeader ch{};
+                    in.read(reinterpret_cast<char*>(&ch), sizeof(ch));
+                    if (!in) break;
 
-        if (bitsPerSample != 16)
-            throw std::runtime_error("Only 16-bit wav supported in this reader");
+                    if (fourcc_eq(ch.id, "fmt "))
+                    {
+                        if (ch.size < sizeof(FmtChunk))
+                            throw std::runtime_error("Truncated fmt chunk in wav: " + path);
 
-        const size_t numSamples = dataChunk.size() / (bitsPerSample / 8) / numChannels;
-        const int16_t* pcm16 = reinterpret_cast<const int16_t*>(dataChunk.data());
+                        FmtChunk fmt{};
+                        in.read(reinterpret_cast<char*>(&fmt), sizeof(FmtChunk));
 
-        AudioBuffer buf;
-        buf.sampleRate = static_cast<int>(sampleRate);
-        buf.samples.reserve(numSamples);
+                        _numChannels = fmt.numChannels;
+                        _sampleRate = fmt.sampleRate;
+                        _bitsPerSample = fmt.bitsPerSample;
+                        _blockAlign = fmt.blockAlign;
+                        _formatTag = fmt.audioFormat;
 
-        for (size_t i = 0; i < numSamples; ++i)
-        {
-            float mono = 0.f;
-            for (int c = 0; c < numChannels; ++c)
-            {
-                mono += pcm16[i * numChannels + c] / 32768.f;
+                        uint32_t fmtExtra = ch.size - sizeof(FmtChunk);
+                        if (_formatTag == kFormatExtensible)
+                        {
+                            if (fmtExtra < sizeof(FmtExtension))
+                                throw std::runtime_error("Truncated extensible fmt chunk in wav: " + path);
+
+                            FmtExtension ext{};
+                            in.read(reinterpret_cast<char*>(&ext), sizeof(FmtExtension));
+                            // samples are left-justified in their container, so the container width decides the layout
+                            _formatTag = static_cast<uint16_t>(ext.subFormat[0] | (ext.subFormat[1] << 8));
+                            fmtExtra -= sizeof(FmtExtension);
+                        }
+                        // chunks are padded to an even size
+                        fmtExtra += ch.size & 1u;
+                        if (fmtExtra > 0)
+                        {
+                            in.seekg(fmtExtra, std::ios::cur);
+                        }
+                        haveFormat = true;
+                    }
+                    else if (fourcc_eq(ch.id, "data"))
+                    {
+                        dataSize = ch.size;
+                        break;
+                    }
+                    else
+                    {
+                        in.seekg(static_cast<std::streamoff>(ch.size) + (ch.size & 1u), std::ios::cur);
+                    }
+                }
+
+                if (dataSize == 0 || !in)
+                    throw std::runtime_error("No data chunk in wav: " + path);
+
+                if (!haveFormat)
+                    throw std::runtime_error("No fmt chunk in wav: " + path);
+
+                if (_numChannels == 0)
+                    throw std::runtime_error("Invalid channel count in wav: " + path);
+
+                _format = resolveSampleFormat(_formatTag, _bitsPerSample, path);
+                _frameBytes = bytesPerSample(_format) * _numChannels;
+                if (_blockAlign != 0 && _blockAlign != _frameBytes)
+                    throw std::runtime_error("Unsupported block alignment " + std::to_string(_blockAlign) + " in wav: " + path);
+                return dataSize;
             }
-            mono /= numChannels;
-            buf.samples.push_back(mono);
-        }
 
-        return buf;
+            std::ifstream _file;
+            const unsigned char* _memory = nullptr;     // set when decoding from memory
+            std::streamoff _dataOffset = 0;             // first sample in the file or in _memory
+            uint16_t _numChannels = 0;
+            uint32_t _sampleRate = 0;
+            uint16_t _bitsPerSample = 0;
+            uint16_t _blockAlign = 0;
+            uint16_t _formatTag = 0;
+            SampleFormat _format = SampleFormat::Int16;
+            std::size_t _frameBytes = 0;
+            std::size_t _totalFrames = 0;
+            std::size_t _remainingFrames = 0;
+            std::vector<uint8_t> _raw;
+        };
+    }
+
+    AudioBuffer WavAudioReader::load(const std::filesystem::path& inputFile, source_location loc)
+    {
+        auto stream = open(inputFile, loc);
+        return readAllMono(*stream);
+    }
+
+    std::unique_ptr<IAudioStream> WavAudioReader::open(const std::filesystem::path& inputFile, source_location loc)
+    {
+        const auto resolvedPath = resolve_path(inputFile, loc);
+        return std::make_unique<WavAudioStream>(resolvedPath.string());
+    }
+
+    std::unique_ptr<IAudioStream> WavAudioReader::openMemory(const void* data, std::size_t size)
+    {
+        return std::make_unique<WavAudioStream>(static_cast<const unsigned char*>(data), size);
     }
 }
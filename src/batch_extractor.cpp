@@ -0,0 +1,146 @@
+#include "libvoicefeat/batch_extractor.h"
+
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace libvoicefeat
+{
+    namespace
+    {
+        // Blocks admission of new files while the estimated in-flight working set exceeds the cap. A file is
+        // always admitted when nothing else is in flight, so oversized inputs still make progress.
+        class MemoryBudget
+        {
+        public:
+            explicit MemoryBudget(std::size_t limit)
+                : _limit(limit)
+            {
+            }
+
+            void acquire(std::size_t bytes)
+            {
+                if (_limit == 0)
+                    return;
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                _released.wait(lock, [this, bytes]() { return _inFlight == 0 || _inFlight + bytes <= _limit; });
+                _inFlight += bytes;
+            }
+
+            void release(std::size_t bytes)
+            {
+                if (_limit == 0)
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _inFlight -= bytes;
+                }
+                _released.notify_all();
+            }
+
+        private:
+            std::size_t _limit = 0;
+            std::size_t _inFlight = 0;
+            std::mutex _mutex;
+            std::condition_variable _released;
+        };
+
+        std::shared_ptr<ThreadPool> requirePool(std::shared_ptr<ThreadPool> pool)
+        {
+            if (!pool)
+                throw std::invalid_argument("BatchExtractor requires a thread pool");
+            return pool;
+        }
+
+        std::size_t defaultPoolSize(const CepstralConfig& config)
+        {
+            if (config.threading.numThreads > 1)
+                return static_cast<std::size_t>(config.threading.numThreads);
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    BatchExtractor::BatchExtractor(const CepstralConfig& config, const BatchOptions& options)
+        : BatchExtractor(config, options, std::make_shared<ThreadPool>(defaultPoolSize(config)))
+    {
+    }
+
+    BatchExtractor::BatchExtractor(const CepstralConfig& config, const BatchOptions& options,
+                                   std::shared_ptr<ThreadPool> pool)
+        : _config(config)
+        , _options(options)
+        , _pool(requirePool(std::move(pool)))
+        , _extractor(config, _pool)
+    {
+    }
+
+    std::vector<BatchResult> BatchExtractor::extract(const std::vector<std::filesystem::path>& paths)
+    {
+        std::vector<BatchResult> results(paths.size());
+        if (paths.empty())
+            return results;
+
+        const std::size_t concurrency = _options.maxConcurrency > 0 ? _options.maxConcurrency : _pool->size();
+        const std::size_t lanes = std::min(paths.size(), concurrency);
+
+        std::atomic<std::size_t> next{0};
+        MemoryBudget budget(_options.maxInFlightBytes);
+
+        _pool->parallelFor(0, lanes, [&](std::size_t, std::size_t)
+        {
+            for (std::size_t i = next++; i < paths.size(); i = next++)
+            {
+                auto& result = results[i];
+                result.path = paths[i];
+
+                const std::size_t bytes = estimateWorkingSet(paths[i]);
+                budget.acquire(bytes);
+                try
+                {
+                    result.feature = _extractor.extractFromFile(paths[i].string());
+                }
+                catch (const std::exception& e)
+                {
+                    result.error = e.what();
+                }
+                catch (...)
+                {
+                    result.error = "Unknown error";
+                }
+                budget.release(bytes);
+            }
+        }, 1);
+
+        return results;
+    }
+
+    std::size_t BatchExtractor::estimateWorkingSet(const std::filesystem::path& path) const
+    {
+        // the stream header gives the decoded length for any sample format; unreadable files cost nothing here
+        // and fail in extraction instead
+        std::size_t samples = 0;
+        try
+        {
+            const auto stream = audio::createAudioReader(path)->open(path);
+            samples = stream->totalFrames() * static_cast<std::size_t>(std::max(1, stream->channels()));
+        }
+        catch (const std::exception&)
+        {
+            return 0;
+        }
+        const std::size_t floatBytes = samples * sizeof(float);
+
+        // decoded + working copy, plus overlapping frames (frameSize / frameStep copies of the signal)
+        const std::size_t frameCopies = static_cast<std::size_t>(
+            std::max(1, _config.framing.frameSize / std::max(1, _config.framing.frameStep)) + 1);
+        return floatBytes * (2 + frameCopies);
+    }
+}
@@ -1,10 +1,41 @@
 #include "libvoicefeat/dsp/fft_transformer.h"
 #include <cmath>
+#include <stdexcept>
 
 #include "libvoicefeat/utils/constants.h"
 
 namespace libvoicefeat::dsp {
 
+namespace {
+
+std::size_t nextPowerOfTwo(std::size_t n) {
+    std::size_t N = 1;
+    while (N < n) N <<= 1;
+    return N;
+}
+
+}
+
+FFTTransformer::FFTTransformer(std::size_t frameSize)
+    : _size(nextPowerOfTwo(frameSize)) {
+    std::size_t bits = 0;
+    while ((std::size_t{1} << bits) < _size) ++bits;
+
+    _bitReverse.resize(_size);
+    for (std::size_t i = 0; i < _size; ++i) {
+        std::size_t r = 0;
+        for (std::size_t b = 0; b < bits; ++b)
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        _bitReverse[i] = r;
+    }
+
+    // same expression as the recursive transform so both paths round identically
+    for (std::size_t N = 2; N <= _size; N <<= 1) {
+        for (std::size_t k = 0; k < N / 2; ++k)
+            _twiddles.push_back(std::polar(1.f, -2.f * static_cast<float>(constants::PI) * k / N));
+    }
+}
+
 void FFTTransformer::fft(std::vector<std::complex<float>>& data) const {
     const size_t N = data.size();
     if (N <= 1) return;
@@ -26,14 +57,44 @@ void FFTTransformer::fft(std::vector<std::complex<float>>& data) const {
     }
 }
 
+void FFTTransformer::fftPlanned(std::vector<std::complex<float>>& data) const {
+    const size_t N = data.size();
+    for (size_t i = 0; i < N; ++i) {
+        const size_t j = _bitReverse[i];
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    const std::complex<float>* w = _twiddles.data();
+    for (size_t m = 2; m <= N; m <<= 1) {
+        const size_t half = m / 2;
+        for (size_t start = 0; start < N; start += m) {
+            for (size_t k = 0; k < half; ++k) {
+                const std::complex<float> t = w[k] * data[start + k + half];
+                const std::complex<float> e = data[start + k];
+                data[start + k] = e + t;
+                data[start + k + half] = e - t;
+            }
+        }
+        w += half;
+    }
+}
+
+void FFTTransformer::transformInPlace(std::vector<std::complex<float>>& data) const {
+    if (data.size() != _size)
+        throw std::invalid_argument("FFT input must have exactly size() points");
+    fftPlanned(data);
+}
+
 std::vector<std::complex<float>> FFTTransformer::transform(const std::vector<float>& frame) const {
-    size_t N = 1;
-    while (N < frame.size()) N <<= 1;
+    const size_t N = nextPowerOfTwo(frame.size());
     std::vector<std::complex<float>> data(N);
     for (size_t i = 0; i < frame.size(); ++i)
         data[i] = frame[i];
 
-    fft(data);
+    if (N == _size)
+        fftPlanned(data);
+    else
+        fft(data);
     return data;
 }
 
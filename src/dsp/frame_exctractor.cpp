@@ -1,5 +1,6 @@
 #include "libvoicefeat/dsp/frame_extractor.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace libvoicefeat::dsp;
@@ -32,3 +33,43 @@ std::vector<Frame> FixedFrameExtractor::extract(const audio::AudioBuffer& audio)
 
     return frames;
 }
+
+StreamingFrameExtractor::StreamingFrameExtractor(int windowSize, int hopSize)
+    : _windowSize(windowSize), _hopSize(hopSize)
+{
+    if (windowSize <= 0)
+        throw std::invalid_argument("windowSize must be positive");
+    if (hopSize <= 0)
+        throw std::invalid_argument("hopSize must be positive");
+}
+
+void StreamingFrameExtractor::push(const float* samples, std::size_t count, std::vector<Frame>& out)
+{
+    // samples a hop larger than the window jumped over
+    const std::size_t skipped = std::min(_skip, count);
+    _skip -= skipped;
+    _pending.insert(_pending.end(), samples + skipped, samples + count);
+
+    const auto windowSize = static_cast<std::size_t>(_windowSize);
+    const auto hopSize = static_cast<std::size_t>(_hopSize);
+
+    std::size_t pos = 0;
+    for (; pos + windowSize <= _pending.size(); pos += hopSize)
+    {
+        Frame f;
+        f.data.assign(_pending.begin() + static_cast<std::ptrdiff_t>(pos),
+                      _pending.begin() + static_cast<std::ptrdiff_t>(pos + windowSize));
+        out.push_back(std::move(f));
+        ++_framesEmitted;
+    }
+
+    if (pos >= _pending.size())
+    {
+        _skip += pos - _pending.size();
+        _pending.clear();
+    }
+    else
+    {
+        _pending.erase(_pending.begin(), _pending.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+}
@@ -0,0 +1,138 @@
+#include "libvoicefeat/dsp/pruned_transformer.h"
+
+#include "libvoicefeat/utils/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace libvoicefeat::dsp;
+
+namespace
+{
+    std::size_t nextPowerOfTwo(std::size_t n)
+    {
+        std::size_t N = 1;
+        while (N < n)
+            N <<= 1;
+        return N;
+    }
+}
+
+PrunedTransformer::PrunedTransformer(std::size_t nFft, std::size_t binBegin, std::size_t binEnd)
+    : PrunedTransformer(nFft, binBegin, binEnd, cheaperMethod(nFft, binBegin, binEnd))
+{
+}
+
+PrunedTransformer::PrunedTransformer(std::size_t nFft, std::size_t binBegin, std::size_t binEnd, Method method)
+    : _size(nextPowerOfTwo(nFft)), _binBegin(binBegin), _binEnd(binEnd), _method(method)
+{
+    if (_size < 2)
+        throw std::invalid_argument("PrunedTransformer needs at least two FFT points");
+    if (binBegin >= binEnd || binEnd > _size)
+        throw std::invalid_argument("PrunedTransformer bin range must be non-empty and within the FFT size");
+
+    for (std::size_t k = binBegin; k < binEnd; ++k)
+    {
+        const double w = 2.0 * constants::PI * static_cast<double>(k) / static_cast<double>(_size);
+        if (_method == Method::HalfLength)
+            _twiddles.emplace_back(static_cast<float>(std::cos(w)), static_cast<float>(-std::sin(w)));
+        else
+        {
+            _cos.push_back(std::cos(w));
+            _sin.push_back(std::sin(w));
+        }
+    }
+    if (_method == Method::HalfLength)
+        _half = FFTTransformer(_size / 2);
+}
+
+bool PrunedTransformer::worthPruning(std::size_t nFft, std::size_t binBegin, std::size_t binEnd)
+{
+    const std::size_t N = nextPowerOfTwo(nFft);
+    return N >= 4 && binBegin < binEnd && 2 * (binEnd - binBegin) <= N / 2 + 1;
+}
+
+PrunedTransformer::Method PrunedTransformer::cheaperMethod(std::size_t nFft, std::size_t binBegin, std::size_t binEnd)
+{
+    // rough real-operation counts per frame
+    const std::size_t N = nextPowerOfTwo(nFft);
+    const std::size_t bins = binEnd - std::min(binBegin, binEnd);
+    const std::size_t half = N / 2;
+    std::size_t stages = 0;
+    while ((std::size_t{1} << stages) < half)
+        ++stages;
+
+    const std::size_t halfLength = 5 * half * stages + 2 * half + 16 * bins;
+    const std::size_t goertzel = 3 * N * bins;
+    return goertzel < halfLength ? Method::Goertzel : Method::HalfLength;
+}
+
+std::vector<std::complex<float>> PrunedTransformer::transform(const std::vector<float>& frame) const
+{
+    if (frame.size() > _size)
+        throw std::invalid_argument("Frame is longer than the pruned FFT size");
+
+    std::vector<std::complex<float>> out(_size);
+    if (_method == Method::HalfLength)
+        halfLength(frame, out);
+    else
+        goertzel(frame, out);
+    return out;
+}
+
+void PrunedTransformer::halfLength(const std::vector<float>& frame, std::vector<std::complex<float>>& out) const
+{
+    const std::size_t M = _size / 2;
+    std::vector<std::complex<float>> z(M);
+    for (std::size_t i = 0; i < frame.size(); ++i)
+    {
+        if (i % 2 == 0)
+            z[i / 2].real(frame[i]);
+        else
+            z[i / 2].imag(frame[i]);
+    }
+    _half.transformInPlace(z);
+
+    // Z = E + iO with E, O the transforms of the even and odd samples; both are recovered from Z[k] and
+    // conj Z[M - k], then combined only for the requested bins
+    const std::complex<float> minusHalfI(0.f, -0.5f);
+    for (std::size_t k = _binBegin; k < _binEnd; ++k)
+    {
+        const std::size_t j = k % M;
+        const std::complex<float> a = z[j];
+        const std::complex<float> b = std::conj(z[(M - j) % M]);
+        const std::complex<float> even = 0.5f * (a + b);
+        const std::complex<float> odd = minusHalfI * (a - b);
+        out[k] = even + _twiddles[k - _binBegin] * odd;
+    }
+}
+
+void PrunedTransformer::goertzel(const std::vector<float>& frame, std::vector<std::complex<float>>& out) const
+{
+    const std::size_t L = frame.size();
+    if (L == 0)
+        return;
+
+    for (std::size_t k = _binBegin; k < _binEnd; ++k)
+    {
+        const double c = _cos[k - _binBegin];
+        const double s = _sin[k - _binBegin];
+        const double coeff = 2.0 * c;
+
+        double s1 = 0.0, s2 = 0.0;
+        for (float x : frame)
+        {
+            const double s0 = static_cast<double>(x) + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        // y = s1 - e^{-jw} s2 is the DFT sum advanced by L - 1 samples; rotate it back
+        const std::complex<double> y(s1 - c * s2, s * s2);
+        const std::size_t turns = k * (L - 1) % _size;
+        const double phase = -2.0 * constants::PI * static_cast<double>(turns) / static_cast<double>(_size);
+        const std::complex<double> x = y * std::polar(1.0, phase);
+        out[k] = std::complex<float>(static_cast<float>(x.real()), static_cast<float>(x.imag()));
+    }
+}
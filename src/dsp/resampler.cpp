@@ -1,11 +1,52 @@
 #include "libvoicefeat/dsp/resampler.h"
 
+#include "libvoicefeat/utils/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <stdexcept>
 #include <samplerate.h>
 #include <string>
 
 namespace libvoicefeat::dsp
 {
+    namespace
+    {
+        constexpr int kConverterType = SRC_SINC_MEDIUM_QUALITY;
+
+        // Input samples kept on each side of a chunk, in zero crossings of the sinc kernel. The medium
+        // quality filter spans about 46 on each side (fewer than 20 is SRC_SINC_FASTEST); the kernel widens
+        // by 1/ratio when downsampling.
+        constexpr double kChunkMarginCrossings = 64.0;
+        constexpr std::size_t kMinChunkSamples = 1u << 16;
+
+        std::vector<float> resampleSpan(const float* in, std::size_t count, double ratio)
+        {
+            const long inputFrames  = static_cast<long>(count);
+            const long outputFrames = static_cast<long>(inputFrames * ratio) + 8;
+
+            std::vector<float> out(static_cast<std::size_t>(outputFrames));
+
+            SRC_DATA data{};
+            data.data_in       = in;
+            data.input_frames  = inputFrames;
+            data.data_out      = out.data();
+            data.output_frames = outputFrames;
+            data.src_ratio     = ratio;
+            data.end_of_input  = 1;
+
+            int error = src_simple(&data, kConverterType, 1);
+            if (error != 0) {
+                throw std::runtime_error(
+                    std::string("libsamplerate src_simple failed: ") + src_strerror(error));
+            }
+
+            out.resize(static_cast<std::size_t>(data.output_frames_gen));
+            return out;
+        }
+    }
+
     audio::AudioBuffer Resampler::resampleTo(const audio::AudioBuffer& in, int targetSampleRate)
     {
         if (targetSampleRate <= 0) {
@@ -45,7 +86,7 @@ namespace libvoicefeat::dsp
         data.src_ratio     = ratio;
         data.end_of_input  = 1; // all audio is provided at once
 
-        const int converterType = SRC_SINC_MEDIUM_QUALITY;
+        const int converterType = kConverterType;
 
         int error = src_simple(&data, converterType, channels);
         if (error != 0) {
@@ -56,4 +97,156 @@ namespace libvoicefeat::dsp
         out.samples.resize(static_cast<size_t>(data.output_frames_gen));
         return out;
     }
+
+    audio::AudioBuffer Resampler::resampleTo(const audio::AudioBuffer& in, int targetSampleRate,
+                                             utils::ThreadPool& pool, std::size_t chunkSamples,
+                                             const std::function<void()>& checkpoint)
+    {
+        if (targetSampleRate <= 0 || in.sampleRate <= 0 || in.sampleRate == targetSampleRate || in.samples.empty())
+            return resampleTo(in, targetSampleRate);
+
+        const std::size_t divisor = static_cast<std::size_t>(std::gcd(in.sampleRate, targetSampleRate));
+        const std::size_t inPeriod = static_cast<std::size_t>(in.sampleRate) / divisor;
+        const std::size_t outPeriod = static_cast<std::size_t>(targetSampleRate) / divisor;
+        const double ratio = static_cast<double>(targetSampleRate) / static_cast<double>(in.sampleRate);
+
+        const std::size_t total = in.samples.size();
+        if (chunkSamples == 0)
+            chunkSamples = std::max(kMinChunkSamples, (total + pool.size()) / (pool.size() + 1));
+        chunkSamples = (chunkSamples + inPeriod - 1) / inPeriod * inPeriod;
+
+        const std::size_t alignedMargin = contextSamples(in.sampleRate, targetSampleRate);
+
+        const std::size_t numChunks = (total + chunkSamples - 1) / chunkSamples;
+        if (numChunks < 2)
+            return resampleTo(in, targetSampleRate);
+
+        std::vector<std::vector<float>> pieces(numChunks);
+        pool.parallelFor(0, numChunks, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; ++c)
+            {
+                if (checkpoint)
+                    checkpoint();
+
+                const std::size_t chunkBegin = c * chunkSamples;
+                const std::size_t chunkEnd = std::min(total, chunkBegin + chunkSamples);
+                const bool last = chunkEnd == total;
+
+                // both window edges are multiples of inPeriod, so output index 0 of the window is exact
+                const std::size_t windowBegin = chunkBegin - std::min(chunkBegin, alignedMargin);
+                const std::size_t windowEnd = last ? total : std::min(total, chunkEnd + alignedMargin);
+
+                auto out = resampleSpan(in.samples.data() + windowBegin, windowEnd - windowBegin, ratio);
+
+                const std::size_t skip = (chunkBegin - windowBegin) / inPeriod * outPeriod;
+                const std::size_t keep = last ? out.size() - std::min(out.size(), skip)
+                                              : (chunkEnd - chunkBegin) / inPeriod * outPeriod;
+                if (out.size() < skip + keep)
+                    throw std::runtime_error("Chunked resampling produced a short chunk");
+
+                pieces[c].assign(out.begin() + static_cast<std::ptrdiff_t>(skip),
+                                 out.begin() + static_cast<std::ptrdiff_t>(skip + keep));
+            }
+        }, 1);
+
+        std::size_t outputSize = 0;
+        for (const auto& piece : pieces)
+            outputSize += piece.size();
+
+        audio::AudioBuffer out;
+        out.sampleRate = targetSampleRate;
+        out.samples.reserve(outputSize);
+        for (const auto& piece : pieces)
+            out.samples.insert(out.samples.end(), piece.begin(), piece.end());
+
+        return out;
+    }
+
+    std::size_t Resampler::contextSamples(int inputSampleRate, int targetSampleRate)
+    {
+        if (inputSampleRate <= 0 || targetSampleRate <= 0)
+            throw std::invalid_argument("sample rates must be positive");
+
+        const auto inPeriod = static_cast<std::size_t>(inputSampleRate / std::gcd(inputSampleRate, targetSampleRate));
+        const double ratio = static_cast<double>(targetSampleRate) / static_cast<double>(inputSampleRate);
+        const auto margin = static_cast<std::size_t>(std::ceil(kChunkMarginCrossings / std::min(ratio, 1.0)));
+        return (margin + inPeriod - 1) / inPeriod * inPeriod;
+    }
+
+    struct StreamingResampler::State
+    {
+        SRC_STATE* src = nullptr;
+    };
+
+    StreamingResampler::StreamingResampler(int inputSampleRate, int targetSampleRate)
+        : _state(std::make_unique<State>())
+    {
+        if (targetSampleRate <= 0) {
+            throw std::invalid_argument("targetSampleRate must be positive");
+        }
+
+        if (inputSampleRate <= 0) {
+            throw std::invalid_argument("input sampleRate must be positive");
+        }
+
+        _ratio = static_cast<double>(targetSampleRate) / static_cast<double>(inputSampleRate);
+
+        int error = 0;
+        _state->src = src_new(kConverterType, 1, &error);
+        if (_state->src == nullptr) {
+            throw std::runtime_error(
+                std::string("libsamplerate src_new failed: ") + src_strerror(error));
+        }
+    }
+
+    StreamingResampler::~StreamingResampler()
+    {
+        if (_state && _state->src)
+            src_delete(_state->src);
+    }
+
+    void StreamingResampler::process(const std::vector<float>& in, bool endOfInput, std::vector<float>& out)
+    {
+        process(in.data(), in.size(), endOfInput, out);
+    }
+
+    void StreamingResampler::process(const float* in, std::size_t count, bool endOfInput, std::vector<float>& out)
+    {
+        std::size_t consumed = 0;
+        while (true)
+        {
+            const long remaining = static_cast<long>(count - consumed);
+            const long capacity = static_cast<long>(remaining * _ratio) + 256;
+
+            const std::size_t offset = out.size();
+            out.resize(offset + static_cast<std::size_t>(capacity));
+
+            SRC_DATA data{};
+            data.data_in       = in + consumed;
+            data.input_frames  = remaining;
+            data.data_out      = out.data() + offset;
+            data.output_frames = capacity;
+            data.src_ratio     = _ratio;
+            data.end_of_input  = endOfInput ? 1 : 0;
+
+            const int error = src_process(_state->src, &data);
+            if (error != 0) {
+                throw std::runtime_error(
+                    std::string("libsamplerate src_process failed: ") + src_strerror(error));
+            }
+
+            out.resize(offset + static_cast<std::size_t>(data.output_frames_gen));
+            consumed += static_cast<std::size_t>(data.input_frames_used);
+
+            if (data.input_frames_used == 0 && data.output_frames_gen == 0)
+                break;
+
+            // when flushing, keep draining while the converter still fills the whole output window
+            const bool inputLeft = consumed < count;
+            const bool outputFull = data.output_frames_gen == capacity;
+            if (!inputLeft && !(endOfInput && outputFull))
+                break;
+        }
+    }
 }
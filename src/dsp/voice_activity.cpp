@@ -0,0 +1,64 @@
+#include "libvoicefeat/dsp/voice_activity.h"
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace libvoicefeat::dsp;
+
+VoiceActivityDetector::VoiceActivityDetector(const VadOptions& options, int sampleRate)
+    : _powerThreshold(std::pow(10.0, options.energyThresholdDb / 10.0)),
+      _quietPowerThreshold(std::pow(10.0, (options.energyThresholdDb - options.zcrMarginDb) / 10.0)),
+      _hangoverFrames(options.hangoverFrames)
+{
+    if (sampleRate <= 0)
+        throw std::invalid_argument("sampleRate must be positive");
+    if (options.hangoverFrames < 0 || options.zcrMarginDb < 0.0)
+        throw std::invalid_argument("VAD hangover and zero-crossing margin must not be negative");
+
+    _crossingRate = options.zeroCrossingRate / static_cast<double>(sampleRate);
+}
+
+bool VoiceActivityDetector::push(const Frame& frame)
+{
+    const auto& x = frame.data;
+
+    double power = 0.0;
+    std::size_t crossings = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        const double v = x[i];
+        power += v * v;
+        if (i > 0 && (x[i] >= 0.f) != (x[i - 1] >= 0.f))
+            ++crossings;
+    }
+
+    bool active = false;
+    if (!x.empty())
+    {
+        power /= static_cast<double>(x.size());
+        const double rate = static_cast<double>(crossings) / static_cast<double>(x.size());
+        active = power >= _powerThreshold || (power >= _quietPowerThreshold && rate >= _crossingRate);
+    }
+
+    if (active)
+    {
+        _remaining = _hangoverFrames;
+        return true;
+    }
+    if (_remaining > 0)
+    {
+        --_remaining;
+        return true;
+    }
+    return false;
+}
+
+std::vector<bool> VoiceActivityDetector::detect(const std::vector<Frame>& frames, const VadOptions& options,
+                                                int sampleRate)
+{
+    VoiceActivityDetector detector(options, sampleRate);
+    std::vector<bool> voiced(frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i)
+        voiced[i] = detector.push(frames[i]);
+    return voiced;
+}
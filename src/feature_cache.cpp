@@ -0,0 +1,384 @@
+#include "libvoicefeat/feature_cache.h"
+
+#include "libvoicefeat/features/feature_builder.h"
+#include "libvoicefeat/utils/hash.h"
+#include "libvoicefeat/utils/mapped_file.h"
+#include "libvoicefeat/utils/path.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace libvoicefeat
+{
+    namespace
+    {
+        // bump when the feature computation changes in a way the config does not capture
+        constexpr std::uint32_t kCacheSchema = 6;
+        constexpr char kMagic[4] = {'L', 'V', 'F', 'C'};
+        constexpr const char* kEntryExtension = ".lvfc";
+        constexpr const char* kTemporaryMarker = ".lvfc.tmp";
+        // a temporary file this old was left by a writer that died before its rename
+        constexpr auto kStaleTemporaryAge = std::chrono::hours(1);
+
+        struct EntryHeader
+        {
+            char magic[4];
+            std::uint32_t schema;
+            std::uint32_t rows;
+            std::uint32_t cols;
+            std::uint32_t voiced;               // uint32 speech frame indices after the matrix
+            std::uint32_t reserved[3];
+        };
+        static_assert(sizeof(EntryHeader) == 32, "entry data must start 16-byte aligned");
+
+        std::string toHex(std::uint64_t value)
+        {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+            return text;
+        }
+
+        bool isEntry(const std::filesystem::directory_entry& file)
+        {
+            std::error_code ec;
+            return file.is_regular_file(ec) && file.path().extension() == kEntryExtension;
+        }
+
+        bool isTemporary(const std::filesystem::directory_entry& file)
+        {
+            std::error_code ec;
+            return file.is_regular_file(ec) &&
+                   file.path().filename().string().find(kTemporaryMarker) != std::string::npos;
+        }
+
+        std::string temporarySuffix()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            thread_local std::mt19937_64 rng(std::random_device{}() ^
+                                             std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            return ".tmp" + toHex(rng() ^ counter.fetch_add(1));
+        }
+    }
+
+    struct CachedExtractor::DirectoryState
+    {
+        std::mutex mutex;
+        std::uint64_t storedBytes = 0;      // estimate between directory scans
+    };
+
+    std::uint64_t hashConfig(const CepstralConfig& config)
+    {
+        // field by field, so padding never leaks in; keep in sync with config.h
+        utils::Hasher h;
+        h.add(kCacheSchema);
+        h.add(static_cast<int>(config.type));
+
+        h.add(config.framing.frameSize);
+        h.add(config.framing.frameStep);
+        h.add(static_cast<int>(config.framing.window));
+
+        h.add(config.feature.sampleRate);
+        h.add(config.feature.numFilters);
+        h.add(config.feature.numCoeffs);
+        h.add(config.feature.minFreq);
+        h.add(config.feature.maxFreq);
+        h.add(config.feature.includeEnergy);
+        h.add(static_cast<int>(config.feature.filterbank));
+        h.add(static_cast<int>(config.feature.melScale));
+        h.add(static_cast<int>(config.feature.compressionType));
+        h.add(static_cast<int>(config.feature.transform));
+
+        h.add(config.delta.useDeltas);
+        h.add(config.delta.useDeltaDeltas);
+        h.add(config.delta.regressionWindow);
+
+        h.add(config.preemphasis.usePreEmphasis);
+        h.add(config.preemphasis.preEmphasisCoeff);
+
+        // the pool size only reaches the output through the chunk layout of chunked resampling
+        h.add(config.threading.chunkedResampling);
+        if (config.threading.chunkedResampling)
+            h.add(config.threading.numThreads);
+
+        h.add(config.resampling.nativeRate);
+
+        h.add(static_cast<int>(config.vad.mode));
+        h.add(config.vad.energyThresholdDb);
+        h.add(config.vad.zcrMarginDb);
+        h.add(config.vad.zeroCrossingRate);
+        h.add(config.vad.hangoverFrames);
+        return h.digest();
+    }
+
+    CachedExtractor::CachedExtractor(const CepstralConfig& config, const FeatureCacheOptions& options)
+        : CachedExtractor(std::make_shared<const CepstralExtractor>(config), options)
+    {
+    }
+
+    CachedExtractor::CachedExtractor(std::shared_ptr<const CepstralExtractor> extractor,
+                                     const FeatureCacheOptions& options)
+        : _extractor(std::move(extractor)),
+          _options(options)
+    {
+        if (!_extractor)
+            throw std::invalid_argument("extractor is null");
+        if (_options.directory.empty())
+            throw std::invalid_argument("Cache directory is empty");
+
+        std::filesystem::create_directories(_options.directory);
+        _configHash = hashConfig(_extractor->getConfig());
+
+        std::uint64_t bytes = 0;
+        for (const auto& file : std::filesystem::directory_iterator(_options.directory))
+        {
+            std::error_code ec;
+            if (isEntry(file))
+                bytes += file.file_size(ec);
+        }
+        _state = sharedState(_options.directory, bytes);
+    }
+
+    Feature CachedExtractor::extractFromFile(const std::string& path) const
+    {
+        std::filesystem::path entry;
+        try
+        {
+            entry = entryPath(path);
+        }
+        catch (const std::exception&)
+        {
+            // unreadable input: let the extractor report it the usual way
+            return _extractor->extractFromFile(path);
+        }
+
+        if (auto cached = load(entry))
+        {
+            ++_hits;
+            return std::move(*cached);
+        }
+
+        ++_misses;
+        auto feature = _extractor->extractFromFile(path);
+        store(entry, feature);
+        return feature;
+    }
+
+    void CachedExtractor::clear()
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        for (const auto& file : std::filesystem::directory_iterator(_options.directory))
+        {
+            std::error_code ec;
+            if (isEntry(file))
+                std::filesystem::remove(file.path(), ec);
+        }
+        _state->storedBytes = 0;
+    }
+
+    FeatureCacheStats CachedExtractor::getStats() const
+    {
+        return FeatureCacheStats{_hits.load(), _misses.load(), _evictions.load()};
+    }
+
+    std::filesystem::path CachedExtractor::entryPath(const std::filesystem::path& audioPath) const
+    {
+        // resolved the same way the extractor's readers resolve it
+        const auto resolved = utils::resolve_path(audioPath);
+
+        utils::Hasher h;
+        h.add(static_cast<int>(_options.keyMode));
+        if (_options.keyMode == CacheKeyMode::AudioContent)
+        {
+            const utils::MappedFile audio(resolved);
+            h.update(audio.data(), audio.size());
+        }
+        else
+        {
+            h.add(std::filesystem::canonical(resolved).string());
+            h.add(static_cast<std::uint64_t>(std::filesystem::file_size(resolved)));
+            h.add(static_cast<std::int64_t>(std::filesystem::last_write_time(resolved).time_since_epoch().count()));
+        }
+
+        return _options.directory / (toHex(h.digest()) + toHex(_configHash) + kEntryExtension);
+    }
+
+    std::optional<Feature> CachedExtractor::load(const std::filesystem::path& entry) const
+    {
+        std::error_code ec;
+        if (!std::filesystem::exists(entry, ec))
+            return std::nullopt;
+
+        std::optional<utils::MappedFile> file;
+        try
+        {
+            file.emplace(entry);
+        }
+        catch (const std::runtime_error&)
+        {
+            // evicted between the check and the open
+            return std::nullopt;
+        }
+
+        EntryHeader header{};
+        if (file->size() < sizeof(header))
+            return std::nullopt;
+        std::memcpy(&header, file->data(), sizeof(header));
+
+        const std::uint64_t expected = sizeof(header) + static_cast<std::uint64_t>(header.rows) * header.cols * sizeof(float) +
+                                       static_cast<std::uint64_t>(header.voiced) * sizeof(std::uint32_t);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.schema != kCacheSchema ||
+            file->size() != expected)
+        {
+            std::filesystem::remove(entry, ec);
+            return std::nullopt;
+        }
+
+        FeatureMatrix matrix(header.rows, FeatureVector(header.cols));
+        const unsigned char* data = file->data() + sizeof(header);
+        for (auto& row : matrix)
+        {
+            std::memcpy(row.data(), data, header.cols * sizeof(float));
+            data += header.cols * sizeof(float);
+        }
+
+        std::vector<std::size_t> voiced(header.voiced);
+        for (auto& frame : voiced)
+        {
+            std::uint32_t index = 0;
+            std::memcpy(&index, data, sizeof(index));
+            data += sizeof(index);
+            frame = index;
+        }
+
+        // the mtime is the LRU timestamp
+        std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+
+        auto feature = FeatureFactory::createDefaultFeature(_extractor->getConfig());
+        feature.setComputedMatrix(std::move(matrix));
+        feature.setVoicedFrames(std::move(voiced));
+        return feature;
+    }
+
+    void CachedExtractor::store(const std::filesystem::path& entry, const Feature& feature) const
+    {
+        const auto& matrix = feature.getComputedMatrix();
+        const std::size_t cols = matrix.empty() ? 0 : matrix.front().size();
+        std::vector<std::uint32_t> voiced(feature.getVoicedFrames().begin(), feature.getVoicedFrames().end());
+        EntryHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.schema = kCacheSchema;
+        header.rows = static_cast<std::uint32_t>(matrix.size());
+        header.cols = static_cast<std::uint32_t>(cols);
+        header.voiced = static_cast<std::uint32_t>(voiced.size());
+
+        // the cache is best effort: a failed write leaves no entry and never fails the extraction
+        std::filesystem::path temporary = entry;
+        temporary += temporarySuffix();
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto& row : matrix)
+                out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(cols * sizeof(float)));
+            out.write(reinterpret_cast<const char*>(voiced.data()),
+                      static_cast<std::streamsize>(voiced.size() * sizeof(std::uint32_t)));
+            out.close();
+
+            std::error_code ec;
+            if (!out)
+            {
+                std::filesystem::remove(temporary, ec);
+                return;
+            }
+            std::filesystem::rename(temporary, entry, ec);
+            if (ec)
+            {
+                std::filesystem::remove(temporary, ec);
+                return;
+            }
+        }
+
+        const std::uint64_t size = sizeof(header) + static_cast<std::uint64_t>(matrix.size()) * cols * sizeof(float) +
+                                   voiced.size() * sizeof(std::uint32_t);
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->storedBytes += size;
+        if (_options.maxBytes != 0 && _state->storedBytes > _options.maxBytes)
+            evict();
+    }
+
+    std::shared_ptr<CachedExtractor::DirectoryState> CachedExtractor::sharedState(const std::filesystem::path& directory,
+                                                                                  std::uint64_t scannedBytes)
+    {
+        static std::mutex registryMutex;
+        static std::map<std::string, std::weak_ptr<DirectoryState>> registry;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto& slot = registry[std::filesystem::canonical(directory).string()];
+        if (auto state = slot.lock())
+            return state;
+
+        auto state = std::make_shared<DirectoryState>();
+        state->storedBytes = scannedBytes;
+        slot = state;
+        return state;
+    }
+
+    void CachedExtractor::evict() const
+    {
+        struct Stored
+        {
+            std::filesystem::path path;
+            std::uint64_t size = 0;
+            std::filesystem::file_time_type lastUse{};
+        };
+
+        // rescan: other processes may share the directory
+        std::vector<Stored> entries;
+        std::uint64_t total = 0;
+        std::error_code ec;
+        const auto staleBefore = std::filesystem::file_time_type::clock::now() - kStaleTemporaryAge;
+        for (const auto& file : std::filesystem::directory_iterator(_options.directory, ec))
+        {
+            if (isTemporary(file))
+            {
+                std::error_code timeError;
+                const auto written = file.last_write_time(timeError);
+                if (!timeError && written < staleBefore)
+                    std::filesystem::remove(file.path(), timeError);
+                continue;
+            }
+            if (!isEntry(file))
+                continue;
+            Stored stored{file.path(), file.file_size(ec), file.last_write_time(ec)};
+            if (ec)
+                continue;
+            total += stored.size;
+            entries.push_back(std::move(stored));
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Stored& a, const Stored& b)
+        {
+            return a.lastUse < b.lastUse;
+        });
+
+        for (const auto& stored : entries)
+        {
+            if (total <= _options.maxBytes)
+                break;
+            if (std::filesystem::remove(stored.path, ec))
+            {
+                total -= stored.size;
+                ++_evictions;
+            }
+        }
+        _state->storedBytes = total;
+    }
+}
@@ -0,0 +1,244 @@
+#include "libvoicefeat/features/batch_kernels.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBVOICEFEAT_X86_DISPATCH 1
+#define LIBVOICEFEAT_INLINE inline __attribute__((always_inline))
+#else
+#define LIBVOICEFEAT_INLINE inline
+#endif
+
+namespace libvoicefeat::features::batch
+{
+    namespace
+    {
+        // The lane loops have a compile-time trip count and no remainder, so they lower to one vector
+        // operation per statement in the ISA of the wrapper they are inlined into.
+        template <std::size_t W>
+        LIBVOICEFEAT_INLINE void filterbankLanes(const std::vector<std::vector<double>>& filters, const double* magT,
+                                                 std::size_t binBegin, std::size_t binEnd, double* bandsT)
+        {
+            for (std::size_t m = 0; m < filters.size(); ++m)
+            {
+                const auto& f = filters[m];
+                const std::size_t N = std::min(f.size(), binEnd);
+
+                double acc[W] = {};
+                for (std::size_t k = binBegin; k < N; ++k)
+                {
+                    const double weight = f[k];
+                    const double* mag = magT + k * W;
+                    for (std::size_t lane = 0; lane < W; ++lane)
+                        acc[lane] += mag[lane] * weight;
+                }
+
+                for (std::size_t lane = 0; lane < W; ++lane)
+                    bandsT[m * W + lane] = acc[lane];
+            }
+        }
+
+        template <std::size_t W>
+        LIBVOICEFEAT_INLINE void dctLanes(const std::vector<std::vector<double>>& basis, const double* inT,
+                                          std::size_t numInputs, double* outT)
+        {
+            for (std::size_t k = 0; k < basis.size(); ++k)
+            {
+                const auto& row = basis[k];
+                const std::size_t N = std::min(row.size(), numInputs);
+
+                double acc[W] = {};
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                    const double weight = row[n];
+                    const double* in = inT + n * W;
+                    for (std::size_t lane = 0; lane < W; ++lane)
+                        acc[lane] += in[lane] * weight;
+                }
+
+                for (std::size_t lane = 0; lane < W; ++lane)
+                    outT[k * W + lane] = acc[lane];
+            }
+        }
+
+        // Interior frames [begin, end) need no clamping; W consecutive frames go through at once.
+        template <std::size_t W>
+        LIBVOICEFEAT_INLINE std::size_t deltaInteriorLanes(const float* track, std::size_t begin, std::size_t end,
+                                                           int N, double norm, float* out)
+        {
+            std::size_t t = begin;
+            for (; t + W <= end; t += W)
+            {
+                double acc[W] = {};
+                for (int n = 1; n <= N; ++n)
+                {
+                    const float* next = track + t + n;
+                    const float* prev = track + t - n;
+                    for (std::size_t lane = 0; lane < W; ++lane)
+                        acc[lane] += static_cast<double>(n) * (next[lane] - prev[lane]);
+                }
+
+                for (std::size_t lane = 0; lane < W; ++lane)
+                    out[t + lane] = static_cast<float>(acc[lane] * norm);
+            }
+            return t;
+        }
+
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        __attribute__((target("avx512f")))
+        void filterbank8(const std::vector<std::vector<double>>& filters, const double* magT, std::size_t binBegin,
+                         std::size_t binEnd, double* bandsT)
+        {
+            filterbankLanes<8>(filters, magT, binBegin, binEnd, bandsT);
+        }
+
+        __attribute__((target("avx2")))
+        void filterbank4(const std::vector<std::vector<double>>& filters, const double* magT, std::size_t binBegin,
+                         std::size_t binEnd, double* bandsT)
+        {
+            filterbankLanes<4>(filters, magT, binBegin, binEnd, bandsT);
+        }
+
+        __attribute__((target("avx512f")))
+        void dct8(const std::vector<std::vector<double>>& basis, const double* inT, std::size_t numInputs, double* outT)
+        {
+            dctLanes<8>(basis, inT, numInputs, outT);
+        }
+
+        __attribute__((target("avx2")))
+        void dct4(const std::vector<std::vector<double>>& basis, const double* inT, std::size_t numInputs, double* outT)
+        {
+            dctLanes<4>(basis, inT, numInputs, outT);
+        }
+
+        __attribute__((target("avx512f")))
+        std::size_t deltaInterior8(const float* track, std::size_t begin, std::size_t end, int N, double norm, float* out)
+        {
+            return deltaInteriorLanes<8>(track, begin, end, N, norm, out);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t deltaInterior4(const float* track, std::size_t begin, std::size_t end, int N, double norm, float* out)
+        {
+            return deltaInteriorLanes<4>(track, begin, end, N, norm, out);
+        }
+#endif
+
+        std::size_t detectLaneWidth()
+        {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return 8;
+            if (__builtin_cpu_supports("avx2"))
+                return 4;
+#endif
+            return 2;
+        }
+
+        void checkWidth(std::size_t width)
+        {
+            if (width != 2 && width > laneWidth())
+                throw std::invalid_argument("Lane width not supported on this CPU");
+        }
+    }
+
+    std::size_t laneWidth()
+    {
+        static const std::size_t width = detectLaneWidth();
+        return width;
+    }
+
+    void filterbank(const std::vector<std::vector<double>>& filters, const double* magT, std::size_t binBegin,
+                    std::size_t binEnd, double* bandsT, std::size_t width)
+    {
+        checkWidth(width);
+        switch (width)
+        {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        case 8:
+            filterbank8(filters, magT, binBegin, binEnd, bandsT);
+            return;
+        case 4:
+            filterbank4(filters, magT, binBegin, binEnd, bandsT);
+            return;
+#endif
+        case 2:
+            filterbankLanes<2>(filters, magT, binBegin, binEnd, bandsT);
+            return;
+        default:
+            throw std::invalid_argument("Unsupported lane width");
+        }
+    }
+
+    void dct(const std::vector<std::vector<double>>& basis, const double* inT, std::size_t numInputs,
+             double* outT, std::size_t width)
+    {
+        checkWidth(width);
+        switch (width)
+        {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        case 8:
+            dct8(basis, inT, numInputs, outT);
+            return;
+        case 4:
+            dct4(basis, inT, numInputs, outT);
+            return;
+#endif
+        case 2:
+            dctLanes<2>(basis, inT, numInputs, outT);
+            return;
+        default:
+            throw std::invalid_argument("Unsupported lane width");
+        }
+    }
+
+    void deltaTrack(const float* track, std::size_t frames, int N, double norm, float* out)
+    {
+        const auto clamped = [&](std::size_t t)
+        {
+            const int last = static_cast<int>(frames) - 1;
+            double num = 0.0;
+            for (int n = 1; n <= N; ++n)
+            {
+                const std::size_t prev = std::clamp(static_cast<int>(t) - n, 0, last);
+                const std::size_t next = std::clamp(static_cast<int>(t) + n, 0, last);
+                num += static_cast<double>(n) * (track[next] - track[prev]);
+            }
+            out[t] = static_cast<float>(num * norm);
+        };
+
+        const std::size_t edge = static_cast<std::size_t>(N);
+        if (frames <= 2 * edge)
+        {
+            for (std::size_t t = 0; t < frames; ++t)
+                clamped(t);
+            return;
+        }
+
+        const std::size_t begin = edge;
+        const std::size_t end = frames - edge;
+        for (std::size_t t = 0; t < begin; ++t)
+            clamped(t);
+
+        std::size_t t = begin;
+        switch (laneWidth())
+        {
+#ifdef LIBVOICEFEAT_X86_DISPATCH
+        case 8:
+            t = deltaInterior8(track, begin, end, N, norm, out);
+            break;
+        case 4:
+            t = deltaInterior4(track, begin, end, N, norm, out);
+            break;
+#endif
+        default:
+            t = deltaInteriorLanes<2>(track, begin, end, N, norm, out);
+            break;
+        }
+
+        for (; t < frames; ++t)
+            clamped(t);
+    }
+}
@@ -4,8 +4,75 @@
 #include <cmath>
 #include <stdexcept>
 
+#include "libvoicefeat/features/batch_kernels.h"
+#include "libvoicefeat/utils/thread_pool.h"
+
 namespace libvoicefeat::features
 {
+    namespace
+    {
+        double deltaNorm(int N)
+        {
+            double denominator = 0.0;
+            for (int n = 1; n <= N; ++n)
+            {
+                denominator += static_cast<double>(n * n);
+            }
+            denominator *= 2.0;
+            return denominator == 0.0 ? 0.0 : 1.0 / denominator;
+        }
+
+        // Coefficient-major copy: track d holds coefficient d of every frame contiguously, which is the
+        // layout the delta kernel vectorizes over.
+        std::vector<float> toTracks(const FeatureMatrix& rows)
+        {
+            const std::size_t T = rows.size();
+            const std::size_t D = rows.front().size();
+
+            std::vector<float> tracks(D * T);
+            for (std::size_t t = 0; t < T; ++t)
+            {
+                for (std::size_t d = 0; d < D; ++d)
+                    tracks[d * T + t] = rows[t][d];
+            }
+            return tracks;
+        }
+
+        void fromTracks(const std::vector<float>& tracks, std::size_t begin, std::size_t end, FeatureMatrix& rows)
+        {
+            const std::size_t T = rows.size();
+            const std::size_t D = rows.front().size();
+
+            for (std::size_t t = begin; t < end; ++t)
+            {
+                for (std::size_t d = 0; d < D; ++d)
+                    rows[t][d] = tracks[d * T + t];
+            }
+        }
+
+        void computeDeltaTracks(const std::vector<float>& tracks, std::size_t T, int N, double norm,
+                                std::size_t begin, std::size_t end, std::vector<float>& deltas)
+        {
+            for (std::size_t d = begin; d < end; ++d)
+            {
+                batch::deltaTrack(tracks.data() + d * T, T, N, norm, deltas.data() + d * T);
+            }
+        }
+
+        void concatRows(const FeatureMatrix& delta, const FeatureMatrix& deltaDelta,
+                        bool useDelta, bool useDeltaDelta,
+                        std::size_t begin, std::size_t end, FeatureMatrix& out)
+        {
+            for (std::size_t t = begin; t < end; ++t)
+            {
+                if (useDelta)
+                    out[t].insert(out[t].end(), delta[t].begin(), delta[t].end());
+                if (useDeltaDelta)
+                    out[t].insert(out[t].end(), deltaDelta[t].begin(), deltaDelta[t].end());
+            }
+        }
+    }
+
     FeatureMatrix computeDelta(const FeatureMatrix& mfcc, int N)
     {
         FeatureMatrix deltas;
@@ -17,31 +84,39 @@ namespace libvoicefeat::features
 
         const std::size_t T = mfcc.size();
         const std::size_t D = mfcc.front().size();
+        const auto tracks = toTracks(mfcc);
+        std::vector<float> deltaTracks(tracks.size());
+        computeDeltaTracks(tracks, T, N, deltaNorm(N), 0, D, deltaTracks);
+
         deltas.assign(T, FeatureVector(D, 0.0f));
+        fromTracks(deltaTracks, 0, T, deltas);
+        return deltas;
+    }
 
-        double denominator = 0.0;
-        for (int n = 1; n <= N; ++n)
-        {
-            denominator += static_cast<double>(n * n);
-        }
-        denominator *= 2.0;
-        const double norm = denominator == 0.0 ? 0.0 : 1.0 / denominator;
+    FeatureMatrix computeDelta(const FeatureMatrix& mfcc, int N, utils::ThreadPool& pool)
+    {
+        FeatureMatrix deltas;
+        if (mfcc.empty())
+            return deltas;
 
-        for (std::size_t t = 0; t < T; ++t)
+        if (N <= 0)
+            throw std::invalid_argument("Delta window N must be positive");
+
+        const std::size_t T = mfcc.size();
+        const std::size_t D = mfcc.front().size();
+        const auto tracks = toTracks(mfcc);
+        std::vector<float> deltaTracks(tracks.size());
+        const double norm = deltaNorm(N);
+        pool.parallelFor(0, D, [&](std::size_t begin, std::size_t end)
         {
-            for (std::size_t d = 0; d < D; ++d)
-            {
-                double num = 0.0;
-                for (int n = 1; n <= N; ++n)
-                {
-                    const std::size_t prev = std::clamp(static_cast<int>(t) - n, 0, static_cast<int>(T) - 1);
-                    const std::size_t next = std::clamp(static_cast<int>(t) + n, 0, static_cast<int>(T) - 1);
-                    num += static_cast<double>(n) * (mfcc[next][d] - mfcc[prev][d]);
-                }
-                deltas[t][d] = static_cast<float>(num * norm);
-            }
-        }
+            computeDeltaTracks(tracks, T, N, norm, begin, end, deltaTracks);
+        }, 1);
 
+        deltas.assign(T, FeatureVector(D, 0.0f));
+        pool.parallelFor(0, T, [&](std::size_t begin, std::size_t end)
+        {
+            fromTracks(deltaTracks, begin, end, deltas);
+        });
         return deltas;
     }
 
@@ -62,14 +137,152 @@ namespace libvoicefeat::features
         const auto deltaDelta = useDeltaDelta ? computeDeltaDelta(base, N) : FeatureMatrix{};
 
         FeatureMatrix out = base;
-        for (std::size_t t = 0; t < out.size(); ++t)
+        concatRows(delta, deltaDelta, useDelta, useDeltaDelta, 0, out.size(), out);
+        return out;
+    }
+
+    FeatureMatrix appendDeltas(const FeatureMatrix& base, bool useDelta, bool useDeltaDelta, int N,
+                               utils::ThreadPool& pool)
+    {
+        if (base.empty())
+            return base;
+
+        if (!useDelta && !useDeltaDelta)
+            return base;
+
+        // delta-delta is the delta of the delta track, so the first pass is always needed
+        const auto delta = computeDelta(base, N, pool);
+        const auto deltaDelta = useDeltaDelta ? computeDelta(delta, N, pool) : FeatureMatrix{};
+
+        FeatureMatrix out = base;
+        pool.parallelFor(0, out.size(), [&](std::size_t begin, std::size_t end)
+        {
+            concatRows(delta, deltaDelta, useDelta, useDeltaDelta, begin, end, out);
+        });
+        return out;
+    }
+
+    StreamingDeltas::StreamingDeltas(bool useDelta, bool useDeltaDelta, int N)
+        : _useDelta(useDelta),
+          _useDeltaDelta(useDeltaDelta),
+          _delta(N, deltaNorm(N)),
+          _deltaDelta(N, deltaNorm(N))
+    {
+        if ((useDelta || useDeltaDelta) && N <= 0)
+            throw std::invalid_argument("Delta window N must be positive");
+    }
+
+    void StreamingDeltas::push(FeatureVector row, FeatureMatrix& out)
+    {
+        if (!_useDelta && !_useDeltaDelta)
         {
-            if (useDelta)
-                out[t].insert(out[t].end(), delta[t].begin(), delta[t].end());
-            if (useDeltaDelta)
-                out[t].insert(out[t].end(), deltaDelta[t].begin(), deltaDelta[t].end());
+            out.push_back(std::move(row));
+            return;
         }
 
-        return out;
+        _base.push_back(row);
+        FeatureMatrix deltas;
+        _delta.push(std::move(row), deltas);
+        feedDeltas(deltas);
+        assemble(out);
+    }
+
+    void StreamingDeltas::finish(FeatureMatrix& out)
+    {
+        if (!_useDelta && !_useDeltaDelta)
+            return;
+
+        FeatureMatrix deltas;
+        _delta.finish(deltas);
+        feedDeltas(deltas);
+        if (_useDeltaDelta)
+        {
+            FeatureMatrix deltaDeltas;
+            _deltaDelta.finish(deltaDeltas);
+            _deltaDeltas.insert(_deltaDeltas.end(), std::make_move_iterator(deltaDeltas.begin()),
+                                std::make_move_iterator(deltaDeltas.end()));
+        }
+        assemble(out);
+    }
+
+    void StreamingDeltas::feedDeltas(FeatureMatrix& deltas)
+    {
+        for (auto& delta : deltas)
+        {
+            if (_useDeltaDelta)
+            {
+                FeatureMatrix deltaDeltas;
+                _deltaDelta.push(delta, deltaDeltas);
+                _deltaDeltas.insert(_deltaDeltas.end(), std::make_move_iterator(deltaDeltas.begin()),
+                                    std::make_move_iterator(deltaDeltas.end()));
+            }
+            if (_useDelta)
+                _deltas.push_back(std::move(delta));
+        }
+    }
+
+    void StreamingDeltas::assemble(FeatureMatrix& out)
+    {
+        while (!_base.empty() && (!_useDelta || !_deltas.empty()) && (!_useDeltaDelta || !_deltaDeltas.empty()))
+        {
+            FeatureVector row = std::move(_base.front());
+            _base.pop_front();
+            if (_useDelta)
+            {
+                row.insert(row.end(), _deltas.front().begin(), _deltas.front().end());
+                _deltas.pop_front();
+            }
+            if (_useDeltaDelta)
+            {
+                row.insert(row.end(), _deltaDeltas.front().begin(), _deltaDeltas.front().end());
+                _deltaDeltas.pop_front();
+            }
+            out.push_back(std::move(row));
+        }
+    }
+
+    void StreamingDeltas::Stage::push(FeatureVector row, FeatureMatrix& out)
+    {
+        _window.push_back(std::move(row));
+        ++_pushed;
+
+        // output t reads inputs up to t + N, so no clamping happens before finish()
+        while (_next + static_cast<std::size_t>(_N) < _pushed)
+            emit(_pushed - 1, out);
+    }
+
+    void StreamingDeltas::Stage::finish(FeatureMatrix& out)
+    {
+        while (_next < _pushed)
+            emit(_pushed - 1, out);
+    }
+
+    void StreamingDeltas::Stage::emit(std::size_t last, FeatureMatrix& out)
+    {
+        const std::size_t t = _next;
+        const std::size_t D = _window[t - _first].size();
+
+        // same accumulation order and clamping as batch::deltaTrack, so rows match computeDelta() bitwise
+        FeatureVector delta(D);
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            double num = 0.0;
+            for (int n = 1; n <= _N; ++n)
+            {
+                const auto offset = static_cast<std::size_t>(n);
+                const std::size_t prev = t >= offset ? t - offset : 0;
+                const std::size_t next = std::min(t + offset, last);
+                num += static_cast<double>(n) * (_window[next - _first][d] - _window[prev - _first][d]);
+            }
+            delta[d] = static_cast<float>(num * _norm);
+        }
+        out.push_back(std::move(delta));
+        ++_next;
+
+        while (_first + static_cast<std::size_t>(_N) < _next)
+        {
+            _window.pop_front();
+            ++_first;
+        }
     }
 }
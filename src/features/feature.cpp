@@ -1,9 +1,16 @@
 #include "libvoicefeat/features/feature.h"
 
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
+#include "libvoicefeat/dsp/fft_transformer.h"
+#include "libvoicefeat/dsp/voice_activity.h"
+#include "libvoicefeat/features/batch_kernels.h"
 #include "libvoicefeat/features/delta.h"
+#include "libvoicefeat/features/pncc.h"
 #include "libvoicefeat/utils/constants.h"
+#include "libvoicefeat/utils/thread_pool.h"
 
 using namespace libvoicefeat::features;
 using namespace libvoicefeat::dsp;
@@ -14,85 +21,420 @@ libvoicefeat::FeatureMatrix Feature::compute(const std::vector<Frame>& frames,
     if (frames.empty())
         return _computed;
 
+    prepare(transformer, frames.front());
+
+    const auto voiced = detectVoiceActivity(frames);
+    return finish(computeFrames(frames, 0, frames.size(), transformer, voiced), voiced);
+}
+
+libvoicefeat::FeatureMatrix Feature::compute(const std::vector<Frame>& frames,
+                                             const ITransformer& transformer,
+                                             utils::ThreadPool& pool)
+{
+    if (frames.empty())
+        return _computed;
+
+    prepare(transformer, frames.front());
+    const auto voiced = detectVoiceActivity(frames);
+
+    // blocks start on lane-group boundaries so only the final group can be partial
+    const std::size_t width = batch::laneWidth();
+    const std::size_t groups = (frames.size() + width - 1) / width;
+
+    FeatureMatrix rows(frames.size());
+    pool.parallelFor(0, groups, [&](std::size_t begin, std::size_t end)
+    {
+        const std::size_t first = begin * width;
+        auto block = computeFrames(frames, first, std::min(frames.size(), end * width), transformer, voiced);
+        std::move(block.begin(), block.end(), rows.begin() + static_cast<std::ptrdiff_t>(first));
+    });
+
+    return finish(std::move(rows), voiced, pool);
+}
+
+void Feature::prepare(const ITransformer& transformer, const Frame& firstFrame)
+{
+    auto firstSpectrum = transformer.transform(firstFrame.data);
+    prepare(static_cast<int>(firstSpectrum.size()));
+}
+
+void Feature::prepare(int nFft)
+{
     _computed.clear();
+    _voicedFrames.clear();
+
+    if (!_plan || _plan->nFft != nFft)
+        _plan = makePlan(nFft);
+
+    _options = _plan->options;
+}
+
+libvoicefeat::FeatureVector Feature::computeFrame(const Frame& frame, const ITransformer& transformer) const
+{
+    return processFrame(frame, frameMagnitude(frame, transformer), *_plan);
+}
+
+std::vector<double> Feature::frameMagnitude(const Frame& frame, const ITransformer& transformer) const
+{
+    const FeaturePlan& plan = *_plan;
+
+    // the pruned transform only stands in for the planned FFT it was sized for
+    const auto* fft = dynamic_cast<const FFTTransformer*>(&transformer);
+    const bool pruned = plan.pruned && fft && fft->size() == plan.pruned->size() &&
+                        plan.pruned->coversFrame(frame.data.size());
+
+    const auto spec = pruned ? plan.pruned->transform(frame.data) : transformer.transform(frame.data);
+    return magnitudeSpectrum(spec, plan.nFreqs, plan.binBegin, plan.binEnd);
+}
 
-    _options.numCoeffs = std::max(1, _options.numCoeffs);
-    _options.numFilters = std::max(1, _options.numFilters);
-    _options.sampleRate = std::max(1, _options.sampleRate);
+libvoicefeat::FeatureMatrix Feature::computeFrames(const std::vector<Frame>& frames, std::size_t begin, std::size_t end,
+                                                   const ITransformer& transformer) const
+{
+    std::vector<std::size_t> selected(end > begin ? end - begin : 0);
+    for (std::size_t i = 0; i < selected.size(); ++i)
+        selected[i] = begin + i;
+    return computeSelected(frames, selected, transformer);
+}
+
+libvoicefeat::FeatureMatrix Feature::computeFrames(const std::vector<Frame>& frames, std::size_t begin, std::size_t end,
+                                                   const ITransformer& transformer, const std::vector<bool>& voiced) const
+{
+    if (voiced.empty())
+        return computeFrames(frames, begin, end, transformer);
+    if (voiced.size() != frames.size())
+        throw std::invalid_argument("Voice activity mask does not match the frames");
+
+    std::vector<std::size_t> selected;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        if (voiced[i])
+            selected.push_back(i);
+    }
+
+    auto speech = computeSelected(frames, selected, transformer);
+    FeatureMatrix rows(end > begin ? end - begin : 0, _plan->silence);
+    for (std::size_t i = 0; i < selected.size(); ++i)
+        rows[selected[i] - begin] = std::move(speech[i]);
+    return rows;
+}
+
+std::vector<bool> Feature::detectVoiceActivity(const std::vector<Frame>& frames) const
+{
+    if (_vad.mode == VadMode::Off)
+        return {};
+
+    // the plan's rate is the rate the frames were cut at, also in native-rate mode
+    const int sampleRate = _plan ? _plan->options.sampleRate : _options.sampleRate;
+    return VoiceActivityDetector::detect(frames, _vad, sampleRate);
+}
+
+libvoicefeat::FeatureMatrix Feature::computeSelected(const std::vector<Frame>& frames,
+                                                     const std::vector<std::size_t>& selected,
+                                                     const ITransformer& transformer) const
+{
+    const FeaturePlan& plan = *_plan;
+    const std::size_t count = selected.size();
 
-    auto firstSpectrum = transformer.transform(frames.front().data);
-    const int nFft = static_cast<int>(firstSpectrum.size());
-    const int nFreqs = nFft / 2 + 1; // number of unique freqs
+    const bool channelRows = isPowerNormalized();
+    // LPC batches everything up to the compressed bands; the recursion itself runs per lane
+    const bool lpc = plan.options.transform == CepstralTransform::LPC;
 
-    normalizeFrequencyRange();
-    setupFbParams(nFft);
+    const std::size_t width = batch::laneWidth();
+    const std::size_t nFreqs = static_cast<std::size_t>(plan.nFreqs);
+    const std::size_t nBands = plan.filters.size();
+    const std::size_t nCoeffs = plan.dct.size();
 
-    const auto fbank = createFilterbank(_options.filterbank, _options.melScale);
-    const auto filters = fbank->build(_fbParams);
+    std::vector<double> magT(nFreqs * width);
+    std::vector<double> bandsT(nBands * width);
+    std::vector<double> cepstraT(nCoeffs * width);
 
-    for (std::size_t i = 0; i < frames.size(); ++i)
+    FeatureMatrix rows(count);
+    for (std::size_t group = 0; group < count; group += width)
     {
-        auto spec = transformer.transform(frames[i].data);
-        processFrame(frames[i], spec, filters, nFreqs);
+        const std::size_t lanes = std::min(width, count - group);
+
+        // unused lanes of a final partial group are computed on silence and dropped
+        std::fill(magT.begin(), magT.end(), 0.0);
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            const auto mag = frameMagnitude(frames[selected[group + lane]], transformer);
+            for (std::size_t k = plan.binBegin; k < plan.binEnd; ++k)
+                magT[k * width + lane] = plan.powerSpectrum ? mag[k] * mag[k] : mag[k];
+        }
+
+        batch::filterbank(plan.filters, magT.data(), plan.binBegin, plan.binEnd, bandsT.data(), width);
+        if (channelRows)
+        {
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                auto& row = rows[group + lane];
+                row.resize(nBands + (_options.includeEnergy ? 1 : 0));
+                for (std::size_t m = 0; m < nBands; ++m)
+                    row[m] = static_cast<float>(bandsT[m * width + lane]);
+                if (_options.includeEnergy)
+                    row[nBands] = static_cast<float>(logEnergy(frames[selected[group + lane]], plan));
+            }
+            continue;
+        }
+
+        applyCompression(bandsT, _options.compressionType);
+        if (lpc)
+        {
+            std::vector<double> bands(nBands);
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                for (std::size_t m = 0; m < nBands; ++m)
+                    bands[m] = bandsT[m * width + lane];
+                const auto coeffs = lpcCepstra(bands, plan);
+
+                auto& row = rows[group + lane];
+                row.assign(coeffs.begin(), coeffs.end());
+                if (_options.includeEnergy && !row.empty())
+                    row[0] = static_cast<float>(logEnergy(frames[selected[group + lane]], plan));
+            }
+            continue;
+        }
+
+        batch::dct(plan.dct, bandsT.data(), nBands, cepstraT.data(), width);
+
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            auto& row = rows[group + lane];
+            row.resize(nCoeffs);
+            for (std::size_t k = 0; k < nCoeffs; ++k)
+                row[k] = static_cast<float>(cepstraT[k * width + lane]);
+
+            if (_options.includeEnergy && !row.empty())
+                row[0] = static_cast<float>(logEnergy(frames[selected[group + lane]], plan));
+        }
     }
 
-    _computed = appendDeltas(_computed, _useDeltas, _useDelteDeltas);
+    return rows;
+}
+
+libvoicefeat::FeatureVector Feature::computeFromSpectrum(const Frame& frame, const std::vector<double>& magnitude) const
+{
+    return processFrame(frame, magnitude, *_plan);
+}
+
+const libvoicefeat::FeatureMatrix& Feature::finish(FeatureMatrix rows)
+{
+    _computed = appendDeltas(completeRows(std::move(rows)), _useDeltas, _useDelteDeltas);
     return _computed;
 }
 
+const libvoicefeat::FeatureMatrix& Feature::finish(FeatureMatrix rows, utils::ThreadPool& pool)
+{
+    _computed = appendDeltas(completeRows(std::move(rows)), _useDeltas, _useDelteDeltas, 2, pool);
+    return _computed;
+}
+
+const libvoicefeat::FeatureMatrix& Feature::finish(FeatureMatrix rows, const std::vector<bool>& voiced)
+{
+    return finish(gateRows(std::move(rows), voiced));
+}
+
+const libvoicefeat::FeatureMatrix& Feature::finish(FeatureMatrix rows, const std::vector<bool>& voiced,
+                                                   utils::ThreadPool& pool)
+{
+    return finish(gateRows(std::move(rows), voiced), pool);
+}
+
+libvoicefeat::FeatureMatrix Feature::gateRows(FeatureMatrix rows, const std::vector<bool>& voiced)
+{
+    _voicedFrames.clear();
+    if (voiced.empty())
+        return rows;
+    if (voiced.size() != rows.size())
+        throw std::invalid_argument("Voice activity mask does not match the rows");
+
+    for (std::size_t i = 0; i < voiced.size(); ++i)
+    {
+        if (voiced[i])
+            _voicedFrames.push_back(i);
+    }
+    if (_vad.mode != VadMode::Drop)
+        return rows;
+
+    FeatureMatrix speech;
+    speech.reserve(_voicedFrames.size());
+    for (std::size_t index : _voicedFrames)
+        speech.push_back(std::move(rows[index]));
+    return speech;
+}
+
+libvoicefeat::FeatureMatrix Feature::completeRows(FeatureMatrix rows) const
+{
+    if (!isPowerNormalized() || rows.empty())
+        return rows;
+
+    StreamingCepstra stream(*this);
+    FeatureMatrix out;
+    out.reserve(rows.size());
+    for (auto& row : rows)
+        stream.push(std::move(row), out);
+    stream.finish(out);
+    return out;
+}
+
+void Feature::setComputedMatrix(FeatureMatrix matrix)
+{
+    _computed = std::move(matrix);
+}
+
+void Feature::setVoicedFrames(std::vector<std::size_t> frames)
+{
+    _voicedFrames = std::move(frames);
+}
+
+std::shared_ptr<const FeaturePlan> Feature::makePlan(int nFft) const
+{
+    auto plan = std::make_shared<FeaturePlan>();
+    plan->options = _options;
+    plan->options.numCoeffs = std::max(1, plan->options.numCoeffs);
+    plan->options.numFilters = std::max(1, plan->options.numFilters);
+    plan->options.sampleRate = std::max(1, plan->options.sampleRate);
+    normalizeFrequencyRange(plan->options);
+
+    plan->nFft = nFft;
+    plan->nFreqs = nFft / 2 + 1; // number of unique freqs
+
+    FilterbankParams params;
+    params.sampleRate = plan->options.sampleRate;
+    params.nFft = nFft;
+    params.numFilters = plan->options.numFilters;
+    params.minFreq = plan->options.minFreq;
+    params.maxFreq = plan->options.maxFreq;
+
+    const auto fbank = createFilterbank(plan->options.filterbank, plan->options.melScale);
+    plan->filters = fbank->build(params);
+    plan->dct = buildDctBasis(static_cast<int>(plan->filters.size()), plan->options.numCoeffs);
+
+    if (plan->options.transform == CepstralTransform::LPC || isPowerNormalized())
+        plan->powerSpectrum = true;
+
+    // PNCC channel power is the output power of each filter, the sum of |X|^2 |H|^2
+    if (isPowerNormalized())
+    {
+        for (auto& filter : plan->filters)
+            for (auto& weight : filter)
+                weight *= weight;
+    }
+
+    if (plan->options.transform == CepstralTransform::LPC)
+    {
+        if (_cepstralType == CepstralType::PLP)
+        {
+            // the LPC path integrates power, so the weights apply to the band sums as they are
+            const auto loudness = equalLoudness(plan->filters, nFft, plan->options.sampleRate);
+            for (std::size_t m = 0; m < plan->filters.size(); ++m)
+                for (auto& weight : plan->filters[m])
+                    weight *= loudness[m];
+        }
+
+        const int numBands = static_cast<int>(plan->filters.size());
+        const int order = std::max(1, std::min(plan->options.numCoeffs - 1, numBands));
+        plan->idft = buildIdftBasis(numBands, order);
+    }
+
+    // bins outside every filter's support only ever meet zero weights
+    plan->binBegin = static_cast<std::size_t>(plan->nFreqs);
+    for (const auto& filter : plan->filters)
+    {
+        for (std::size_t k = 0; k < std::min(filter.size(), static_cast<std::size_t>(plan->nFreqs)); ++k)
+        {
+            if (filter[k] != 0.0)
+            {
+                plan->binBegin = std::min(plan->binBegin, k);
+                plan->binEnd = std::max(plan->binEnd, k + 1);
+            }
+        }
+    }
+    if (plan->binBegin >= plan->binEnd)
+        plan->binBegin = plan->binEnd = 0;
+    else if (dsp::PrunedTransformer::worthPruning(static_cast<std::size_t>(nFft), plan->binBegin, plan->binEnd))
+        plan->pruned = std::make_shared<dsp::PrunedTransformer>(static_cast<std::size_t>(nFft), plan->binBegin,
+                                                                plan->binEnd);
+
+    plan->silence = processFrame(Frame{}, std::vector<double>(static_cast<std::size_t>(plan->nFreqs), 0.0), *plan);
+    return plan;
+}
+
+void Feature::setPlan(std::shared_ptr<const FeaturePlan> plan)
+{
+    _plan = std::move(plan);
+}
+
 void Feature::setOptions(const FeatureOptions& options)
 {
     _options = options;
+    _plan.reset();
 }
 
 void Feature::setSampleRate(int sampleRate)
 {
     _options.sampleRate = sampleRate;
+    _plan.reset();
 }
 
 void Feature::setNumFilters(int numFilters)
 {
     _options.numFilters = numFilters;
+    _plan.reset();
 }
 
 void Feature::setNumCoeffs(int numCoeffs)
 {
     _options.numCoeffs = numCoeffs;
+    _plan.reset();
 }
 
 void Feature::setMinFreq(double minFreq)
 {
     _options.minFreq = minFreq;
+    _plan.reset();
 }
 
 void Feature::setMaxFreq(double maxFreq)
 {
     _options.maxFreq = maxFreq;
+    _plan.reset();
 }
 
 void Feature::setIncludeEnergy(bool includeEnergy)
 {
     _options.includeEnergy = includeEnergy;
+    _plan.reset();
 }
 
 void Feature::setFBankType(FilterbankType fBankType)
 {
     _options.filterbank = fBankType;
+    _plan.reset();
 }
 
 void Feature::setMelScale(MelScale melScale)
 {
     _options.melScale = melScale;
+    _plan.reset();
 }
 
 void Feature::setCepstralType(CepstralType cepstralType)
 {
     _cepstralType = cepstralType;
+    _plan.reset();
 }
 
 void Feature::setCompressionType(CompressionType compressionType)
 {
     _options.compressionType = compressionType;
+    _plan.reset();
+}
+
+void Feature::setCepstralTransform(CepstralTransform transform)
+{
+    _options.transform = transform;
+    _plan.reset();
 }
 
 void Feature::useDeltas(bool use)
@@ -105,44 +447,52 @@ void Feature::useDeltaDeltas(bool use)
     _useDelteDeltas = use;
 }
 
-void Feature::normalizeFrequencyRange()
+void Feature::setVoiceActivity(const VadOptions& vad)
 {
-    const double nyquist = static_cast<double>(_options.sampleRate) / 2.0;
-    _options.maxFreq = std::clamp(_options.maxFreq <= 0.0 ? nyquist : _options.maxFreq, 0.0, nyquist);
-    _options.minFreq = std::clamp(_options.minFreq, 0.0, _options.maxFreq);
-    if (_options.maxFreq <= _options.minFreq)
-        _options.maxFreq = _options.minFreq + 1.0;
+    _vad = vad;
 }
 
-void Feature::setupFbParams(const int nFft)
+void Feature::normalizeFrequencyRange(FeatureOptions& options)
 {
-    _fbParams.sampleRate = _options.sampleRate;
-    _fbParams.nFft = nFft;
-    _fbParams.numFilters = _options.numFilters;
-    _fbParams.minFreq = _options.minFreq;
-    _fbParams.maxFreq = _options.maxFreq;
+    const double nyquist = static_cast<double>(options.sampleRate) / 2.0;
+    options.maxFreq = std::clamp(options.maxFreq <= 0.0 ? nyquist : options.maxFreq, 0.0, nyquist);
+    options.minFreq = std::clamp(options.minFreq, 0.0, options.maxFreq);
+    if (options.maxFreq <= options.minFreq)
+        options.maxFreq = options.minFreq + 1.0;
 }
 
-std::vector<double> Feature::magnitude(const std::vector<std::complex<float>>& spec, int nFreqs)
+std::vector<double> Feature::magnitudeSpectrum(const std::vector<std::complex<float>>& spec, int nFreqs)
 {
     std::vector<double> mag(std::min(static_cast<int>(spec.size()), nFreqs));
     for (std::size_t i = 0; i < mag.size(); ++i)
     {
         mag[i] = std::abs(spec[i]);
     }
+    if (static_cast<int>(mag.size()) < nFreqs)
+        mag.resize(nFreqs, 0.0);
     return mag;
 }
 
-std::vector<double> Feature::applyFilterbank(const std::vector<std::vector<double>>& filters,
-                                             const std::vector<double>& mag)
+std::vector<double> Feature::magnitudeSpectrum(const std::vector<std::complex<float>>& spec, int nFreqs,
+                                               std::size_t binBegin, std::size_t binEnd)
 {
+    std::vector<double> mag(static_cast<std::size_t>(std::max(nFreqs, 0)), 0.0);
+    const std::size_t end = std::min({binEnd, mag.size(), spec.size()});
+    for (std::size_t k = binBegin; k < end; ++k)
+        mag[k] = std::abs(spec[k]);
+    return mag;
+}
+
+std::vector<double> Feature::applyFilterbank(const FeaturePlan& plan, const std::vector<double>& mag) const
+{
+    const auto& filters = plan.filters;
     std::vector<double> out(filters.size(), 0.0);
     for (std::size_t m = 0; m < filters.size(); ++m)
     {
         const auto& f = filters[m];
-        const std::size_t N = std::min(f.size(), mag.size());
+        const std::size_t N = std::min({f.size(), mag.size(), plan.binEnd});
         double sum = 0.0;
-        for (std::size_t k = 0; k < N; ++k)
+        for (std::size_t k = plan.binBegin; k < N; ++k)
         {
             sum += mag[k] * f[k];
         }
@@ -151,7 +501,7 @@ std::vector<double> Feature::applyFilterbank(const std::vector<std::vector<doubl
     return out;
 }
 
-void Feature::applyCompression(std::vector<double>& v, libvoicefeat::CompressionType type)
+void Feature::applyCompression(std::vector<double>& v, libvoicefeat::CompressionType type) const
 {
     using libvoicefeat::CompressionType;
 
@@ -164,24 +514,110 @@ void Feature::applyCompression(std::vector<double>& v, libvoicefeat::Compression
         cubeRoot(v);
         break;
     case CompressionType::PowerNormalized:
-        powerNormalized(v);
-        break;
+        // needs neighbouring frames; PnccStage applies it in finish()
+        throw std::logic_error("Power normalization is not a per-frame compression");
     default:
         throw std::runtime_error("Unknown compression type");
     }
 }
 
-void Feature::processFrame(const Frame& frame,
-                           const std::vector<std::complex<float>>& spec,
-                           const std::vector<std::vector<double>>& filters, const int nFreqs)
+libvoicefeat::FeatureVector Feature::processFrame(const Frame& frame,
+                                                 const std::vector<double>& mag,
+                                                 const FeaturePlan& plan) const
 {
-    auto mag = magnitude(spec, nFreqs);
-    if (static_cast<int>(mag.size()) < nFreqs)
-        mag.resize(nFreqs, 0.0);
+    std::vector<double> bands = bandEnergies(mag, plan);
 
-    auto bandEnergies = applyFilterbank(filters, mag);
-    applyCompression(bandEnergies, _options.compressionType);
+    // channel powers (and c0) for the cross-frame stage in finish()
+    if (isPowerNormalized())
+    {
+        FeatureVector row(bands.size() + (_options.includeEnergy ? 1 : 0));
+        for (std::size_t m = 0; m < bands.size(); ++m)
+            row[m] = static_cast<float>(bands[m]);
+        if (_options.includeEnergy)
+            row.back() = static_cast<float>(logEnergy(frame, plan));
+        return row;
+    }
+
+    applyCompression(bands, _options.compressionType);
+
+    FeatureVector coeffs = cepstra(bands, plan);
+    if (_options.includeEnergy && !coeffs.empty())
+    {
+        coeffs[0] = static_cast<float>(logEnergy(frame, plan));
+    }
+
+    return coeffs;
+}
+
+std::vector<double> Feature::bandEnergies(const std::vector<double>& mag, const FeaturePlan& plan) const
+{
+    // the autocorrelation (LPC) and PNCC's power normalization are defined on |X|^2
+    if (!plan.powerSpectrum)
+        return applyFilterbank(plan, mag);
+
+    std::vector<double> power(mag.size());
+    for (std::size_t k = plan.binBegin; k < std::min(plan.binEnd, mag.size()); ++k)
+        power[k] = mag[k] * mag[k];
+    return applyFilterbank(plan, power);
+}
+
+FrameStages Feature::computeStages(const Frame& frame, const ITransformer& transformer,
+                                   const StageSelection& stages) const
+{
+    if (!stages.powerSpectrum)
+        return stagesFromMagnitude(frame, frameMagnitude(frame, transformer), stages);
+    return stagesFromMagnitude(frame, magnitudeSpectrum(transformer.transform(frame.data), _plan->nFreqs), stages);
+}
+
+FrameStages Feature::silenceStages(const StageSelection& stages) const
+{
+    return stagesFromMagnitude(Frame{}, std::vector<double>(static_cast<std::size_t>(_plan->nFreqs), 0.0), stages);
+}
+
+FrameStages Feature::stagesFromMagnitude(const Frame& frame, const std::vector<double>& mag,
+                                         const StageSelection& stages) const
+{
+    const FeaturePlan& plan = *_plan;
+    FrameStages out;
+
+    if (stages.powerSpectrum)
+    {
+        out.power.resize(mag.size());
+        for (std::size_t k = 0; k < mag.size(); ++k)
+            out.power[k] = mag[k] * mag[k];
+    }
+    if (!stages.filterbankEnergies && !stages.compressedEnergies && !stages.cepstra)
+        return out;
 
+    auto bands = bandEnergies(mag, plan);
+    if (stages.cepstra && isPowerNormalized())
+    {
+        out.row.resize(bands.size() + (_options.includeEnergy ? 1 : 0));
+        for (std::size_t m = 0; m < bands.size(); ++m)
+            out.row[m] = static_cast<float>(bands[m]);
+        if (_options.includeEnergy)
+            out.row.back() = static_cast<float>(logEnergy(frame, plan));
+    }
+    // PNCC compresses the channel powers across frames, from the bands
+    if (stages.filterbankEnergies || (isPowerNormalized() && stages.compressedEnergies))
+        out.bands = bands;
+    if (isPowerNormalized() || (!stages.compressedEnergies && !stages.cepstra))
+        return out;
+
+    applyCompression(bands, _options.compressionType);
+    if (stages.compressedEnergies)
+        out.compressed = bands;
+    if (stages.cepstra)
+    {
+        out.row = cepstra(bands, plan);
+        if (_options.includeEnergy && !out.row.empty())
+            out.row[0] = static_cast<float>(logEnergy(frame, plan));
+    }
+    return out;
+}
+
+libvoicefeat::FeatureVector Feature::cepstra(const std::vector<double>& bands, const FeaturePlan& plan) const
+{
     std::vector<double> cepstraDouble;
 
     switch (_cepstralType)
@@ -190,11 +626,9 @@ void Feature::processFrame(const Frame& frame,
     case CepstralType::LFCC:
     case CepstralType::GFCC:
     case CepstralType::PNCC:
-        cepstraDouble = dctII(bandEnergies, _options.numCoeffs);
-        break;
-
     case CepstralType::PLP:
-        cepstraDouble = plpCepstraPlaceholder(bandEnergies, _options.numCoeffs);
+        cepstraDouble = plan.options.transform == CepstralTransform::LPC ? lpcCepstra(bands, plan)
+                                                                         : dctII(bands, plan.dct);
         break;
 
     default:
@@ -206,103 +640,157 @@ void Feature::processFrame(const Frame& frame,
     {
         coeffs[i] = static_cast<float>(cepstraDouble[i]);
     }
+    return coeffs;
+}
 
-    if (_options.includeEnergy && !coeffs.empty())
+double Feature::logEnergy(const Frame& frame, const FeaturePlan& plan)
+{
+    double energy = 0.0;
+    for (float s : frame.data)
     {
-        double energy = 0.0;
-        for (float s : frame.data)
-        {
-            const double v = s;
-            energy += v * v;
-        }
-        const double logEnergy = std::log(energy + constants::K_LOG_EPS);
-        coeffs[0] = static_cast<float>(logEnergy);
+        const double v = s;
+        energy += v * v;
     }
-
-    _computed.push_back(std::move(coeffs));
+    return std::log(energy * plan.energyScale + constants::K_LOG_EPS);
 }
 
-void Feature::log(std::vector<double>& v)
+void Feature::log(std::vector<double>& v) const
 {
     for (auto& x : v)
         x = std::log(x + constants::K_LOG_EPS);
 }
 
-void Feature::cubeRoot(std::vector<double>& v)
+void Feature::cubeRoot(std::vector<double>& v) const
 {
     for (auto& x : v)
         x = std::cbrt(std::max(x, 0.0));
 }
 
-void Feature::powerNormalized(std::vector<double>& v)
-{
-    meanPowerNormalization(v);
-
-    asymmetricNonlinear(v);
-
-    spectralFloor(v);
-}
-
-void Feature::meanPowerNormalization(std::vector<double>& v)
+std::vector<std::vector<double>> Feature::buildDctBasis(int numInputs, int numCoeffs)
 {
-    //    y(k) = x(k) / (mean(x) + eps)
-    double meanPower = 0.0;
-    for (double x : v)
-        meanPower += x;
-
-    meanPower /= std::max<size_t>(1, v.size());
-    if (meanPower < constants::K_LOG_EPS)
-        meanPower = constants::K_LOG_EPS;
-
-    for (auto& x : v)
-        x = x / meanPower;
+    const int N = numInputs;
+    const int K = std::max(1, std::min(numCoeffs, N));
+    std::vector<std::vector<double>> basis(K, std::vector<double>(std::max(0, N), 0.0));
+    for (int k = 0; k < K; ++k)
+    {
+        for (int n = 0; n < N; ++n)
+        {
+            const double angle = constants::PI * k * (2.0 * n + 1.0) / (2.0 * N);
+            basis[k][n] = std::cos(angle);
+        }
+    }
+    return basis;
 }
 
-void Feature::asymmetricNonlinear(std::vector<double>& v)
+std::vector<double> Feature::dctII(const std::vector<double>& v,
+                                   const std::vector<std::vector<double>>& basis) const
 {
-    //    PNCC uses: f(x) = log(1 + alpha * x)  (alpha ≈ 2-5)
-    constexpr double alpha = 5.0;
-
-    for (auto& x : v)
+    const std::size_t N = v.size();
+    std::vector<double> out(basis.size(), 0.0);
+    for (std::size_t k = 0; k < basis.size(); ++k)
     {
-        if (x < 0.0)
-            x = 0.0;
-        x = std::log(1.0 + alpha * x);
+        const auto& row = basis[k];
+        double sum = 0.0;
+        for (std::size_t n = 0; n < N && n < row.size(); ++n)
+        {
+            sum += v[n] * row[n];
+        }
+        out[k] = sum;
     }
+    return out;
 }
 
-void Feature::spectralFloor(std::vector<double>& v)
+std::vector<double> Feature::equalLoudness(const std::vector<std::vector<double>>& filters, int nFft, int sampleRate)
 {
-    constexpr double floorVal = -5.0;
-    for (auto& x : v)
+    std::vector<double> weights(filters.size(), 1.0);
+    const double binHz = static_cast<double>(sampleRate) / static_cast<double>(std::max(1, nFft));
+    for (std::size_t m = 0; m < filters.size(); ++m)
     {
-        if (x < floorVal)
-            x = floorVal;
+        // centre of the band as the weighted mean frequency of its bins
+        double sum = 0.0, moment = 0.0;
+        for (std::size_t k = 0; k < filters[m].size(); ++k)
+        {
+            sum += filters[m][k];
+            moment += filters[m][k] * static_cast<double>(k) * binHz;
+        }
+        if (sum <= 0.0)
+            continue;
+
+        const double w2 = std::pow(2.0 * constants::PI * moment / sum, 2.0);
+        weights[m] = (w2 + 56.8e6) * w2 * w2 / ((w2 + 6.3e6) * (w2 + 6.3e6) * (w2 + 0.38e9));
     }
+    return weights;
 }
 
-std::vector<double> Feature::dctII(const std::vector<double>& v, int numCoeffs)
+std::vector<std::vector<double>> Feature::buildIdftBasis(int numInputs, int order)
 {
-    const int N = static_cast<int>(v.size());
-    const int K = std::max(1, std::min(numCoeffs, N));
-    std::vector<double> out(K, 0.0);
-    for (int k = 0; k < K; ++k)
+    // The padded spectrum has numInputs + 2 points at angles pi * j / (numInputs + 1). A real symmetric
+    // IDFT weighs the two end points by 1/2; both are copies of the outer bands, which therefore carry
+    // their own weight plus half of the copy's.
+    const int N = std::max(0, numInputs);
+    const double step = constants::PI / static_cast<double>(N + 1);
+    std::vector<std::vector<double>> basis(order + 1, std::vector<double>(N, 0.0));
+    for (int lag = 0; lag <= order; ++lag)
     {
-        double sum = 0.0;
         for (int n = 0; n < N; ++n)
+            basis[lag][n] = 2.0 * std::cos(step * lag * (n + 1));
+        if (N > 0)
         {
-            const double angle = constants::PI * k * (2.0 * n + 1.0) / (2.0 * N);
-            sum += v[n] * std::cos(angle);
+            basis[lag][0] += 1.0;
+            basis[lag][N - 1] += std::cos(constants::PI * lag);
         }
-        out[k] = sum;
+        for (auto& weight : basis[lag])
+            weight /= 2.0 * (N + 1);
     }
-    return out;
+    return basis;
 }
 
-std::vector<double> Feature::plpCepstraPlaceholder(const std::vector<double>& barkEnergies, int numCoeffs)
+std::vector<double> Feature::lpcCepstra(const std::vector<double>& bands, const FeaturePlan& plan)
 {
-    // TODO: IMPLEMENT REAL PLP
-    return dctII(barkEnergies, numCoeffs);
+    const std::size_t numCoeffs = static_cast<std::size_t>(plan.options.numCoeffs);
+    const std::size_t order = plan.idft.size() - 1;
+
+    std::vector<double> r(order + 1, 0.0);
+    for (std::size_t lag = 0; lag <= order; ++lag)
+    {
+        const auto& row = plan.idft[lag];
+        double sum = 0.0;
+        for (std::size_t n = 0; n < bands.size() && n < row.size(); ++n)
+            sum += bands[n] * row[n];
+        r[lag] = sum;
+    }
+
+    // Levinson-Durbin: a[1..order] predict x[t] from x[t-1..t-order]; stops early once the error vanishes
+    // (silence, or a compression that leaves the autocorrelation indefinite)
+    std::vector<double> a(order + 1, 0.0), previous(order + 1, 0.0);
+    double error = r[0];
+    for (std::size_t i = 1; i <= order && error > constants::K_LOG_EPS; ++i)
+    {
+        double acc = r[i];
+        for (std::size_t j = 1; j < i; ++j)
+            acc -= a[j] * r[i - j];
+        const double k = acc / error;
+
+        previous = a;
+        a[i] = k;
+        for (std::size_t j = 1; j < i; ++j)
+            a[j] = previous[j] - k * previous[i - j];
+        error *= 1.0 - k * k;
+    }
+
+    // cepstrum of gain / (1 - sum a[k] z^-k)
+    std::vector<double> c(numCoeffs, 0.0);
+    if (numCoeffs == 0)
+        return c;
+    c[0] = std::log(std::max(error, 0.0) + constants::K_LOG_EPS);
+    for (std::size_t n = 1; n < numCoeffs; ++n)
+    {
+        double sum = n <= order ? a[n] : 0.0;
+        for (std::size_t k = n > order ? n - order : 1; k < n; ++k)
+            sum += static_cast<double>(k) / static_cast<double>(n) * c[k] * a[n - k];
+        c[n] = sum;
+    }
+    return c;
 }
 
 void Feature::applyPreEmphasis(std::vector<float>& samples, float coeff)
@@ -320,3 +808,59 @@ void Feature::applyPreEmphasis(std::vector<float>& samples, float coeff)
     }
     samples.swap(emphasized);
 }
+
+
+StreamingCepstra::StreamingCepstra(const Feature& feature)
+    : _feature(feature)
+{
+    if (!_feature._plan)
+        throw std::logic_error("Feature is not prepared");
+    if (_feature.isPowerNormalized())
+        _pncc = std::make_unique<PnccStage>(_feature._plan->filters.size());
+}
+
+StreamingCepstra::~StreamingCepstra() = default;
+
+void StreamingCepstra::push(FeatureVector row, FeatureMatrix& out)
+{
+    if (!_pncc)
+    {
+        out.push_back(std::move(row));
+        return;
+    }
+
+    const std::size_t channels = _pncc->getChannels();
+    if (row.size() > channels)
+        _energies.push_back(row[channels]);
+
+    std::vector<double> power(row.begin(), row.begin() + static_cast<std::ptrdiff_t>(std::min(row.size(), channels)));
+    power.resize(channels, 0.0);
+    std::vector<std::vector<double>> done;
+    _pncc->push(power, done);
+    emit(done, out);
+}
+
+void StreamingCepstra::finish(FeatureMatrix& out)
+{
+    if (!_pncc)
+        return;
+
+    std::vector<std::vector<double>> done;
+    _pncc->finish(done);
+    emit(done, out);
+}
+
+void StreamingCepstra::emit(std::vector<std::vector<double>>& channels, FeatureMatrix& out)
+{
+    for (const auto& frame : channels)
+    {
+        auto coeffs = _feature.cepstra(frame, *_feature._plan);
+        if (_feature._options.includeEnergy && !_energies.empty())
+        {
+            if (!coeffs.empty())
+                coeffs[0] = _energies.front();
+            _energies.pop_front();
+        }
+        out.push_back(std::move(coeffs));
+    }
+}
@@ -70,6 +70,12 @@ FeatureBuilder FeatureBuilder::setCompressionType(const CompressionType& compres
     return *this;
 }
 
+FeatureBuilder FeatureBuilder::setCepstralTransform(const CepstralTransform& transform)
+{
+    _feature.setCepstralTransform(transform);
+    return *this;
+}
+
 FeatureBuilder FeatureBuilder::useDeltas(bool use)
 {
     _feature.useDeltas(use);
@@ -82,6 +88,12 @@ FeatureBuilder FeatureBuilder::useDeltaDeltas(bool use)
     return *this;
 }
 
+FeatureBuilder FeatureBuilder::setVoiceActivity(const VadOptions& vad)
+{
+    _feature.setVoiceActivity(vad);
+    return *this;
+}
+
 Feature FeatureBuilder::build() const
 {
     return _feature;
@@ -102,6 +114,7 @@ Feature FeatureDirector::createDefaultMfccFeature(const CepstralConfig& cfg)
             .setIncludeEnergy(cfg.feature.includeEnergy)
             .useDeltas(cfg.delta.useDeltas)
             .useDeltaDeltas(cfg.delta.useDeltaDeltas)
+            .setVoiceActivity(cfg.vad)
             .build();
 }
 
@@ -119,6 +132,7 @@ Feature FeatureDirector::createDefaultGfccFeature(const CepstralConfig& cfg)
             .setIncludeEnergy(cfg.feature.includeEnergy)
             .useDeltas(cfg.delta.useDeltas)
             .useDeltaDeltas(cfg.delta.useDeltaDeltas)
+            .setVoiceActivity(cfg.vad)
             .build();
 }
 
@@ -136,6 +150,7 @@ Feature FeatureDirector::createDefaultLfccFeature(const CepstralConfig& cfg)
             .setIncludeEnergy(cfg.feature.includeEnergy)
             .useDeltas(cfg.delta.useDeltas)
             .useDeltaDeltas(cfg.delta.useDeltaDeltas)
+            .setVoiceActivity(cfg.vad)
             .build();
 }
 
@@ -143,8 +158,7 @@ Feature FeatureDirector::createDefaultPnccFeature(const CepstralConfig& cfg)
 {
     return FeatureBuilder{}
             .setCepstralType(CepstralType::PNCC)
-            .setFBankType(FilterbankType::Mel)
-            .setMelScale(MelScale::Slaney)
+            .setFBankType(FilterbankType::Gammatone)
             .setSampleRate(cfg.feature.sampleRate)
             .setNumFilters(constants::DEFAULT_PNCC_FILTERS_NUM)
             .setNumCoeffs(constants::DEFAULT_PNCC_COEFFS_NUM)
@@ -154,6 +168,7 @@ Feature FeatureDirector::createDefaultPnccFeature(const CepstralConfig& cfg)
             .setIncludeEnergy(cfg.feature.includeEnergy)
             .useDeltas(cfg.delta.useDeltas)
             .useDeltaDeltas(cfg.delta.useDeltaDeltas)
+            .setVoiceActivity(cfg.vad)
             .build();
 }
 
@@ -168,9 +183,11 @@ Feature FeatureDirector::createDefaultPlpFeature(const CepstralConfig& cfg)
             .setMinFreq(constants::DEFAULT_PLP_MIN_FREQ)
             .setMaxFreq(cfg.feature.maxFreq)
             .setCompressionType(CompressionType::CubeRoot)
+            .setCepstralTransform(CepstralTransform::LPC)
             .setIncludeEnergy(cfg.feature.includeEnergy)
             .useDeltas(cfg.delta.useDeltas)
             .useDeltaDeltas(cfg.delta.useDeltaDeltas)
+            .setVoiceActivity(cfg.vad)
             .build();
 }
 
@@ -1,7 +1,6 @@
 #include "libvoicefeat/features/filterbanks/gammatone_filterbank.h"
 
-#include "libvoicefeat/features/filterbanks/filterbank_utils.h"
-
+#include <algorithm>
 #include <cmath>
 
 namespace
@@ -15,6 +14,16 @@ namespace
     {
         return (std::pow(10.0, erb / 21.4) - 1.0) / 4.37e-3;
     }
+
+    // Glasberg & Moore equivalent rectangular bandwidth at hz.
+    double erbWidth(double hz)
+    {
+        return 24.7 * (4.37e-3 * hz + 1.0);
+    }
+
+    constexpr int kOrder = 4;
+    constexpr double kBandwidthScale = 1.019;   // b = 1.019 ERB for a 4th-order filter
+    constexpr double kMinWeight = 1e-4;         // tails below this are cut (about 10 b from the centre)
 }
 
 namespace libvoicefeat::features
@@ -35,12 +44,28 @@ namespace libvoicefeat::features
             erbPoints[i] = erbMin + (erbMax - erbMin) * i / (params.numFilters + 1);
         }
 
-        std::vector<double> hzPoints(erbPoints.size(), 0.0);
-        for (std::size_t i = 0; i < erbPoints.size(); ++i)
+        // Magnitude response of a cascade of kOrder complex one-pole sections at fc with bandwidth b, i.e. the
+        // gammatone t^(n-1) e^(-2 pi b t) cos(2 pi fc t) without its negative-frequency image, normalized
+        // to 1 at fc: |H(f)| = (1 + ((f - fc) / b)^2)^(-n/2). Zero outside [minFreq, maxFreq].
+        const int nFreqs = params.nFft / 2 + 1;
+        const double binHz = static_cast<double>(params.sampleRate) / static_cast<double>(std::max(1, params.nFft));
+        std::vector<std::vector<double>> filters(params.numFilters, std::vector<double>(std::max(0, nFreqs), 0.0));
+        for (int m = 0; m < params.numFilters; ++m)
         {
-            hzPoints[i] = erbToHz(erbPoints[i]);
-        }
+            const double centre = erbToHz(erbPoints[m + 1]);
+            const double bandwidth = kBandwidthScale * erbWidth(centre);
+            for (int k = 0; k < nFreqs; ++k)
+            {
+                const double hz = k * binHz;
+                if (hz < params.minFreq || hz > params.maxFreq)
+                    continue;
 
-        return detail::buildTriangularFilters(params, hzPoints);
+                const double x = (hz - centre) / bandwidth;
+                const double weight = std::pow(1.0 + x * x, -kOrder / 2.0);
+                if (weight >= kMinWeight)
+                    filters[m][k] = weight;
+            }
+        }
+        return filters;
     }
 }
\ No newline at end of file
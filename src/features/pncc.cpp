@@ -0,0 +1,127 @@
+#include "libvoicefeat/features/pncc.h"
+
+#include "libvoicefeat/utils/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace libvoicefeat::features
+{
+    namespace
+    {
+        // parameter values from the paper
+        constexpr double kRise = 0.999;             // lambda_a: asymmetric filter, input above the output
+        constexpr double kFall = 0.5;               // lambda_b: input below the output
+        constexpr double kInitialLevel = 0.9;       // both asymmetric filters start at 0.9 x their first input
+        constexpr double kMaskDecay = 0.85;         // lambda_t: temporal masking peak decay per frame
+        constexpr double kMaskFloor = 0.2;          // mu_t: masked frames keep this fraction of the peak
+        constexpr double kExcitation = 2.0;         // c: excited when Q >= c x the lower envelope
+        constexpr std::size_t kWeightChannels = 4;  // N: channels on each side for weight smoothing
+        constexpr double kMeanForget = 0.999;       // lambda_mu: running mean power
+        constexpr double kPowerLaw = 1.0 / 15.0;
+
+        double asymmetricLowPass(double previous, double input)
+        {
+            const double lambda = input >= previous ? kRise : kFall;
+            return lambda * previous + (1.0 - lambda) * input;
+        }
+    }
+
+    PnccStage::PnccStage(std::size_t channels)
+        : _channels(channels),
+          _window(2 * kMediumWindow + 1, std::vector<double>(channels, 0.0)),
+          _lowerEnvelope(channels, 0.0),
+          _floor(channels, 0.0),
+          _peak(channels, 0.0),
+          _medium(channels, 0.0),
+          _processed(channels, 0.0)
+    {
+        if (channels == 0)
+            throw std::invalid_argument("PNCC needs at least one channel");
+    }
+
+    void PnccStage::push(const std::vector<double>& power, std::vector<std::vector<double>>& out)
+    {
+        if (power.size() != _channels)
+            throw std::invalid_argument("PNCC frame has " + std::to_string(power.size()) + " channels, expected " +
+                                        std::to_string(_channels));
+
+        _window[_pushed % _window.size()] = power;
+        ++_pushed;
+
+        while (_next + kMediumWindow < _pushed)
+            emit(_pushed - 1, out);
+    }
+
+    void PnccStage::finish(std::vector<std::vector<double>>& out)
+    {
+        while (_next < _pushed)
+            emit(_pushed - 1, out);
+    }
+
+    void PnccStage::emit(std::size_t last, std::vector<std::vector<double>>& out)
+    {
+        const std::size_t l = _next++;
+        const std::size_t first = l - std::min(l, kMediumWindow);
+        const std::size_t end = std::min(l + kMediumWindow, last) + 1;
+        const double count = static_cast<double>(end - first);
+
+        for (std::size_t m = 0; m < _channels; ++m)
+        {
+            double sum = 0.0;
+            for (std::size_t j = first; j < end; ++j)
+                sum += _window[j % _window.size()][m];
+            _medium[m] = sum / count;
+        }
+
+        for (std::size_t m = 0; m < _channels; ++m)
+        {
+            const double q = _medium[m];
+            _lowerEnvelope[m] = _started ? asymmetricLowPass(_lowerEnvelope[m], q) : kInitialLevel * q;
+
+            const double rectified = std::max(q - _lowerEnvelope[m], 0.0);
+            _floor[m] = _started ? asymmetricLowPass(_floor[m], rectified) : kInitialLevel * rectified;
+
+            double masked = rectified;
+            if (_started)
+            {
+                const double decayed = kMaskDecay * _peak[m];
+                if (rectified < decayed)
+                    masked = kMaskFloor * _peak[m];
+                _peak[m] = std::max(decayed, rectified);
+            }
+            else
+            {
+                _peak[m] = rectified;
+            }
+
+            const double processed = q >= kExcitation * _lowerEnvelope[m] ? std::max(masked, _floor[m]) : _floor[m];
+            _processed[m] = processed / std::max(q, constants::K_LOG_EPS);
+        }
+
+        const auto& power = _window[l % _window.size()];
+        std::vector<double> row(_channels);
+        double total = 0.0;
+        for (std::size_t m = 0; m < _channels; ++m)
+        {
+            const std::size_t lo = m - std::min(m, kWeightChannels);
+            const std::size_t hi = std::min(m + kWeightChannels, _channels - 1);
+            double weight = 0.0;
+            for (std::size_t k = lo; k <= hi; ++k)
+                weight += _processed[k];
+            row[m] = power[m] * weight / static_cast<double>(hi - lo + 1);
+            total += row[m];
+        }
+
+        total /= static_cast<double>(_channels);
+        _meanPower = _started ? kMeanForget * _meanPower + (1.0 - kMeanForget) * total : total;
+        _started = true;
+
+        const double norm = std::max(_meanPower, constants::K_LOG_EPS);
+        for (auto& value : row)
+            value = std::pow(value / norm, kPowerLaw);
+        out.push_back(std::move(row));
+    }
+}
@@ -0,0 +1,188 @@
+#include "libvoicefeat/features/quantization.h"
+
+#include "libvoicefeat/utils/float16.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace libvoicefeat::features
+{
+    namespace
+    {
+        template <typename Q>
+        void quantizeAffine(const FeatureMatrix& matrix, QuantizedMatrix& out)
+        {
+            constexpr double lowest = std::numeric_limits<Q>::lowest();
+            constexpr double levels = static_cast<double>(std::numeric_limits<Q>::max()) - lowest;
+
+            std::vector<double> lo(out.cols, std::numeric_limits<double>::infinity());
+            std::vector<double> hi(out.cols, -std::numeric_limits<double>::infinity());
+            for (const auto& row : matrix)
+            {
+                for (std::size_t c = 0; c < out.cols; ++c)
+                {
+                    lo[c] = std::min(lo[c], static_cast<double>(row[c]));
+                    hi[c] = std::max(hi[c], static_cast<double>(row[c]));
+                }
+            }
+
+            // q = lowest maps to the column minimum, q = max to the maximum
+            std::vector<double> scale(out.cols), offset(out.cols);
+            out.scale.resize(out.cols);
+            out.offset.resize(out.cols);
+            for (std::size_t c = 0; c < out.cols; ++c)
+            {
+                const double range = hi[c] - lo[c];
+                if (!std::isfinite(range))
+                    throw std::invalid_argument("Cannot quantize non-finite feature values");
+
+                out.scale[c] = range > 0.0 ? static_cast<float>(range / levels) : 1.0f;
+                out.offset[c] = static_cast<float>(lo[c] - lowest * out.scale[c]);
+                // quantize against the stored float parameters, so dequantizing sees the same grid
+                scale[c] = out.scale[c];
+                offset[c] = out.offset[c];
+            }
+
+            auto* bytes = out.data.data();
+            for (const auto& row : matrix)
+            {
+                for (std::size_t c = 0; c < out.cols; ++c)
+                {
+                    const double level = std::nearbyint((static_cast<double>(row[c]) - offset[c]) / scale[c]);
+                    const auto q = static_cast<Q>(std::clamp(level, lowest, lowest + levels));
+                    std::memcpy(bytes, &q, sizeof(q));
+                    bytes += sizeof(q);
+                }
+            }
+        }
+
+        template <typename Q>
+        void dequantizeAffine(const QuantizedMatrix& matrix, std::size_t row, float* out)
+        {
+            const auto* bytes = matrix.data.data() + row * matrix.cols * sizeof(Q);
+            for (std::size_t c = 0; c < matrix.cols; ++c)
+            {
+                Q q;
+                std::memcpy(&q, bytes + c * sizeof(Q), sizeof(Q));
+                out[c] = matrix.offset[c] + matrix.scale[c] * static_cast<float>(q);
+            }
+        }
+    }
+
+    std::size_t bytesPerElement(QuantizationType type)
+    {
+        switch (type)
+        {
+        case QuantizationType::Int8: return 1;
+        case QuantizationType::Float16:
+        case QuantizationType::Int16:
+            return 2;
+        }
+        throw std::invalid_argument("Unknown quantization type");
+    }
+
+    float QuantizedMatrix::at(std::size_t row, std::size_t col) const
+    {
+        if (row >= rows || col >= cols)
+            throw std::out_of_range("QuantizedMatrix index out of range");
+
+        const std::size_t index = row * cols + col;
+        switch (type)
+        {
+        case QuantizationType::Float16:
+        {
+            std::uint16_t half;
+            std::memcpy(&half, data.data() + index * sizeof(half), sizeof(half));
+            return utils::halfToFloat(half);
+        }
+        case QuantizationType::Int8:
+            return offset[col] + scale[col] * static_cast<float>(static_cast<std::int8_t>(data[index]));
+        case QuantizationType::Int16:
+        {
+            std::int16_t q;
+            std::memcpy(&q, data.data() + index * sizeof(q), sizeof(q));
+            return offset[col] + scale[col] * static_cast<float>(q);
+        }
+        }
+        throw std::invalid_argument("Unknown quantization type");
+    }
+
+    void QuantizedMatrix::dequantizeRow(std::size_t row, float* out) const
+    {
+        if (row >= rows)
+            throw std::out_of_range("QuantizedMatrix row out of range");
+
+        switch (type)
+        {
+        case QuantizationType::Float16:
+        {
+            const auto* bytes = data.data() + row * cols * sizeof(std::uint16_t);
+            for (std::size_t c = 0; c < cols; ++c)
+            {
+                std::uint16_t half;
+                std::memcpy(&half, bytes + c * sizeof(half), sizeof(half));
+                out[c] = utils::halfToFloat(half);
+            }
+            break;
+        }
+        case QuantizationType::Int8:
+            dequantizeAffine<std::int8_t>(*this, row, out);
+            break;
+        case QuantizationType::Int16:
+            dequantizeAffine<std::int16_t>(*this, row, out);
+            break;
+        }
+    }
+
+    FeatureMatrix QuantizedMatrix::dequantize() const
+    {
+        FeatureMatrix matrix(rows, FeatureVector(cols));
+        for (std::size_t r = 0; r < rows; ++r)
+            dequantizeRow(r, matrix[r].data());
+        return matrix;
+    }
+
+    QuantizedMatrix quantize(const FeatureMatrix& matrix, QuantizationType type)
+    {
+        QuantizedMatrix out;
+        out.type = type;
+        out.rows = matrix.size();
+        out.cols = matrix.empty() ? 0 : matrix.front().size();
+        for (const auto& row : matrix)
+        {
+            if (row.size() != out.cols)
+                throw std::invalid_argument("Cannot quantize a ragged matrix");
+        }
+        out.data.resize(out.rows * out.cols * bytesPerElement(type));
+        if (out.rows == 0)
+            return out;
+
+        switch (type)
+        {
+        case QuantizationType::Float16:
+        {
+            auto* half = out.data.data();
+            for (const auto& row : matrix)
+            {
+                for (float value : row)
+                {
+                    const std::uint16_t bits = utils::floatToHalf(value);
+                    std::memcpy(half, &bits, sizeof(bits));
+                    half += sizeof(bits);
+                }
+            }
+            break;
+        }
+        case QuantizationType::Int8:
+            quantizeAffine<std::int8_t>(matrix, out);
+            break;
+        case QuantizationType::Int16:
+            quantizeAffine<std::int16_t>(matrix, out);
+            break;
+        }
+        return out;
+    }
+}
@@ -0,0 +1,578 @@
+#include "libvoicefeat/io/feature_archive.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace libvoicefeat::io
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'L', 'V', 'F', 'A'};
+        constexpr char kIndexMagic[8] = {'L', 'V', 'F', 'A', 'I', 'D', 'X', '\0'};
+        constexpr std::uint32_t kVersion = 1;
+        constexpr std::size_t kHeaderBytes = 16;
+        constexpr std::size_t kTrailerBytes = 16;       // index offset + index magic
+        constexpr std::size_t kChunkRecordBytes = 13;   // offset u64, size u32, codec u8
+
+        constexpr std::uint8_t kCodecRaw = 0;
+        constexpr std::uint8_t kCodecDeltaShuffleHuffman = 1;
+
+        // How one byte plane of a chunk is stored.
+        constexpr std::uint8_t kPlaneRaw = 0;
+        constexpr std::uint8_t kPlaneConstant = 1;
+        constexpr std::uint8_t kPlaneHuffman = 2;
+
+        constexpr int kMaxCodeLength = 12;              // decode table of 4096 entries
+        constexpr std::size_t kLengthTableBytes = 128;  // 256 code lengths, one nibble each
+
+        // Code lengths of a Huffman code for the byte frequencies, limited to kMaxCodeLength by halving the
+        // counts until the tree is shallow enough.
+        std::array<std::uint8_t, 256> codeLengths(std::array<std::uint64_t, 256> counts)
+        {
+            while (true)
+            {
+                struct Node
+                {
+                    std::uint64_t weight;
+                    int index;
+                };
+                const auto heavier = [](const Node& a, const Node& b) { return a.weight > b.weight; };
+
+                std::vector<Node> heap;
+                std::vector<int> parent;
+                for (int symbol = 0; symbol < 256; ++symbol)
+                {
+                    if (counts[symbol] != 0)
+                        heap.push_back({counts[symbol], symbol});
+                }
+                parent.assign(256 + heap.size(), -1);
+                std::make_heap(heap.begin(), heap.end(), heavier);
+
+                int next = 256;
+                while (heap.size() > 1)
+                {
+                    std::pop_heap(heap.begin(), heap.end(), heavier);
+                    const Node a = heap.back();
+                    heap.pop_back();
+                    std::pop_heap(heap.begin(), heap.end(), heavier);
+                    const Node b = heap.back();
+                    heap.pop_back();
+
+                    parent[a.index] = next;
+                    parent[b.index] = next;
+                    heap.push_back({a.weight + b.weight, next++});
+                    std::push_heap(heap.begin(), heap.end(), heavier);
+                }
+
+                std::array<std::uint8_t, 256> lengths{};
+                int longest = 0;
+                for (int symbol = 0; symbol < 256; ++symbol)
+                {
+                    if (counts[symbol] == 0)
+                        continue;
+                    int length = 0;
+                    for (int node = symbol; parent[node] != -1; node = parent[node])
+                        ++length;
+                    lengths[symbol] = static_cast<std::uint8_t>(std::max(length, 1));
+                    longest = std::max(longest, length);
+                }
+                if (longest <= kMaxCodeLength)
+                    return lengths;
+
+                for (auto& count : counts)
+                {
+                    if (count != 0)
+                        count = (count + 1) / 2;
+                }
+            }
+        }
+
+        // Canonical codes: shorter codes first, ties by symbol.
+        std::array<std::uint16_t, 256> canonicalCodes(const std::array<std::uint8_t, 256>& lengths)
+        {
+            std::array<std::uint16_t, 256> codes{};
+            std::uint32_t code = 0;
+            for (int length = 1; length <= kMaxCodeLength; ++length)
+            {
+                for (int symbol = 0; symbol < 256; ++symbol)
+                {
+                    if (lengths[symbol] == length)
+                        codes[symbol] = static_cast<std::uint16_t>(code++);
+                }
+                code <<= 1;
+            }
+            return codes;
+        }
+
+        void encodePlane(const unsigned char* plane, std::size_t size, std::vector<unsigned char>& out)
+        {
+            std::array<std::uint64_t, 256> counts{};
+            for (std::size_t i = 0; i < size; ++i)
+                ++counts[plane[i]];
+
+            if (counts[plane[0]] == size)
+            {
+                out.push_back(kPlaneConstant);
+                out.push_back(plane[0]);
+                return;
+            }
+
+            const auto lengths = codeLengths(counts);
+            std::uint64_t bits = 0;
+            for (int symbol = 0; symbol < 256; ++symbol)
+                bits += counts[symbol] * lengths[symbol];
+            const std::size_t codedBytes = static_cast<std::size_t>((bits + 7) / 8);
+            if (kLengthTableBytes + sizeof(std::uint32_t) + codedBytes >= size)
+            {
+                out.push_back(kPlaneRaw);
+                out.insert(out.end(), plane, plane + size);
+                return;
+            }
+
+            out.push_back(kPlaneHuffman);
+            for (int symbol = 0; symbol < 256; symbol += 2)
+                out.push_back(static_cast<unsigned char>(lengths[symbol] << 4 | lengths[symbol + 1]));
+            const auto byteCount = static_cast<std::uint32_t>(codedBytes);
+            const auto* countBytes = reinterpret_cast<const unsigned char*>(&byteCount);
+            out.insert(out.end(), countBytes, countBytes + sizeof(byteCount));
+
+            const auto codes = canonicalCodes(lengths);
+            std::uint64_t buffer = 0;
+            int buffered = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                buffer = buffer << lengths[plane[i]] | codes[plane[i]];
+                buffered += lengths[plane[i]];
+                while (buffered >= 8)
+                {
+                    buffered -= 8;
+                    out.push_back(static_cast<unsigned char>(buffer >> buffered));
+                }
+            }
+            if (buffered > 0)
+                out.push_back(static_cast<unsigned char>(buffer << (8 - buffered)));
+        }
+
+        // Decodes one plane of size bytes starting at cursor; returns the first byte after it.
+        const unsigned char* decodePlane(const unsigned char* cursor, const unsigned char* end, unsigned char* plane,
+                                         std::size_t size)
+        {
+            const auto corrupt = []() { return std::runtime_error("Corrupt feature archive chunk"); };
+            if (cursor >= end)
+                throw corrupt();
+
+            const std::uint8_t mode = *cursor++;
+            if (mode == kPlaneConstant)
+            {
+                if (cursor >= end)
+                    throw corrupt();
+                std::memset(plane, *cursor, size);
+                return cursor + 1;
+            }
+            if (mode == kPlaneRaw)
+            {
+                if (static_cast<std::size_t>(end - cursor) < size)
+                    throw corrupt();
+                std::memcpy(plane, cursor, size);
+                return cursor + size;
+            }
+            if (mode != kPlaneHuffman || static_cast<std::size_t>(end - cursor) < kLengthTableBytes + sizeof(std::uint32_t))
+                throw corrupt();
+
+            std::array<std::uint8_t, 256> lengths{};
+            for (int symbol = 0; symbol < 256; symbol += 2)
+            {
+                lengths[symbol] = static_cast<std::uint8_t>(cursor[symbol / 2] >> 4);
+                lengths[symbol + 1] = static_cast<std::uint8_t>(cursor[symbol / 2] & 0x0f);
+            }
+            cursor += kLengthTableBytes;
+            std::uint32_t codedBytes;
+            std::memcpy(&codedBytes, cursor, sizeof(codedBytes));
+            cursor += sizeof(codedBytes);
+            if (static_cast<std::size_t>(end - cursor) < codedBytes)
+                throw corrupt();
+
+            // every kMaxCodeLength-bit prefix maps to its symbol and code length
+            struct Slot
+            {
+                std::uint8_t symbol = 0;
+                std::uint8_t length = 0;
+            };
+            std::array<Slot, 1u << kMaxCodeLength> table{};
+            const auto codes = canonicalCodes(lengths);
+            for (int symbol = 0; symbol < 256; ++symbol)
+            {
+                const int length = lengths[symbol];
+                if (length == 0)
+                    continue;
+                if (length > kMaxCodeLength)
+                    throw corrupt();
+                const std::size_t first = static_cast<std::size_t>(codes[symbol]) << (kMaxCodeLength - length);
+                const std::size_t span = std::size_t{1} << (kMaxCodeLength - length);
+                if (first + span > table.size())
+                    throw corrupt();
+                for (std::size_t j = first; j < first + span; ++j)
+                    table[j] = Slot{static_cast<std::uint8_t>(symbol), static_cast<std::uint8_t>(length)};
+            }
+
+            const unsigned char* bits = cursor;
+            std::uint64_t buffer = 0;
+            int buffered = 0;
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                while (buffered < kMaxCodeLength)
+                {
+                    buffer = buffer << 8 | (next < codedBytes ? bits[next] : 0u);
+                    ++next;
+                    buffered += 8;
+                }
+                const auto& slot = table[(buffer >> (buffered - kMaxCodeLength)) & ((1u << kMaxCodeLength) - 1)];
+                if (slot.length == 0)
+                    throw corrupt();
+                plane[i] = slot.symbol;
+                buffered -= slot.length;
+            }
+            if (next - static_cast<std::size_t>(buffered / 8) > codedBytes)
+                throw corrupt();
+            return cursor + codedBytes;
+        }
+
+        // Each value's bits minus those of the same column one frame earlier, split into byte planes, most
+        // significant first.
+        void shuffle(const float* frames, std::size_t count, std::size_t cols, std::vector<unsigned char>& planes)
+        {
+            const std::size_t words = count * cols;
+            planes.resize(words * sizeof(std::uint32_t));
+            for (std::size_t i = 0; i < words; ++i)
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, frames + i, sizeof(bits));
+                if (i >= cols)
+                {
+                    std::uint32_t previous;
+                    std::memcpy(&previous, frames + i - cols, sizeof(previous));
+                    bits -= previous;
+                }
+                for (std::size_t b = 0; b < sizeof(bits); ++b)
+                    planes[b * words + i] = static_cast<unsigned char>(bits >> (8 * (sizeof(bits) - 1 - b)));
+            }
+        }
+
+        void unshuffle(const unsigned char* planes, std::size_t count, std::size_t cols, float* frames)
+        {
+            const std::size_t words = count * cols;
+            for (std::size_t i = 0; i < words; ++i)
+            {
+                std::uint32_t bits = 0;
+                for (std::size_t b = 0; b < sizeof(bits); ++b)
+                    bits |= static_cast<std::uint32_t>(planes[b * words + i]) << (8 * (sizeof(bits) - 1 - b));
+                if (i >= cols)
+                {
+                    std::uint32_t previous;
+                    std::memcpy(&previous, frames + i - cols, sizeof(previous));
+                    bits += previous;
+                }
+                std::memcpy(frames + i, &bits, sizeof(bits));
+            }
+        }
+
+        template <typename T>
+        void put(std::vector<unsigned char>& out, T value)
+        {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        T take(const unsigned char*& cursor, const unsigned char* end)
+        {
+            if (static_cast<std::size_t>(end - cursor) < sizeof(T))
+                throw std::runtime_error("Truncated feature archive index");
+            T value;
+            std::memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return value;
+        }
+    }
+
+    FeatureArchiveWriter::FeatureArchiveWriter(const std::filesystem::path& path, std::size_t chunkFrames)
+        : _name(path.string()),
+          _chunkFrames(chunkFrames)
+    {
+        if (chunkFrames == 0 || chunkFrames > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("chunkFrames must be positive");
+
+        _out.open(path, std::ios::binary | std::ios::trunc);
+        if (!_out)
+            throw std::runtime_error("Cannot open feature archive for writing: " + _name);
+
+        std::vector<unsigned char> header(kMagic, kMagic + sizeof(kMagic));
+        put(header, kVersion);
+        put(header, static_cast<std::uint32_t>(chunkFrames));
+        put(header, std::uint32_t{0});
+        _out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        _offset = header.size();
+    }
+
+    FeatureArchiveWriter::~FeatureArchiveWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void FeatureArchiveWriter::write(const std::string& key, const FeatureMatrix& matrix)
+    {
+        const std::size_t rows = matrix.size();
+        const std::size_t cols = rows == 0 ? 0 : matrix.front().size();
+        for (const auto& row : matrix)
+        {
+            if (row.size() != cols)
+                throw std::invalid_argument("Ragged feature matrix for key: " + key);
+        }
+
+        std::vector<float> contiguous;
+        contiguous.reserve(rows * cols);
+        for (const auto& row : matrix)
+            contiguous.insert(contiguous.end(), row.begin(), row.end());
+        write(key, contiguous.data(), rows, cols);
+    }
+
+    void FeatureArchiveWriter::write(const std::string& key, const float* data, std::size_t rows, std::size_t cols)
+    {
+        if (!_out.is_open())
+            throw std::runtime_error("Feature archive is closed: " + _name);
+        if (key.empty() || key.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("Invalid feature archive key");
+        if (_keys.count(key) != 0)
+            throw std::invalid_argument("Duplicate feature archive key: " + key);
+        if (data == nullptr && rows * cols != 0)
+            throw std::invalid_argument("data is null");
+        if (cols > std::numeric_limits<std::uint32_t>::max() ||
+            _chunkFrames * cols * sizeof(float) > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("Matrix too wide for a feature archive: " + key);
+
+        Entry entry;
+        entry.key = key;
+        entry.rows = rows;
+        entry.cols = static_cast<std::uint32_t>(cols);
+        if (cols != 0)
+        {
+            for (std::size_t first = 0; first < rows; first += _chunkFrames)
+                writeChunk(data + first * cols, std::min(_chunkFrames, rows - first), cols, entry);
+        }
+
+        if (!_out)
+            throw std::runtime_error("Failed writing feature archive: " + _name);
+
+        _keys.insert(key);
+        _entries.push_back(std::move(entry));
+    }
+
+    void FeatureArchiveWriter::writeChunk(const float* frames, std::size_t count, std::size_t cols, Entry& entry)
+    {
+        const std::size_t rawBytes = count * cols * sizeof(float);
+        std::vector<unsigned char> planes;
+        shuffle(frames, count, cols, planes);
+        _scratch.clear();
+        const std::size_t planeBytes = count * cols;
+        for (std::size_t b = 0; b < sizeof(float); ++b)
+            encodePlane(planes.data() + b * planeBytes, planeBytes, _scratch);
+
+        Chunk chunk;
+        chunk.offset = _offset;
+        if (_scratch.size() < rawBytes)
+        {
+            chunk.codec = kCodecDeltaShuffleHuffman;
+            chunk.size = static_cast<std::uint32_t>(_scratch.size());
+            _out.write(reinterpret_cast<const char*>(_scratch.data()), static_cast<std::streamsize>(_scratch.size()));
+        }
+        else
+        {
+            chunk.codec = kCodecRaw;
+            chunk.size = static_cast<std::uint32_t>(rawBytes);
+            _out.write(reinterpret_cast<const char*>(frames), static_cast<std::streamsize>(rawBytes));
+        }
+
+        _offset += chunk.size;
+        _rawBytes += rawBytes;
+        _storedBytes += chunk.size;
+        entry.chunks.push_back(chunk);
+    }
+
+    void FeatureArchiveWriter::close()
+    {
+        if (!_out.is_open())
+            return;
+
+        std::vector<unsigned char> index;
+        put(index, static_cast<std::uint32_t>(_entries.size()));
+        for (const auto& entry : _entries)
+        {
+            put(index, static_cast<std::uint32_t>(entry.key.size()));
+            index.insert(index.end(), entry.key.begin(), entry.key.end());
+            put(index, entry.rows);
+            put(index, entry.cols);
+            put(index, static_cast<std::uint32_t>(entry.chunks.size()));
+            for (const auto& chunk : entry.chunks)
+            {
+                put(index, chunk.offset);
+                put(index, chunk.size);
+                put(index, chunk.codec);
+            }
+        }
+        put(index, _offset);
+        index.insert(index.end(), kIndexMagic, kIndexMagic + sizeof(kIndexMagic));
+
+        _out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+        _out.close();
+        if (!_out)
+            throw std::runtime_error("Failed closing feature archive: " + _name);
+    }
+
+    FeatureArchiveReader::FeatureArchiveReader(const std::filesystem::path& path)
+        : _file(path)
+    {
+        const unsigned char* begin = _file.data();
+        const std::size_t size = _file.size();
+        if (size < kHeaderBytes + kTrailerBytes || std::memcmp(begin, kMagic, sizeof(kMagic)) != 0 ||
+            std::memcmp(begin + size - sizeof(kIndexMagic), kIndexMagic, sizeof(kIndexMagic)) != 0)
+            throw std::runtime_error("Not a feature archive: " + path.string());
+
+        const unsigned char* cursor = begin + sizeof(kMagic);
+        const auto version = take<std::uint32_t>(cursor, begin + kHeaderBytes);
+        if (version != kVersion)
+            throw std::runtime_error("Unsupported feature archive version " + std::to_string(version) + ": " +
+                                     path.string());
+        _chunkFrames = take<std::uint32_t>(cursor, begin + kHeaderBytes);
+
+        const unsigned char* indexEnd = begin + size - kTrailerBytes;
+        cursor = indexEnd;
+        const auto indexOffset = take<std::uint64_t>(cursor, begin + size);
+        if (indexOffset < kHeaderBytes || indexOffset > size - kTrailerBytes || _chunkFrames == 0)
+            throw std::runtime_error("Corrupt feature archive index: " + path.string());
+
+        cursor = begin + indexOffset;
+        const auto count = take<std::uint32_t>(cursor, indexEnd);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            const auto keySize = take<std::uint32_t>(cursor, indexEnd);
+            if (static_cast<std::size_t>(indexEnd - cursor) < keySize)
+                throw std::runtime_error("Truncated feature archive index");
+            std::string key(reinterpret_cast<const char*>(cursor), keySize);
+            cursor += keySize;
+
+            Entry entry;
+            entry.rows = static_cast<std::size_t>(take<std::uint64_t>(cursor, indexEnd));
+            entry.cols = take<std::uint32_t>(cursor, indexEnd);
+            const auto chunks = take<std::uint32_t>(cursor, indexEnd);
+            if (static_cast<std::size_t>(indexEnd - cursor) / kChunkRecordBytes < chunks)
+                throw std::runtime_error("Truncated feature archive index");
+
+            const std::size_t expectedChunks = entry.cols == 0 ? 0 : (entry.rows + _chunkFrames - 1) / _chunkFrames;
+            if (chunks != expectedChunks)
+                throw std::runtime_error("Corrupt feature archive index for key: " + key);
+
+            entry.chunks.resize(chunks);
+            for (auto& chunk : entry.chunks)
+            {
+                chunk.offset = take<std::uint64_t>(cursor, indexEnd);
+                chunk.size = take<std::uint32_t>(cursor, indexEnd);
+                chunk.codec = take<std::uint8_t>(cursor, indexEnd);
+                if (chunk.offset < kHeaderBytes || chunk.offset > indexOffset || chunk.size > indexOffset - chunk.offset ||
+                    chunk.codec > kCodecDeltaShuffleHuffman)
+                    throw std::runtime_error("Corrupt feature archive index for key: " + key);
+            }
+
+            if (!_entries.emplace(key, std::move(entry)).second)
+                throw std::runtime_error("Duplicate key in feature archive: " + key);
+            _keys.push_back(std::move(key));
+        }
+    }
+
+    bool FeatureArchiveReader::contains(const std::string& key) const
+    {
+        return _entries.count(key) != 0;
+    }
+
+    std::size_t FeatureArchiveReader::getRows(const std::string& key) const
+    {
+        return entry(key).rows;
+    }
+
+    std::size_t FeatureArchiveReader::getCols(const std::string& key) const
+    {
+        return entry(key).cols;
+    }
+
+    FeatureMatrix FeatureArchiveReader::read(const std::string& key) const
+    {
+        return readFrames(key, 0, entry(key).rows);
+    }
+
+    FeatureMatrix FeatureArchiveReader::readFrames(const std::string& key, std::size_t firstFrame, std::size_t count) const
+    {
+        const auto& e = entry(key);
+        if (firstFrame > e.rows || count > e.rows - firstFrame)
+            throw std::out_of_range("Frame range past the end of " + key);
+
+        FeatureMatrix out(count, FeatureVector(e.cols));
+        if (count == 0 || e.cols == 0)
+            return out;
+
+        std::vector<float> frames(_chunkFrames * e.cols);
+        const std::size_t firstChunk = firstFrame / _chunkFrames;
+        const std::size_t lastChunk = (firstFrame + count - 1) / _chunkFrames;
+        for (std::size_t c = firstChunk; c <= lastChunk; ++c)
+        {
+            const auto& chunk = e.chunks[c];
+            const std::size_t chunkBegin = c * _chunkFrames;
+            const std::size_t chunkRows = std::min(_chunkFrames, e.rows - chunkBegin);
+            const std::size_t rawBytes = chunkRows * e.cols * sizeof(float);
+            const unsigned char* stored = _file.data() + chunk.offset;
+
+            if (chunk.codec == kCodecRaw)
+            {
+                if (chunk.size != rawBytes)
+                    throw std::runtime_error("Corrupt feature archive chunk");
+                std::memcpy(frames.data(), stored, rawBytes);
+            }
+            else
+            {
+                std::vector<unsigned char> planes(rawBytes);
+                const std::size_t planeBytes = chunkRows * e.cols;
+                const unsigned char* cursor = stored;
+                for (std::size_t b = 0; b < sizeof(float); ++b)
+                    cursor = decodePlane(cursor, stored + chunk.size, planes.data() + b * planeBytes, planeBytes);
+                unshuffle(planes.data(), chunkRows, e.cols, frames.data());
+            }
+            ++_chunksDecoded;
+
+            const std::size_t from = std::max(firstFrame, chunkBegin);
+            const std::size_t to = std::min(firstFrame + count, chunkBegin + chunkRows);
+            for (std::size_t r = from; r < to; ++r)
+            {
+                const float* row = frames.data() + (r - chunkBegin) * e.cols;
+                std::copy(row, row + e.cols, out[r - firstFrame].begin());
+            }
+        }
+        return out;
+    }
+
+    const FeatureArchiveReader::Entry& FeatureArchiveReader::entry(const std::string& key) const
+    {
+        const auto it = _entries.find(key);
+        if (it == _entries.end())
+            throw std::out_of_range("Unknown feature archive key: " + key);
+        return it->second;
+    }
+}
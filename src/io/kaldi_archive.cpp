@@ -0,0 +1,314 @@
+#include "libvoicefeat/io/kaldi_archive.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace libvoicefeat::io
+{
+    namespace
+    {
+        constexpr char kBinaryMarker[2] = {'\0', 'B'};
+        constexpr char kFloatMatrixToken[3] = {'F', 'M', ' '};
+        constexpr char kInt32Size = 4;
+        // marker, token and two size-prefixed int32 dimensions
+        constexpr std::size_t kHeaderBytes = sizeof(kBinaryMarker) + sizeof(kFloatMatrixToken) + 2 * (1 + 4);
+
+        bool isValidKey(const std::string& key)
+        {
+            if (key.empty())
+                return false;
+            return std::none_of(key.begin(), key.end(), [](unsigned char c) { return std::isspace(c) || c == 0; });
+        }
+
+        struct MatrixHeader
+        {
+            std::size_t dataOffset = 0;
+            std::size_t rows = 0;
+            std::size_t cols = 0;
+        };
+
+        // Parses the binary header starting at `offset` (the "\0B" marker) and checks the payload fits.
+        MatrixHeader parseHeader(const utils::MappedFile& file, std::size_t offset, const std::string& key)
+        {
+            const unsigned char* base = file.data();
+            if (offset > file.size() || file.size() - offset < kHeaderBytes)
+                throw std::runtime_error("Truncated Kaldi matrix header for key: " + key);
+
+            const unsigned char* p = base + offset;
+            if (std::memcmp(p, kBinaryMarker, sizeof(kBinaryMarker)) != 0)
+                throw std::runtime_error("Only binary Kaldi archives are supported (key: " + key + ")");
+            p += sizeof(kBinaryMarker);
+            if (std::memcmp(p, kFloatMatrixToken, sizeof(kFloatMatrixToken)) != 0)
+                throw std::runtime_error("Only uncompressed float matrices (FM) are supported (key: " + key + ")");
+            p += sizeof(kFloatMatrixToken);
+
+            std::int32_t dims[2]{};
+            for (auto& dim : dims)
+            {
+                if (static_cast<char>(*p) != kInt32Size)
+                    throw std::runtime_error("Unexpected integer size in Kaldi matrix header for key: " + key);
+                std::memcpy(&dim, p + 1, sizeof(dim));
+                p += 1 + sizeof(dim);
+                if (dim < 0)
+                    throw std::runtime_error("Negative matrix dimension for key: " + key);
+            }
+
+            MatrixHeader header;
+            header.dataOffset = offset + kHeaderBytes;
+            header.rows = static_cast<std::size_t>(dims[0]);
+            header.cols = static_cast<std::size_t>(dims[1]);
+
+            const std::size_t available = (file.size() - header.dataOffset) / sizeof(float);
+            if (header.cols != 0 && header.rows > available / header.cols)
+                throw std::runtime_error("Truncated Kaldi matrix data for key: " + key);
+            return header;
+        }
+    }
+
+    float MatrixView::at(std::size_t row, std::size_t col) const
+    {
+        if (row >= _rows || col >= _cols)
+            throw std::out_of_range("MatrixView index out of range");
+
+        float value = 0.0f;
+        std::memcpy(&value, _bytes + (row * _cols + col) * sizeof(float), sizeof(float));
+        return value;
+    }
+
+    void MatrixView::copyRow(std::size_t row, float* out) const
+    {
+        if (row >= _rows)
+            throw std::out_of_range("MatrixView row out of range");
+        std::memcpy(out, _bytes + row * _cols * sizeof(float), _cols * sizeof(float));
+    }
+
+    FeatureMatrix MatrixView::toMatrix() const
+    {
+        FeatureMatrix matrix(_rows, FeatureVector(_cols));
+        for (std::size_t r = 0; r < _rows; ++r)
+        {
+            copyRow(r, matrix[r].data());
+        }
+        return matrix;
+    }
+
+    KaldiArchiveWriter::KaldiArchiveWriter(const std::filesystem::path& arkPath, const std::filesystem::path& scpPath)
+        : _arkName(arkPath.string()),
+          _ark(arkPath, std::ios::binary | std::ios::trunc)
+    {
+        if (!_ark)
+            throw std::runtime_error("Cannot open Kaldi archive for writing: " + _arkName);
+
+        if (!scpPath.empty())
+        {
+            _scp.open(scpPath, std::ios::trunc);
+            if (!_scp)
+                throw std::runtime_error("Cannot open Kaldi scp for writing: " + scpPath.string());
+        }
+    }
+
+    KaldiArchiveWriter::~KaldiArchiveWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void KaldiArchiveWriter::write(const std::string& key, const FeatureMatrix& matrix)
+    {
+        const std::size_t rows = matrix.size();
+        const std::size_t cols = rows == 0 ? 0 : matrix.front().size();
+        for (const auto& row : matrix)
+        {
+            if (row.size() != cols)
+                throw std::invalid_argument("Ragged feature matrix for key: " + key);
+        }
+
+        writeHeader(key, rows, cols);
+        for (const auto& row : matrix)
+        {
+            _ark.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(cols * sizeof(float)));
+        }
+        _offset += rows * cols * sizeof(float);
+
+        if (!_ark)
+            throw std::runtime_error("Failed writing Kaldi archive: " + _arkName);
+    }
+
+    void KaldiArchiveWriter::write(const std::string& key, const float* data, std::size_t rows, std::size_t cols)
+    {
+        if (data == nullptr && rows * cols != 0)
+            throw std::invalid_argument("data is null");
+
+        writeHeader(key, rows, cols);
+        _ark.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(rows * cols * sizeof(float)));
+        _offset += rows * cols * sizeof(float);
+
+        if (!_ark)
+            throw std::runtime_error("Failed writing Kaldi archive: " + _arkName);
+    }
+
+    void KaldiArchiveWriter::writeHeader(const std::string& key, std::size_t rows, std::size_t cols)
+    {
+        if (!_ark.is_open())
+            throw std::runtime_error("Kaldi archive is closed: " + _arkName);
+        if (!isValidKey(key))
+            throw std::invalid_argument("Invalid Kaldi key: '" + key + "'");
+        constexpr auto kMaxDim = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+        if (rows > kMaxDim || cols > kMaxDim)
+            throw std::invalid_argument("Matrix too large for a Kaldi archive: " + key);
+
+        _ark.write(key.data(), static_cast<std::streamsize>(key.size()));
+        _ark.put(' ');
+        _offset += key.size() + 1;
+
+        // scp offsets point at the binary marker, right after "<key> "
+        if (_scp.is_open())
+            _scp << key << ' ' << _arkName << ':' << _offset << '\n';
+
+        const std::int32_t dims[2] = {static_cast<std::int32_t>(rows), static_cast<std::int32_t>(cols)};
+        _ark.write(kBinaryMarker, sizeof(kBinaryMarker));
+        _ark.write(kFloatMatrixToken, sizeof(kFloatMatrixToken));
+        for (const auto dim : dims)
+        {
+            _ark.put(kInt32Size);
+            _ark.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+        }
+        _offset += kHeaderBytes;
+        ++_numWritten;
+    }
+
+    void KaldiArchiveWriter::close()
+    {
+        if (_ark.is_open())
+        {
+            _ark.close();
+            if (!_ark)
+                throw std::runtime_error("Failed closing Kaldi archive: " + _arkName);
+        }
+        if (_scp.is_open())
+        {
+            _scp.close();
+            if (!_scp)
+                throw std::runtime_error("Failed closing Kaldi scp for: " + _arkName);
+        }
+    }
+
+    KaldiArchiveReader KaldiArchiveReader::openArchive(const std::filesystem::path& arkPath)
+    {
+        KaldiArchiveReader reader;
+        const std::size_t archive = reader.mapArchive(arkPath);
+        const utils::MappedFile& file = reader._archives[archive];
+
+        const unsigned char* base = file.data();
+        std::size_t pos = 0;
+        while (pos < file.size())
+        {
+            const auto* keyEnd = static_cast<const unsigned char*>(std::memchr(base + pos, ' ', file.size() - pos));
+            if (keyEnd == nullptr)
+                throw std::runtime_error("Truncated key in Kaldi archive: " + arkPath.string());
+
+            const std::string key(reinterpret_cast<const char*>(base + pos), static_cast<std::size_t>(keyEnd - (base + pos)));
+            if (!isValidKey(key))
+                throw std::runtime_error("Invalid key in Kaldi archive: " + arkPath.string());
+
+            const MatrixHeader header = parseHeader(file, static_cast<std::size_t>(keyEnd - base) + 1, key);
+            reader.addEntry(key, Entry{archive, header.dataOffset, header.rows, header.cols});
+            pos = header.dataOffset + header.rows * header.cols * sizeof(float);
+        }
+
+        return reader;
+    }
+
+    KaldiArchiveReader KaldiArchiveReader::openScp(const std::filesystem::path& scpPath)
+    {
+        std::ifstream in(scpPath);
+        if (!in)
+            throw std::runtime_error("Cannot open Kaldi scp: " + scpPath.string());
+
+        KaldiArchiveReader reader;
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(in, line))
+        {
+            ++lineNumber;
+            std::istringstream fields(line);
+            std::string key;
+            std::string location;
+            if (!(fields >> key))
+                continue;
+
+            const auto colon = (fields >> location) ? location.rfind(':') : std::string::npos;
+            if (colon == std::string::npos || colon + 1 == location.size())
+            {
+                throw std::runtime_error("Malformed scp line " + std::to_string(lineNumber) + " in " +
+                                         scpPath.string());
+            }
+
+            // Kaldi resolves archive paths against the working directory; fall back to the scp's own
+            // directory so an index moved together with its archives still opens.
+            std::filesystem::path arkPath = location.substr(0, colon);
+            if (arkPath.is_relative() && !std::filesystem::exists(arkPath))
+                arkPath = scpPath.parent_path() / arkPath;
+
+            std::size_t offset = 0;
+            try
+            {
+                offset = static_cast<std::size_t>(std::stoull(location.substr(colon + 1)));
+            }
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Malformed offset on scp line " + std::to_string(lineNumber) + " in " +
+                                         scpPath.string());
+            }
+
+            const std::size_t archive = reader.mapArchive(arkPath);
+            const MatrixHeader header = parseHeader(reader._archives[archive], offset, key);
+            reader.addEntry(key, Entry{archive, header.dataOffset, header.rows, header.cols});
+        }
+
+        return reader;
+    }
+
+    bool KaldiArchiveReader::contains(const std::string& key) const
+    {
+        return _entries.find(key) != _entries.end();
+    }
+
+    MatrixView KaldiArchiveReader::get(const std::string& key) const
+    {
+        const auto it = _entries.find(key);
+        if (it == _entries.end())
+            throw std::out_of_range("Key not found in Kaldi archive: " + key);
+
+        const Entry& entry = it->second;
+        return MatrixView(_archives[entry.archive].data() + entry.dataOffset, entry.rows, entry.cols);
+    }
+
+    std::size_t KaldiArchiveReader::mapArchive(const std::filesystem::path& path)
+    {
+        const std::string name = path.lexically_normal().string();
+        const auto it = _archiveIndex.find(name);
+        if (it != _archiveIndex.end())
+            return it->second;
+
+        _archives.emplace_back(path);
+        _archiveIndex.emplace(name, _archives.size() - 1);
+        return _archives.size() - 1;
+    }
+
+    void KaldiArchiveReader::addEntry(const std::string& key, const Entry& entry)
+    {
+        if (!_entries.emplace(key, entry).second)
+            throw std::runtime_error("Duplicate key in Kaldi archive: " + key);
+        _keys.push_back(key);
+    }
+}
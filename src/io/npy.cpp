@@ -0,0 +1,392 @@
+#include "libvoicefeat/io/npy.h"
+
+#include "libvoicefeat/utils/float16.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace libvoicefeat::io
+{
+    namespace
+    {
+        constexpr std::size_t kPreambleBytes = 10;      // magic, version, header length
+        constexpr std::size_t kHeaderAlignment = 64;
+        constexpr std::uint32_t kZipLimit = std::numeric_limits<std::uint32_t>::max();
+
+        std::size_t elementBytes(NpyDType dtype)
+        {
+            return dtype == NpyDType::Float16 ? 2 : 4;
+        }
+
+        // Preamble plus the shape dictionary, padded with spaces to totalBytes (0 = next multiple of 64).
+        std::string npyHeader(std::size_t rows, std::size_t cols, NpyDType dtype, std::size_t totalBytes = 0)
+        {
+            std::string dict = "{'descr': '";
+            dict += dtype == NpyDType::Float16 ? "<f2" : "<f4";
+            dict += "', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " + std::to_string(cols) + "), }";
+
+            const std::size_t used = kPreambleBytes + dict.size() + 1;
+            if (totalBytes == 0)
+                totalBytes = (used + kHeaderAlignment - 1) / kHeaderAlignment * kHeaderAlignment;
+            if (used > totalBytes || totalBytes - kPreambleBytes > std::numeric_limits<std::uint16_t>::max())
+                throw std::logic_error("npy header does not fit its reserved space");
+
+            dict.append(totalBytes - used, ' ');
+            dict.push_back('\n');
+
+            std::string header = "\x93NUMPY";
+            header.push_back('\x01');
+            header.push_back('\x00');
+            header.push_back(static_cast<char>(dict.size() & 0xffu));
+            header.push_back(static_cast<char>((dict.size() >> 8) & 0xffu));
+            return header + dict;
+        }
+
+        // Hands the encoded bytes of one row to sink(const char*, std::size_t).
+        template <typename Sink>
+        void encodeRow(const float* row, std::size_t cols, NpyDType dtype, std::vector<std::uint16_t>& halves,
+                       Sink&& sink)
+        {
+            if (dtype == NpyDType::Float32)
+            {
+                sink(reinterpret_cast<const char*>(row), cols * sizeof(float));
+                return;
+            }
+
+            halves.resize(cols);
+            std::transform(row, row + cols, halves.begin(), utils::floatToHalf);
+            sink(reinterpret_cast<const char*>(halves.data()), cols * sizeof(std::uint16_t));
+        }
+
+        std::size_t checkedCols(const FeatureMatrix& matrix)
+        {
+            const std::size_t cols = matrix.empty() ? 0 : matrix.front().size();
+            for (const auto& row : matrix)
+            {
+                if (row.size() != cols)
+                    throw std::invalid_argument("Cannot write a ragged feature matrix as npy");
+            }
+            return cols;
+        }
+
+        template <typename RowAt, typename Sink>
+        void encodeArray(std::size_t rows, std::size_t cols, NpyDType dtype, RowAt rowAt, Sink&& sink)
+        {
+            const std::string header = npyHeader(rows, cols, dtype);
+            sink(header.data(), header.size());
+
+            std::vector<std::uint16_t> halves;
+            for (std::size_t r = 0; r < rows; ++r)
+            {
+                encodeRow(rowAt(r), cols, dtype, halves, sink);
+            }
+        }
+
+        template <typename RowAt>
+        std::vector<unsigned char> serialize(std::size_t rows, std::size_t cols, NpyDType dtype, RowAt rowAt)
+        {
+            std::vector<unsigned char> bytes;
+            bytes.reserve(npyHeader(rows, cols, dtype).size() + rows * cols * elementBytes(dtype));
+            encodeArray(rows, cols, dtype, rowAt, [&bytes](const char* data, std::size_t count)
+            {
+                bytes.insert(bytes.end(), data, data + count);
+            });
+            return bytes;
+        }
+
+        template <typename RowAt>
+        void writeFile(const std::filesystem::path& path, std::size_t rows, std::size_t cols, NpyDType dtype,
+                       RowAt rowAt)
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw std::runtime_error("Cannot open npy file for writing: " + path.string());
+
+            encodeArray(rows, cols, dtype, rowAt, [&out](const char* data, std::size_t count)
+            {
+                out.write(data, static_cast<std::streamsize>(count));
+            });
+
+            out.close();
+            if (!out)
+                throw std::runtime_error("Failed writing npy file: " + path.string());
+        }
+
+        class Crc32
+        {
+        public:
+            void update(const char* data, std::size_t count)
+            {
+                static const auto table = makeTable();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    _crc = table[(_crc ^ static_cast<unsigned char>(data[i])) & 0xffu] ^ (_crc >> 8);
+                }
+            }
+
+            [[nodiscard]] std::uint32_t value() const { return _crc ^ 0xffffffffu; }
+
+        private:
+            static std::array<std::uint32_t, 256> makeTable()
+            {
+                std::array<std::uint32_t, 256> table{};
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    std::uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                        c = (c & 1u) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    table[i] = c;
+                }
+                return table;
+            }
+
+            std::uint32_t _crc = 0xffffffffu;
+        };
+
+        void putLE(std::ostream& out, std::uint32_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+                out.put(static_cast<char>((value >> (8 * i)) & 0xffu));
+        }
+
+        // DOS date of 1980-01-01, the zip epoch; entries carry no real timestamp
+        constexpr std::uint32_t kZipDate = (1u << 5) | 1u;
+        constexpr std::uint32_t kZipVersion = 20;
+    }
+
+    std::vector<unsigned char> serializeNpy(const FeatureMatrix& matrix, NpyDType dtype)
+    {
+        const std::size_t cols = checkedCols(matrix);
+        return serialize(matrix.size(), cols, dtype, [&matrix](std::size_t r) { return matrix[r].data(); });
+    }
+
+    std::vector<unsigned char> serializeNpy(const float* data, std::size_t rows, std::size_t cols, NpyDType dtype)
+    {
+        if (data == nullptr && rows * cols != 0)
+            throw std::invalid_argument("data is null");
+        return serialize(rows, cols, dtype, [data, cols](std::size_t r) { return data + r * cols; });
+    }
+
+    void writeNpy(const std::filesystem::path& path, const FeatureMatrix& matrix, NpyDType dtype)
+    {
+        const std::size_t cols = checkedCols(matrix);
+        writeFile(path, matrix.size(), cols, dtype, [&matrix](std::size_t r) { return matrix[r].data(); });
+    }
+
+    void writeNpy(const std::filesystem::path& path, const float* data, std::size_t rows, std::size_t cols,
+                  NpyDType dtype)
+    {
+        if (data == nullptr && rows * cols != 0)
+            throw std::invalid_argument("data is null");
+        writeFile(path, rows, cols, dtype, [data, cols](std::size_t r) { return data + r * cols; });
+    }
+
+    NpyWriter::NpyWriter(const std::filesystem::path& path, NpyDType dtype)
+        : _name(path.string()),
+          _out(path, std::ios::binary | std::ios::trunc),
+          _dtype(dtype)
+    {
+        if (!_out)
+            throw std::runtime_error("Cannot open npy file for writing: " + _name);
+    }
+
+    NpyWriter::~NpyWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void NpyWriter::appendRow(const FeatureVector& row)
+    {
+        appendRow(row.data(), row.size());
+    }
+
+    void NpyWriter::appendRow(const float* row, std::size_t cols)
+    {
+        if (!_out.is_open())
+            throw std::runtime_error("npy writer is closed: " + _name);
+
+        if (_headerBytes == 0)
+        {
+            // room for the widest possible row count, patched by close()
+            const std::string header = npyHeader(std::numeric_limits<std::size_t>::max(), cols, _dtype);
+            _out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            _headerBytes = header.size();
+            _cols = cols;
+        }
+        else if (cols != _cols)
+        {
+            throw std::invalid_argument("Row width " + std::to_string(cols) + " differs from " + std::to_string(_cols));
+        }
+
+        encodeRow(row, cols, _dtype, _halves, [this](const char* data, std::size_t count)
+        {
+            _out.write(data, static_cast<std::streamsize>(count));
+        });
+        ++_rows;
+
+        if (!_out)
+            throw std::runtime_error("Failed writing npy file: " + _name);
+    }
+
+    void NpyWriter::close()
+    {
+        if (!_out.is_open())
+            return;
+
+        const std::string header = npyHeader(_rows, _cols, _dtype, _headerBytes);
+        _out.seekp(0);
+        _out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        _out.close();
+        if (!_out)
+            throw std::runtime_error("Failed writing npy file: " + _name);
+    }
+
+    NpzWriter::NpzWriter(const std::filesystem::path& path)
+        : _name(path.string()),
+          _out(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!_out)
+            throw std::runtime_error("Cannot open npz file for writing: " + _name);
+    }
+
+    NpzWriter::~NpzWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void NpzWriter::add(const std::string& name, const FeatureMatrix& matrix, NpyDType dtype)
+    {
+        const std::size_t cols = checkedCols(matrix);
+        addEntry(name, matrix.size(), cols, dtype, [&matrix](std::size_t r) { return matrix[r].data(); });
+    }
+
+    void NpzWriter::add(const std::string& name, const float* data, std::size_t rows, std::size_t cols,
+                        NpyDType dtype)
+    {
+        if (data == nullptr && rows * cols != 0)
+            throw std::invalid_argument("data is null");
+        addEntry(name, rows, cols, dtype, [data, cols](std::size_t r) { return data + r * cols; });
+    }
+
+    template <typename RowAt>
+    void NpzWriter::addEntry(const std::string& name, std::size_t rows, std::size_t cols, NpyDType dtype,
+                             RowAt rowAt)
+    {
+        if (!_out.is_open())
+            throw std::runtime_error("npz writer is closed: " + _name);
+        if (name.empty())
+            throw std::invalid_argument("npz entry name is empty");
+
+        const bool hasSuffix = name.size() >= 4 && name.compare(name.size() - 4, 4, ".npy") == 0;
+        const std::string entryName = hasSuffix ? name : name + ".npy";
+        const bool duplicate = std::any_of(_entries.begin(), _entries.end(), [&entryName](const Entry& e)
+        {
+            return e.name == entryName;
+        });
+        if (duplicate)
+            throw std::invalid_argument("Duplicate npz entry: " + entryName);
+        if (_entries.size() == std::numeric_limits<std::uint16_t>::max())
+            throw std::runtime_error("npz archive is limited to 65535 arrays: " + _name);
+
+        const auto offset = static_cast<std::uint64_t>(_out.tellp());
+        if (offset > kZipLimit)
+            throw std::runtime_error("npz archive exceeds 4 GiB: " + _name);
+
+        // local file header; CRC and sizes are patched once the data is written
+        putLE(_out, 0x04034b50u, 4);
+        putLE(_out, kZipVersion, 2);
+        putLE(_out, 0, 2);                  // flags
+        putLE(_out, 0, 2);                  // stored
+        putLE(_out, 0, 2);                  // time
+        putLE(_out, kZipDate, 2);
+        putLE(_out, 0, 4);                  // crc
+        putLE(_out, 0, 4);                  // compressed size
+        putLE(_out, 0, 4);                  // uncompressed size
+        putLE(_out, static_cast<std::uint32_t>(entryName.size()), 2);
+        putLE(_out, 0, 2);                  // extra field length
+        _out.write(entryName.data(), static_cast<std::streamsize>(entryName.size()));
+
+        Crc32 crc;
+        std::uint64_t size = 0;
+        encodeArray(rows, cols, dtype, rowAt, [&](const char* data, std::size_t count)
+        {
+            _out.write(data, static_cast<std::streamsize>(count));
+            crc.update(data, count);
+            size += count;
+        });
+        if (size > kZipLimit || offset + size > kZipLimit)
+            throw std::runtime_error("npz archive exceeds 4 GiB: " + _name);
+
+        const auto end = _out.tellp();
+        _out.seekp(static_cast<std::streamoff>(offset + 14));
+        putLE(_out, crc.value(), 4);
+        putLE(_out, static_cast<std::uint32_t>(size), 4);
+        putLE(_out, static_cast<std::uint32_t>(size), 4);
+        _out.seekp(end);
+
+        if (!_out)
+            throw std::runtime_error("Failed writing npz file: " + _name);
+
+        _entries.push_back(Entry{entryName, crc.value(), static_cast<std::uint32_t>(size),
+                                 static_cast<std::uint32_t>(offset)});
+    }
+
+    void NpzWriter::close()
+    {
+        if (!_out.is_open())
+            return;
+
+        const auto directoryOffset = static_cast<std::uint64_t>(_out.tellp());
+        for (const auto& entry : _entries)
+        {
+            putLE(_out, 0x02014b50u, 4);
+            putLE(_out, kZipVersion, 2);    // made by
+            putLE(_out, kZipVersion, 2);    // needed
+            putLE(_out, 0, 2);              // flags
+            putLE(_out, 0, 2);              // stored
+            putLE(_out, 0, 2);              // time
+            putLE(_out, kZipDate, 2);
+            putLE(_out, entry.crc, 4);
+            putLE(_out, entry.size, 4);
+            putLE(_out, entry.size, 4);
+            putLE(_out, static_cast<std::uint32_t>(entry.name.size()), 2);
+            putLE(_out, 0, 2);              // extra field length
+            putLE(_out, 0, 2);              // comment length
+            putLE(_out, 0, 2);              // disk number
+            putLE(_out, 0, 2);              // internal attributes
+            putLE(_out, 0, 4);              // external attributes
+            putLE(_out, entry.offset, 4);
+            _out.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+        }
+        const auto directorySize = static_cast<std::uint64_t>(_out.tellp()) - directoryOffset;
+        if (directoryOffset + directorySize > kZipLimit)
+            throw std::runtime_error("npz archive exceeds 4 GiB: " + _name);
+
+        putLE(_out, 0x06054b50u, 4);
+        putLE(_out, 0, 2);                  // this disk
+        putLE(_out, 0, 2);                  // directory disk
+        putLE(_out, static_cast<std::uint32_t>(_entries.size()), 2);
+        putLE(_out, static_cast<std::uint32_t>(_entries.size()), 2);
+        putLE(_out, static_cast<std::uint32_t>(directorySize), 4);
+        putLE(_out, static_cast<std::uint32_t>(directoryOffset), 4);
+        putLE(_out, 0, 2);                  // comment length
+
+        _out.close();
+        if (!_out)
+            throw std::runtime_error("Failed writing npz file: " + _name);
+    }
+}
@@ -0,0 +1,110 @@
+#include "libvoicefeat/io/quantized_file.h"
+
+#include "libvoicefeat/utils/mapped_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace libvoicefeat::io
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'L', 'V', 'F', 'Q'};
+        constexpr std::uint32_t kVersion = 1;
+
+        struct QuantizedHeader
+        {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t type;
+            std::uint32_t reserved;
+            std::uint64_t rows;
+            std::uint64_t cols;
+        };
+        static_assert(sizeof(QuantizedHeader) == 32, "quantized header must stay 32 bytes");
+
+        bool hasAffineParameters(features::QuantizationType type)
+        {
+            return type != features::QuantizationType::Float16;
+        }
+    }
+
+    void writeQuantized(const std::filesystem::path& path, const features::QuantizedMatrix& matrix)
+    {
+        const bool affine = hasAffineParameters(matrix.type);
+        if (matrix.data.size() != matrix.rows * matrix.cols * features::bytesPerElement(matrix.type) ||
+            (affine && (matrix.scale.size() != matrix.cols || matrix.offset.size() != matrix.cols)))
+            throw std::invalid_argument("Inconsistent quantized matrix");
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Cannot open quantized feature file for writing: " + path.string());
+
+        QuantizedHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.type = static_cast<std::uint32_t>(matrix.type);
+        header.rows = matrix.rows;
+        header.cols = matrix.cols;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (affine)
+        {
+            out.write(reinterpret_cast<const char*>(matrix.scale.data()), static_cast<std::streamsize>(matrix.cols * sizeof(float)));
+            out.write(reinterpret_cast<const char*>(matrix.offset.data()), static_cast<std::streamsize>(matrix.cols * sizeof(float)));
+        }
+        out.write(reinterpret_cast<const char*>(matrix.data.data()), static_cast<std::streamsize>(matrix.data.size()));
+
+        out.close();
+        if (!out)
+            throw std::runtime_error("Failed writing quantized feature file: " + path.string());
+    }
+
+    features::QuantizedMatrix readQuantized(const std::filesystem::path& path)
+    {
+        const utils::MappedFile file(path);
+
+        QuantizedHeader header{};
+        if (file.size() < sizeof(header))
+            throw std::runtime_error("Truncated quantized feature file: " + path.string());
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("Not a quantized feature file: " + path.string());
+        if (header.version != kVersion)
+            throw std::runtime_error("Unsupported quantized feature file version " + std::to_string(header.version) +
+                                     ": " + path.string());
+        if (header.type > static_cast<std::uint32_t>(features::QuantizationType::Int16))
+            throw std::runtime_error("Unknown quantization type in " + path.string());
+
+        features::QuantizedMatrix matrix;
+        matrix.type = static_cast<features::QuantizationType>(header.type);
+        matrix.rows = static_cast<std::size_t>(header.rows);
+        matrix.cols = static_cast<std::size_t>(header.cols);
+
+        const bool affine = hasAffineParameters(matrix.type);
+        const std::size_t parameterBytes = affine ? 2 * matrix.cols * sizeof(float) : 0;
+        const std::size_t dataBytes = matrix.rows * matrix.cols * features::bytesPerElement(matrix.type);
+        if ((header.cols != 0 && header.rows > file.size() / header.cols) ||
+            file.size() != sizeof(header) + parameterBytes + dataBytes)
+            throw std::runtime_error("Quantized feature file size does not match its header: " + path.string());
+
+        const unsigned char* cursor = file.data() + sizeof(header);
+        if (affine)
+        {
+            matrix.scale.resize(matrix.cols);
+            matrix.offset.resize(matrix.cols);
+            std::memcpy(matrix.scale.data(), cursor, matrix.cols * sizeof(float));
+            std::memcpy(matrix.offset.data(), cursor + matrix.cols * sizeof(float), matrix.cols * sizeof(float));
+            cursor += parameterBytes;
+        }
+        matrix.data.assign(cursor, cursor + dataBytes);
+        return matrix;
+    }
+
+    FeatureMatrix readDequantized(const std::filesystem::path& path)
+    {
+        return readQuantized(path).dequantize();
+    }
+}
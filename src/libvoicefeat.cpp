@@ -1,120 +1,617 @@
 #include "libvoicefeat/libvoicefeat.h"
 
-#include "libvoicefeat/audio/mp3_audio_reader.h"
-#include "libvoicefeat/audio/wav_audio_reader.h"
+#include "libvoicefeat/audio/audio_reader.h"
 #include "libvoicefeat/dsp/frame_extractor.h"
-#include "libvoicefeat/dsp/window_functiion.h"
-#include "libvoicefeat/dsp/fft_transformer.h"
 
 #include <algorithm>
-#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "libvoicefeat/dsp/resampler.h"
 #include "libvoicefeat/features/feature_builder.h"
+#include "libvoicefeat/features/pncc.h"
 
 namespace libvoicefeat
 {
+    namespace
+    {
+        std::shared_ptr<ThreadPool> makePool(const CepstralConfig& config)
+        {
+            if (config.threading.numThreads > 1)
+                return std::make_shared<ThreadPool>(static_cast<std::size_t>(config.threading.numThreads));
+            return nullptr;
+        }
+
+        // Work between cancellation checks in async calls. Frame blocks are a multiple of every batch lane width.
+        constexpr std::size_t kCheckpointFrames = 64;
+        constexpr std::size_t kCheckpointSamples = 1 << 16;
+
+        // Frames decoded before a PNCC range so its trackers settle: one time constant of the mean-power
+        // forgetting factor (1 / (1 - 0.999)).
+        constexpr std::size_t kPnccWarmupFrames = 1000;
+
+        ThreadPool& sharedAsyncPool()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        Executor poolExecutor(ThreadPool& pool)
+        {
+            return [&pool](std::function<void()> task)
+            {
+                // the task reports through its callback; the packaged result is not needed
+                static_cast<void>(pool.submit(std::move(task)));
+            };
+        }
+
+        int checkedFrameSize(const CepstralConfig& config)
+        {
+            if (config.framing.frameSize <= 0 || config.framing.frameStep <= 0)
+                throw std::invalid_argument("Frame size and step must be positive");
+            return config.framing.frameSize;
+        }
+    }
+
     CepstralExtractor::CepstralExtractor(const CepstralConfig& config)
+        : CepstralExtractor(config, makePool(config))
+    {
+    }
+
+    CepstralExtractor::CepstralExtractor(const CepstralConfig& config, std::shared_ptr<ThreadPool> pool)
         : _config(config)
+        , _pool(std::move(pool))
+        , _transformer(static_cast<std::size_t>(checkedFrameSize(config)))
+        , _window(config.framing.frameSize, config.framing.window)
+        , _prototype(FeatureFactory::createDefaultFeature(config))
     {
+        _prototype.setPlan(_prototype.makePlan(static_cast<int>(_transformer.size())));
     }
 
-    Feature CepstralExtractor::extractFromFile(const std::string& path)
+    Feature CepstralExtractor::extractFromFile(const std::string& path) const
     {
         auto buffer = loadAudio(path);
         return extractFromAudioBuffer(buffer);
     }
 
-    Feature CepstralExtractor::extractFromAudioBuffer(const AudioBuffer& audio)
+    Feature CepstralExtractor::extractFromAudioBuffer(const AudioBuffer& audio) const
+    {
+        return extract(audio, {});
+    }
+
+    Feature CepstralExtractor::extractFromMemory(const void* data, std::size_t size, AudioFormat format) const
+    {
+        if (format == AudioFormat::Auto)
+            format = detectAudioFormat(data, size);
+
+        const auto buffer = createAudioReader(format)->loadMemory(data, size);
+        return extractFromAudioBuffer(buffer);
+    }
+
+    QuantizedMatrix CepstralExtractor::extractQuantized(const std::string& path, QuantizationType type) const
     {
-        if (_config.framing.frameSize <= 0 || _config.framing.frameStep <= 0)
-            throw std::invalid_argument("Frame size and step must be positive");
+        return quantize(extractFromFile(path).getComputedMatrix(), type);
+    }
+
+    Feature CepstralExtractor::extractRange(const std::string& path, double startSec, double endSec) const
+    {
+        if (!(startSec >= 0.0) || !(endSec >= startSec))
+            throw std::invalid_argument("Invalid time range");
+        // deltas over the kept frames would need context counted in speech frames, not in time
+        if (_config.vad.mode == VadMode::Drop)
+            throw std::invalid_argument("Time ranges do not support VadMode::Drop; use VadMode::Floor");
+
+        auto stream = createAudioReader(path)->open(path);
+        const int inputRate = stream->sampleRate();
+        const int targetRate = _config.feature.sampleRate;
+        if (inputRate <= 0)
+            throw std::runtime_error("Invalid sample rate in " + path);
+
+        // framing runs at the input rate in native-rate mode, at the configured rate otherwise
+        const auto framing = nativeFraming(inputRate);
+        const bool native = framing.has_value();
+        const double scale = native ? framing->scale : 1.0;
+        const int workingRate = native ? inputRate : targetRate;
+        const int frameSize = native ? framing->frameSize : _config.framing.frameSize;
+        const int frameStep = native ? framing->frameStep : _config.framing.frameStep;
+        const auto step = static_cast<std::size_t>(frameStep);
+
+        const auto firstFrame = static_cast<std::size_t>(std::ceil(startSec * workingRate / frameStep));
+        const auto endFrame = static_cast<std::size_t>(std::ceil(endSec * workingRate / frameStep));
+        if (firstFrame >= endFrame)
+            return {};
+
+        // Frames of context on each side for the delta regression (applied twice for delta-deltas), and samples
+        // of history for pre-emphasis. At the file edges the clamping matches full-file extraction anyway.
+        // PNCC adds its medium-time window, and a warm-up before the range for its recursive trackers; the
+        // voice activity gate looks back over its hangover.
+        const bool pncc = _prototype.getOptions().compressionType == CompressionType::PowerNormalized;
+        const std::size_t deltaPasses = _config.delta.useDeltaDeltas ? 2 : _config.delta.useDeltas ? 1 : 0;
+        const std::size_t context = deltaPasses * static_cast<std::size_t>(std::max(2, _config.delta.regressionWindow)) +
+                                    (pncc ? PnccStage::kMediumWindow : 0);
+        const std::size_t warmup = (pncc ? kPnccWarmupFrames : 0) +
+                                   (_config.vad.mode != VadMode::Off ? static_cast<std::size_t>(
+                                        std::max(0, _config.vad.hangoverFrames)) : 0);
+        const std::size_t history = !_config.preemphasis.usePreEmphasis ? 0 : native ? static_cast<std::size_t>(scale) + 1 : 1;
+
+        const std::size_t contextBegin = firstFrame - std::min(firstFrame, context + warmup);
+        const std::size_t contextEnd = endFrame + context;
+        const std::size_t begin = contextBegin * step - std::min(contextBegin * step, history);
+        const std::size_t end = (contextEnd - 1) * step + static_cast<std::size_t>(frameSize);
 
-        AudioBuffer working = audio;
-        if (audio.sampleRate != _config.feature.sampleRate)
+        AudioBuffer working;
+        if (native || inputRate == targetRate)
         {
-            int targetSampleRate = _config.feature.sampleRate;
-            working = Resampler::resampleTo(audio, targetSampleRate);
+            stream->seek(begin);
+            working = readMono(*stream, end - begin);
         }
+        else
+        {
+            // window edges on multiples of the rate period, so output sample 0 of the window is exact
+            const auto divisor = static_cast<std::size_t>(std::gcd(inputRate, targetRate));
+            const std::size_t inPeriod = static_cast<std::size_t>(inputRate) / divisor;
+            const std::size_t outPeriod = static_cast<std::size_t>(targetRate) / divisor;
+            const std::size_t margin = Resampler::contextSamples(inputRate, targetRate);
 
-        if (working.samples.empty() || working.sampleRate != _config.feature.sampleRate)
-            throw std::invalid_argument("Resampling is failed");
+            const std::size_t alignedBegin = begin / outPeriod * inPeriod;
+            const std::size_t inBegin = alignedBegin - std::min(alignedBegin, margin);
+            const std::size_t inEnd = (end + outPeriod - 1) / outPeriod * inPeriod + margin;
+
+            stream->seek(inBegin);
+            const auto input = readMono(*stream, inEnd - inBegin);
+            if (input.samples.empty())
+                return {};
+            working = Resampler::resampleTo(input, targetRate);
+
+            const std::size_t skip = begin - inBegin / inPeriod * outPeriod;
+            const std::size_t available = working.samples.size() - std::min(working.samples.size(), skip);
+            const std::size_t keep = std::min(available, end - begin);
+            working.samples.erase(working.samples.begin(), working.samples.begin() + static_cast<std::ptrdiff_t>(skip));
+            working.samples.resize(keep);
+        }
 
         if (_config.preemphasis.usePreEmphasis)
-            applyPreEmphasis(working.samples, _config.preemphasis.preEmphasisCoeff);
+        {
+            if (native)
+                applyPreEmphasis(working.samples, _config.preemphasis.preEmphasisCoeff, scale);
+            else
+                applyPreEmphasis(working.samples, _config.preemphasis.preEmphasisCoeff);
+        }
+        // the history samples were only there to pre-emphasize the first frame
+        const std::size_t lead = std::min(working.samples.size(), contextBegin * step - begin);
+        working.samples.erase(working.samples.begin(), working.samples.begin() + static_cast<std::ptrdiff_t>(lead));
 
-        FixedFrameExtractor frameExtractor(_config.framing.frameSize, _config.framing.frameStep);
-        auto frames = frameExtractor.extract(working);
-        if (frames.empty())
-            return {};
+        Feature feature = _prototype;
+        if (native)
+        {
+            FFTTransformer transformer(static_cast<std::size_t>(frameSize));
+            WindowFunction window(frameSize, _config.framing.window);
+            feature.setPlan(makeNativePlan(_prototype, *framing, static_cast<int>(transformer.size())));
 
-        WindowFunction window(_config.framing.frameSize, _config.framing.window);
-        for (auto& frame : frames)
-            window.apply(frame.data);
+            const auto frames = frameSignal(working, frameSize, frameStep, window, {});
+            if (frames.empty())
+                return {};
+            computeFeature(feature, frames, transformer, {});
+        }
+        else
+        {
+            const auto frames = frameSignal(working, frameSize, frameStep, _window, {});
+            if (frames.empty())
+                return {};
+            computeFeature(feature, frames, _transformer, {});
+        }
 
-        FFTTransformer transformer;
-        buildOptions(working.sampleRate);
-        auto feature = FeatureFactory::createDefaultFeature(_config);
-        feature.compute(frames, transformer);
+        auto rows = feature.getComputedMatrix();
+        const std::size_t skipRows = std::min(rows.size(), firstFrame - contextBegin);
+        const std::size_t keepRows = std::min(rows.size() - skipRows, endFrame - firstFrame);
+        if (keepRows == 0)
+            return {};
+
+        FeatureMatrix range(std::make_move_iterator(rows.begin() + static_cast<std::ptrdiff_t>(skipRows)),
+                            std::make_move_iterator(rows.begin() + static_cast<std::ptrdiff_t>(skipRows + keepRows)));
+        feature.setComputedMatrix(std::move(range));
 
+        // speech frames counted from the start of the range
+        std::vector<std::size_t> voiced;
+        for (std::size_t frame : feature.getVoicedFrames())
+        {
+            if (frame >= skipRows && frame < skipRows + keepRows)
+                voiced.push_back(frame - skipRows);
+        }
+        feature.setVoicedFrames(std::move(voiced));
         return feature;
     }
 
-    AudioBuffer CepstralExtractor::loadAudio(const std::filesystem::path& path)
+    std::future<Feature> CepstralExtractor::extractAsync(const std::string& path, AsyncOptions options) const
+    {
+        auto promise = std::make_shared<std::promise<Feature>>();
+        auto future = promise->get_future();
+        extractAsync(path, std::move(options), [promise](Feature feature, std::exception_ptr error)
+        {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(std::move(feature));
+        });
+        return future;
+    }
+
+    std::future<Feature> CepstralExtractor::extractAsync(AudioBuffer audio, AsyncOptions options) const
+    {
+        auto promise = std::make_shared<std::promise<Feature>>();
+        auto future = promise->get_future();
+        extractAsync(std::move(audio), std::move(options), [promise](Feature feature, std::exception_ptr error)
+        {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(std::move(feature));
+        });
+        return future;
+    }
+
+    void CepstralExtractor::extractAsync(const std::string& path, AsyncOptions options, CompletionCallback onComplete) const
+    {
+        runAsync(std::move(options), std::move(onComplete), [this, path](const Checkpoint& checkpoint)
+        {
+            return extract(loadAudio(path, checkpoint), checkpoint);
+        });
+    }
+
+    void CepstralExtractor::extractAsync(AudioBuffer audio, AsyncOptions options, CompletionCallback onComplete) const
     {
-        const auto extStr = path.extension().string();
-        std::string ext;
-        ext.resize(extStr.size());
-        std::transform(extStr.begin(), extStr.end(), ext.begin(), [](unsigned char c)
+        runAsync(std::move(options), std::move(onComplete), [this, audio = std::move(audio)](const Checkpoint& checkpoint)
         {
-            return static_cast<char>(std::tolower(c));
+            return extract(audio, checkpoint);
+        });
+    }
+
+    void CepstralExtractor::runAsync(AsyncOptions options, CompletionCallback onComplete,
+                                     std::function<Feature(const Checkpoint&)> work) const
+    {
+        if (!onComplete)
+            throw std::invalid_argument("Completion callback is empty");
+
+        Executor executor = options.executor;
+        if (!executor)
+            executor = poolExecutor(_pool ? *_pool : sharedAsyncPool());
+
+        const auto cancellation = options.cancellation;
+        const auto deadline = options.deadline;
+        executor([cancellation, deadline, onComplete = std::move(onComplete), work = std::move(work)]()
+        {
+            const Checkpoint checkpoint = [&cancellation, &deadline]()
+            {
+                throwIfStopped(cancellation, deadline);
+            };
+
+            Feature feature;
+            std::exception_ptr error;
+            try
+            {
+                checkpoint();
+                feature = work(checkpoint);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            onComplete(std::move(feature), error);
         });
+    }
+
+    Feature CepstralExtractor::extract(const AudioBuffer& audio, const Checkpoint& checkpoint) const
+    {
+        if (const auto framing = nativeFraming(audio.sampleRate))
+            return extractAtNativeRate(audio, *framing, checkpoint);
+
+        const auto frames = extractFrames(audio, checkpoint);
+        if (frames.empty())
+            return {};
 
-        if (ext == ".wav")
+        auto feature = _prototype;
+        computeFeature(feature, frames, _transformer, checkpoint);
+        return feature;
+    }
+
+    void CepstralExtractor::computeFeature(Feature& feature, const std::vector<Frame>& frames,
+                                           const FFTTransformer& transformer, const Checkpoint& checkpoint) const
+    {
+        if (!checkpoint)
         {
-            WavAudioReader reader;
-            return reader.load(path);
+            if (_pool)
+                feature.compute(frames, transformer, *_pool);
+            else
+                feature.compute(frames, transformer);
+            return;
         }
-        if (ext == ".mp3")
+
+        checkpoint();
+        feature.prepare(transformer, frames.front());
+        const auto voiced = feature.detectVoiceActivity(frames);
+
+        const std::size_t blocks = (frames.size() + kCheckpointFrames - 1) / kCheckpointFrames;
+        FeatureMatrix rows(frames.size());
+        const auto computeBlocks = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                checkpoint();
+                const std::size_t first = b * kCheckpointFrames;
+                auto block = feature.computeFrames(frames, first, std::min(frames.size(), first + kCheckpointFrames),
+                                                   transformer, voiced);
+                std::move(block.begin(), block.end(), rows.begin() + static_cast<std::ptrdiff_t>(first));
+            }
+        };
+
+        if (_pool)
+            _pool->parallelFor(0, blocks, computeBlocks, 1);
+        else
+            computeBlocks(0, blocks);
+
+        checkpoint();
+        if (_pool)
+            feature.finish(std::move(rows), voiced, *_pool);
+        else
+            feature.finish(std::move(rows), voiced);
+    }
+
+    std::vector<Feature> CepstralExtractor::extractChannelsFromFile(const std::string& path) const
+    {
+        const auto buffer = createAudioReader(path)->loadChannels(path);
+        return extractFromMultichannelBuffer(buffer);
+    }
+
+    std::vector<Feature> CepstralExtractor::extractFromMultichannelBuffer(const MultichannelAudioBuffer& audio) const
+    {
+        std::vector<Feature> out(audio.channels.size());
+
+        const auto extractRange = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; ++c)
+            {
+                AudioBuffer channel;
+                channel.samples = audio.channels[c];
+                channel.sampleRate = audio.sampleRate;
+                out[c] = extractFromAudioBuffer(channel);
+            }
+        };
+
+        if (_pool)
+            _pool->parallelFor(0, audio.channels.size(), extractRange, 1);
+        else
+            extractRange(0, audio.channels.size());
+
+        return out;
+    }
+
+    std::vector<Frame> CepstralExtractor::extractFrames(const AudioBuffer& audio) const
+    {
+        return extractFrames(audio, {});
+    }
+
+    std::vector<Frame> CepstralExtractor::extractFrames(const AudioBuffer& audio, const Checkpoint& checkpoint) const
+    {
+        AudioBuffer working = audio.sampleRate != _config.feature.sampleRate ? resampleAudio(audio, checkpoint)
+                                                                             : copyAudio(audio, checkpoint);
+
+        if (working.samples.empty() || working.sampleRate != _config.feature.sampleRate)
+            throw std::invalid_argument("Resampling is failed");
+
+        if (_config.preemphasis.usePreEmphasis)
+            applyPreEmphasis(working.samples, _config.preemphasis.preEmphasisCoeff, checkpoint);
+
+        return frameSignal(working, _config.framing.frameSize, _config.framing.frameStep, _window, checkpoint);
+    }
+
+    AudioBuffer CepstralExtractor::resampleAudio(const AudioBuffer& audio, const Checkpoint& checkpoint) const
+    {
+        const int targetSampleRate = _config.feature.sampleRate;
+        if (_pool && _config.threading.chunkedResampling)
+            return Resampler::resampleTo(audio, targetSampleRate, *_pool, 0, checkpoint);
+        if (audio.sampleRate <= 0 || audio.samples.empty())
+            return Resampler::resampleTo(audio, targetSampleRate);
+
+        AudioBuffer out;
+        out.sampleRate = targetSampleRate;
+        out.samples.reserve(static_cast<std::size_t>(static_cast<double>(audio.samples.size()) * targetSampleRate /
+                                                     audio.sampleRate) + 1);
+
+        StreamingResampler resampler(audio.sampleRate, targetSampleRate);
+        for (std::size_t offset = 0; offset < audio.samples.size(); offset += kCheckpointSamples)
         {
-            Mp3AudioReader reader;
-            return reader.load(path);
+            if (checkpoint)
+                checkpoint();
+            const std::size_t count = std::min(kCheckpointSamples, audio.samples.size() - offset);
+            resampler.process(audio.samples.data() + offset, count, offset + count == audio.samples.size(),
+                              out.samples);
         }
+        return out;
+    }
 
-        throw std::invalid_argument("Unsupported audio format: " + path.string());
+    AudioBuffer CepstralExtractor::copyAudio(const AudioBuffer& audio, const Checkpoint& checkpoint)
+    {
+        if (!checkpoint)
+            return audio;
+
+        AudioBuffer copy;
+        copy.sampleRate = audio.sampleRate;
+        copy.samples.reserve(audio.samples.size());
+        for (std::size_t offset = 0; offset < audio.samples.size(); offset += kCheckpointSamples)
+        {
+            checkpoint();
+            const auto first = audio.samples.begin() + static_cast<std::ptrdiff_t>(offset);
+            const auto count = static_cast<std::ptrdiff_t>(std::min(kCheckpointSamples, audio.samples.size() - offset));
+            copy.samples.insert(copy.samples.end(), first, first + count);
+        }
+        return copy;
     }
 
-    void CepstralExtractor::applyPreEmphasis(std::vector<float>& samples, float coeff)
+    std::vector<Frame> CepstralExtractor::frameSignal(const AudioBuffer& audio, int frameSize, int frameStep,
+                                                      const WindowFunction& window, const Checkpoint& checkpoint)
+    {
+        std::vector<Frame> frames;
+        if (!checkpoint)
+        {
+            FixedFrameExtractor frameExtractor(frameSize, frameStep);
+            frames = frameExtractor.extract(audio);
+            for (auto& frame : frames)
+                window.apply(frame.data);
+            return frames;
+        }
+
+        // same frame positions as the batch extractor, produced slice by slice
+        StreamingFrameExtractor frameExtractor(frameSize, frameStep);
+        for (std::size_t offset = 0; offset < audio.samples.size(); offset += kCheckpointSamples)
+        {
+            checkpoint();
+            const std::size_t first = frames.size();
+            const std::size_t count = std::min(kCheckpointSamples, audio.samples.size() - offset);
+            frameExtractor.push(audio.samples.data() + offset, count, frames);
+            for (std::size_t i = first; i < frames.size(); ++i)
+                window.apply(frames[i].data);
+        }
+        return frames;
+    }
+
+    std::optional<CepstralExtractor::NativeFraming> CepstralExtractor::nativeFraming(int inputSampleRate) const
+    {
+        if (!_config.resampling.nativeRate || inputSampleRate <= _config.feature.sampleRate)
+            return std::nullopt;
+
+        NativeFraming framing;
+        framing.sampleRate = inputSampleRate;
+        framing.scale = static_cast<double>(inputSampleRate) / static_cast<double>(_config.feature.sampleRate);
+        framing.frameSize = std::max(1, static_cast<int>(std::lround(_config.framing.frameSize * framing.scale)));
+        framing.frameStep = std::max(1, static_cast<int>(std::lround(_config.framing.frameStep * framing.scale)));
+        return framing;
+    }
+
+    std::vector<Frame> CepstralExtractor::extractNativeFrames(const AudioBuffer& audio,
+                                                              const NativeFraming& framing) const
+    {
+        return extractNativeFrames(audio, framing, WindowFunction(framing.frameSize, _config.framing.window), {});
+    }
+
+    std::vector<Frame> CepstralExtractor::extractNativeFrames(const AudioBuffer& audio, const NativeFraming& framing,
+                                                              const WindowFunction& window,
+                                                              const Checkpoint& checkpoint) const
+    {
+        AudioBuffer working = copyAudio(audio, checkpoint);
+        if (_config.preemphasis.usePreEmphasis)
+            applyPreEmphasis(working.samples, _config.preemphasis.preEmphasisCoeff, framing.scale, checkpoint);
+
+        return frameSignal(working, framing.frameSize, framing.frameStep, window, checkpoint);
+    }
+
+    Feature CepstralExtractor::extractAtNativeRate(const AudioBuffer& audio, const NativeFraming& framing,
+                                                   const Checkpoint& checkpoint) const
+    {
+        FFTTransformer transformer(static_cast<std::size_t>(framing.frameSize));
+        WindowFunction window(framing.frameSize, _config.framing.window);
+
+        auto feature = _prototype;
+        feature.setPlan(makeNativePlan(_prototype, framing, static_cast<int>(transformer.size())));
+
+        const auto frames = extractNativeFrames(audio, framing, window, checkpoint);
+        if (frames.empty())
+            return {};
+
+        computeFeature(feature, frames, transformer, checkpoint);
+        return feature;
+    }
+
+    std::shared_ptr<const FeaturePlan> CepstralExtractor::makeNativePlan(const Feature& feature,
+                                                                         const NativeFraming& framing, int nFft) const
+    {
+        const auto reference = feature.getPlan() ? feature.getPlan()
+                                                 : feature.makePlan(static_cast<int>(_transformer.size()));
+
+        // same frequency range as the reference plan, so e.g. maxFreq stays at the configured Nyquist
+        auto options = reference->options;
+        options.sampleRate = framing.sampleRate;
+
+        auto native = feature;
+        native.setOptions(options);
+        auto plan = std::make_shared<FeaturePlan>(*native.makePlan(nFft));
+
+        // A band sum approximates the integral of |X(f)| over the band divided by the bin spacing, and |X(f)|
+        // grows with the frame length; together the band energies grow by nFft / referenceNFft. Band powers
+        // (sums of |X|^2) grow by the square of that.
+        const double ratio = static_cast<double>(reference->nFft) / static_cast<double>(nFft);
+        const double gain = plan->powerSpectrum ? ratio * ratio : ratio;
+        for (auto& filter : plan->filters)
+            for (auto& weight : filter)
+                weight *= gain;
+
+        plan->energyScale = static_cast<double>(_config.framing.frameSize) / static_cast<double>(framing.frameSize);
+        return plan;
+    }
+
+    AudioBuffer CepstralExtractor::loadAudio(const std::filesystem::path& path, const Checkpoint& checkpoint)
+    {
+        auto reader = createAudioReader(path);
+        if (!checkpoint)
+            return reader->load(path);
+
+        auto stream = reader->open(path);
+        return readAllMono(*stream, checkpoint);
+    }
+
+    void CepstralExtractor::applyPreEmphasis(std::vector<float>& samples, float coeff, const Checkpoint& checkpoint)
     {
         if (samples.empty())
         {
             return;
         }
 
-        std::vector<float> emphasized(samples.size());
-        emphasized[0] = samples[0];
-        for (std::size_t i = 1; i < samples.size(); ++i)
+        // in place, carrying the previous input sample
+        float previous = samples[0];
+        for (std::size_t block = 1; block < samples.size(); block += kCheckpointSamples)
         {
-            emphasized[i] = samples[i] - coeff * samples[i - 1];
+            if (checkpoint)
+                checkpoint();
+
+            const std::size_t end = std::min(samples.size(), block + kCheckpointSamples);
+            for (std::size_t i = block; i < end; ++i)
+            {
+                const float current = samples[i];
+                samples[i] = current - coeff * previous;
+                previous = current;
+            }
         }
-        samples.swap(emphasized);
     }
 
-    void CepstralExtractor::buildOptions(int sampleRate)
+    void CepstralExtractor::applyPreEmphasis(std::vector<float>& samples, float coeff, double delay,
+                                             const Checkpoint& checkpoint)
     {
-        _options.sampleRate = sampleRate;
-        _options.numCoeffs = _config.feature.numCoeffs;
-        _options.numFilters = _config.feature.numFilters;
-        _options.minFreq = _config.feature.minFreq;
-        _options.maxFreq = _config.feature.maxFreq > 0.0f
-                               ? _config.feature.maxFreq
-                               : static_cast<float>(sampleRate) / 2.0f;
-        _options.includeEnergy = _config.feature.includeEnergy;
-        _options.filterbank = _config.feature.filterbank;
-        _options.melScale = _config.feature.melScale;
-        _options.compressionType = _config.feature.compressionType;
+        if (samples.empty())
+        {
+            return;
+        }
+
+        // y[n] = x[n] - coeff * x[n - delay], with the fractional delay read by linear interpolation
+        const auto whole = static_cast<std::size_t>(delay);
+        const auto frac = static_cast<float>(delay - static_cast<double>(whole));
+
+        // in place from the end, so the delayed inputs are still unmodified when read
+        for (std::size_t blockEnd = samples.size(); blockEnd > 0;)
+        {
+            if (checkpoint)
+                checkpoint();
+
+            const std::size_t blockBegin = blockEnd - std::min(blockEnd, kCheckpointSamples);
+            for (std::size_t i = blockEnd; i-- > blockBegin;)
+            {
+                const float near = i >= whole ? samples[i - whole] : 0.0f;
+                const float far = i >= whole + 1 ? samples[i - whole - 1] : 0.0f;
+                samples[i] = samples[i] - coeff * (near + frac * (far - near));
+            }
+            blockEnd = blockBegin;
+        }
     }
 }
@@ -0,0 +1,179 @@
+#include "libvoicefeat/multi_feature_extractor.h"
+
+#include "libvoicefeat/audio/audio_reader.h"
+#include "libvoicefeat/features/feature_builder.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+
+namespace libvoicefeat
+{
+    namespace
+    {
+        std::shared_ptr<ThreadPool> makePool(const CepstralConfig& config)
+        {
+            if (config.threading.numThreads > 1)
+                return std::make_shared<ThreadPool>(static_cast<std::size_t>(config.threading.numThreads));
+            return nullptr;
+        }
+    }
+
+    MultiFeatureExtractor::MultiFeatureExtractor(const CepstralConfig& config, const std::vector<CepstralType>& types)
+        : MultiFeatureExtractor(config, types, makePool(config))
+    {
+    }
+
+    MultiFeatureExtractor::MultiFeatureExtractor(const CepstralConfig& config, const std::vector<CepstralType>& types,
+                                                 std::shared_ptr<ThreadPool> pool)
+        : _frontEnd(config, std::move(pool))
+    {
+        if (types.empty())
+            throw std::invalid_argument("At least one cepstral type is required");
+        for (auto type = types.begin(); type != types.end(); ++type)
+            if (std::find(types.begin(), type, *type) != type)
+                throw std::invalid_argument("Each cepstral type may be requested only once");
+
+        const int nFft = static_cast<int>(_frontEnd.getTransformer().size());
+        for (auto type : types)
+        {
+            CepstralConfig headConfig = config;
+            headConfig.type = type;
+
+            auto head = FeatureFactory::createDefaultFeature(headConfig);
+            head.setPlan(head.makePlan(nFft));
+            _heads.push_back(std::move(head));
+        }
+
+        _spectra = groupSpectra(_heads);
+    }
+
+    std::vector<MultiFeatureExtractor::SpectrumGroup>
+    MultiFeatureExtractor::groupSpectra(const std::vector<Feature>& heads)
+    {
+        std::vector<SpectrumGroup> spectra;
+
+        // A bin's value depends only on the method, so widening a pruned range leaves every head's bins as is.
+        // A head joins a group only while the union still prunes with that method, which is also the one the
+        // cost model picks for the union; Goertzel pays per bin, so its ranges must touch to share.
+        for (std::size_t h = 0; h < heads.size(); ++h)
+        {
+            const auto& plan = *heads[h].getPlan();
+            const auto joins = [&](const SpectrumGroup& group)
+            {
+                if (!plan.pruned || !group.pruned)
+                    return !plan.pruned && !group.pruned;
+
+                const auto method = plan.pruned->getMethod();
+                const std::size_t size = plan.pruned->size();
+                const std::size_t begin = std::min(group.binBegin, plan.binBegin);
+                const std::size_t end = std::max(group.binEnd, plan.binEnd);
+                const bool touching = plan.binBegin <= group.binEnd && group.binBegin <= plan.binEnd;
+                return group.pruned->getMethod() == method && dsp::PrunedTransformer::worthPruning(size, begin, end) &&
+                       dsp::PrunedTransformer::cheaperMethod(size, begin, end) == method &&
+                       (method == dsp::PrunedTransformer::Method::HalfLength || touching);
+            };
+
+            auto group = std::find_if(spectra.begin(), spectra.end(), joins);
+            if (group == spectra.end())
+            {
+                spectra.push_back({plan.pruned, plan.binBegin, plan.binEnd, {}});
+                group = std::prev(spectra.end());
+            }
+            group->binBegin = std::min(group->binBegin, plan.binBegin);
+            group->binEnd = std::max(group->binEnd, plan.binEnd);
+            group->heads.push_back(h);
+        }
+        for (auto& group : spectra)
+        {
+            const bool widened = group.pruned && (group.pruned->getBinBegin() != group.binBegin ||
+                                                  group.pruned->getBinEnd() != group.binEnd);
+            if (widened)
+                group.pruned = std::make_shared<dsp::PrunedTransformer>(group.pruned->size(), group.binBegin,
+                                                                        group.binEnd, group.pruned->getMethod());
+        }
+        return spectra;
+    }
+
+    std::map<CepstralType, Feature> MultiFeatureExtractor::extractFromFile(const std::string& path) const
+    {
+        const auto buffer = createAudioReader(path)->load(path);
+        return extractFromAudioBuffer(buffer);
+    }
+
+    std::map<CepstralType, Feature> MultiFeatureExtractor::extractFromAudioBuffer(const AudioBuffer& audio) const
+    {
+        std::map<CepstralType, Feature> out;
+        std::vector<Feature> heads = _heads;
+
+        // native-rate input gets its own transform, plans and spectrum groups, as CepstralExtractor builds them
+        const auto framing = _frontEnd.nativeFraming(audio.sampleRate);
+        std::optional<FFTTransformer> nativeTransformer;
+        std::vector<SpectrumGroup> nativeSpectra;
+        if (framing)
+        {
+            nativeTransformer.emplace(static_cast<std::size_t>(framing->frameSize));
+            for (auto& head : heads)
+                head.setPlan(_frontEnd.makeNativePlan(head, *framing, static_cast<int>(nativeTransformer->size())));
+            nativeSpectra = groupSpectra(heads);
+        }
+
+        const auto frames = framing ? _frontEnd.extractNativeFrames(audio, *framing) : _frontEnd.extractFrames(audio);
+        if (frames.empty())
+        {
+            for (const auto& head : _heads)
+                out.emplace(head.getCepstralType(), Feature{});
+            return out;
+        }
+
+        const auto& transformer = framing ? *nativeTransformer : _frontEnd.getTransformer();
+        const auto& spectra = framing ? nativeSpectra : _spectra;
+        for (auto& head : heads)
+            head.prepare(static_cast<int>(transformer.size()));
+
+        const int nFreqs = heads.front().getPlan()->nFreqs;
+        std::vector<FeatureMatrix> rows(heads.size(), FeatureMatrix(frames.size()));
+        // the heads share the config, so one gate decides for all of them
+        const auto voiced = heads.front().detectVoiceActivity(frames);
+
+        const auto computeRange = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                if (!voiced.empty() && !voiced[i])
+                {
+                    for (std::size_t h = 0; h < heads.size(); ++h)
+                        rows[h][i] = heads[h].getPlan()->silence;
+                    continue;
+                }
+                for (const auto& group : spectra)
+                {
+                    const bool pruned = group.pruned && group.pruned->coversFrame(frames[i].data.size());
+                    const auto spec = pruned ? group.pruned->transform(frames[i].data)
+                                             : transformer.transform(frames[i].data);
+                    const auto mag = Feature::magnitudeSpectrum(spec, nFreqs, group.binBegin, group.binEnd);
+                    for (std::size_t h : group.heads)
+                        rows[h][i] = heads[h].computeFromSpectrum(frames[i], mag);
+                }
+            }
+        };
+
+        const auto& pool = _frontEnd.getThreadPool();
+        if (pool)
+            pool->parallelFor(0, frames.size(), computeRange);
+        else
+            computeRange(0, frames.size());
+
+        for (std::size_t h = 0; h < heads.size(); ++h)
+        {
+            if (pool)
+                heads[h].finish(std::move(rows[h]), voiced, *pool);
+            else
+                heads[h].finish(std::move(rows[h]), voiced);
+            out[heads[h].getCepstralType()] = std::move(heads[h]);
+        }
+
+        return out;
+    }
+}
@@ -0,0 +1,393 @@
+#include "libvoicefeat/pipeline_extractor.h"
+
+#include "libvoicefeat/audio/audio_reader.h"
+#include "libvoicefeat/dsp/fft_transformer.h"
+#include "libvoicefeat/dsp/frame_extractor.h"
+#include "libvoicefeat/dsp/resampler.h"
+#include "libvoicefeat/dsp/voice_activity.h"
+#include "libvoicefeat/dsp/window_functiion.h"
+#include "libvoicefeat/features/delta.h"
+#include "libvoicefeat/features/feature_builder.h"
+#include "libvoicefeat/utils/bounded_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace libvoicefeat
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double secondsSince(Clock::time_point start)
+        {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        struct FrameBlock
+        {
+            std::size_t firstFrame = 0;
+            std::vector<Frame> frames;
+            std::vector<bool> voiced;           // voice activity per frame, empty when the gate is off
+        };
+
+        struct RowBlock
+        {
+            std::size_t firstFrame = 0;
+            FeatureMatrix rows;
+            std::vector<bool> voiced;
+        };
+    }
+
+    PipelineExtractor::PipelineExtractor(const CepstralConfig& config, const PipelineOptions& options)
+        : _config(config)
+        , _frontEnd(config, nullptr)
+        , _options(options)
+    {
+    }
+
+    Feature PipelineExtractor::extractFromFile(const std::string& path)
+    {
+        auto feature = FeatureFactory::createDefaultFeature(_config);
+        std::vector<RowBlock> rowBlocks;
+        run(path, feature, [&](std::size_t firstFrame, FeatureMatrix rows, std::vector<bool> voiced)
+        {
+            rowBlocks.push_back(RowBlock{firstFrame, std::move(rows), std::move(voiced)});
+        });
+
+        if (rowBlocks.empty())
+            return {};
+
+        const auto finishStart = Clock::now();
+        std::sort(rowBlocks.begin(), rowBlocks.end(), [](const RowBlock& a, const RowBlock& b)
+        {
+            return a.firstFrame < b.firstFrame;
+        });
+
+        FeatureMatrix rows;
+        std::vector<bool> voiced;
+        rows.reserve(rowBlocks.back().firstFrame + rowBlocks.back().rows.size());
+        for (auto& block : rowBlocks)
+        {
+            rows.insert(rows.end(), std::make_move_iterator(block.rows.begin()),
+                        std::make_move_iterator(block.rows.end()));
+            voiced.insert(voiced.end(), block.voiced.begin(), block.voiced.end());
+        }
+        feature.finish(std::move(rows), voiced);
+
+        _stats.wallSeconds += secondsSince(finishStart);
+        return feature;
+    }
+
+    std::size_t PipelineExtractor::extractFromFile(const std::string& path, const RowSink& sink)
+    {
+        auto feature = FeatureFactory::createDefaultFeature(_config);
+        StreamingDeltas deltas(_config.delta.useDeltas, _config.delta.useDeltaDeltas);
+        std::optional<StreamingCepstra> cepstra;    // the feature is prepared before the first block arrives
+        FeatureMatrix completed;
+
+        // blocks finish out of order; hold the early ones until the gap before them is filled
+        std::map<std::size_t, RowBlock> waiting;
+        const bool dropSilence = _config.vad.mode == VadMode::Drop;
+        std::size_t nextFrame = 0;
+        std::size_t delivered = 0;
+        FeatureMatrix ready;
+
+        const auto deliver = [&]()
+        {
+            for (const auto& row : ready)
+                sink(row);
+            delivered += ready.size();
+            ready.clear();
+        };
+
+        run(path, feature, [&](std::size_t firstFrame, FeatureMatrix rows, std::vector<bool> voiced)
+        {
+            if (!cepstra)
+                cepstra.emplace(feature);
+
+            waiting.emplace(firstFrame, RowBlock{firstFrame, std::move(rows), std::move(voiced)});
+            for (auto it = waiting.begin(); it != waiting.end() && it->first == nextFrame; it = waiting.erase(it))
+            {
+                auto& block = it->second;
+                nextFrame += block.rows.size();
+                for (std::size_t i = 0; i < block.rows.size(); ++i)
+                {
+                    if (!dropSilence || block.voiced[i])
+                        cepstra->push(std::move(block.rows[i]), completed);
+                }
+            }
+            for (auto& row : completed)
+                deltas.push(std::move(row), ready);
+            completed.clear();
+            deliver();
+        });
+
+        if (cepstra)
+            cepstra->finish(completed);
+        for (auto& row : completed)
+            deltas.push(std::move(row), ready);
+        deltas.finish(ready);
+        deliver();
+        return delivered;
+    }
+
+    void PipelineExtractor::run(const std::string& path, Feature& feature, const BlockSink& onBlock)
+    {
+        _stats = {};
+        const auto wallStart = Clock::now();
+
+        auto stream = createAudioReader(path)->open(path);
+        const int inputRate = stream->sampleRate();
+        const int targetRate = _config.feature.sampleRate;
+        const int channels = stream->channels();
+
+        // native-rate input is framed at its own rate instead of being resampled
+        const auto native = _frontEnd.nativeFraming(inputRate);
+        const int workingRate = native ? inputRate : targetRate;
+        const int frameSize = native ? native->frameSize : _config.framing.frameSize;
+        const int frameStep = native ? native->frameStep : _config.framing.frameStep;
+
+        const std::size_t blockFrames = std::max<std::size_t>(1, _options.decodeBlockFrames);
+        const std::size_t framesPerBlock = std::max<std::size_t>(1, _options.framesPerBlock);
+        const int extractThreads = std::max(1, _options.extractThreads);
+
+        utils::BoundedQueue<std::vector<float>> decoded(_options.queueCapacity);
+        utils::BoundedQueue<FrameBlock> framed(_options.queueCapacity);
+
+        const FFTTransformer transformer(static_cast<std::size_t>(frameSize));
+        const WindowFunction window(frameSize, _config.framing.window);
+        if (native)
+            feature.setPlan(_frontEnd.makeNativePlan(feature, *native, static_cast<int>(transformer.size())));
+
+        std::mutex mutex;
+        std::exception_ptr firstError;
+        std::size_t resampledSamples = 0;
+
+        const auto fail = [&](std::exception_ptr error)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!firstError)
+                    firstError = error;
+            }
+            decoded.close();
+            framed.close();
+        };
+
+        std::thread decodeThread([&]()
+        {
+            try
+            {
+                std::vector<float> interleaved(blockFrames * channels);
+                while (true)
+                {
+                    const auto busyStart = Clock::now();
+                    const std::size_t frames = stream->read(interleaved.data(), blockFrames);
+                    if (frames == 0)
+                        break;
+
+                    std::vector<float> mono(frames);
+                    downmixToMono(interleaved.data(), frames, channels, mono.data());
+                    _stats.decode.busySeconds += secondsSince(busyStart);
+                    _stats.decode.items += frames;
+                    ++_stats.decode.blocks;
+
+                    if (!decoded.push(std::move(mono)))
+                        break;
+                }
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+            decoded.close();
+        });
+
+        std::thread resampleThread([&]()
+        {
+            try
+            {
+                std::optional<StreamingResampler> resampler;
+                if (!native && inputRate != targetRate)
+                    resampler.emplace(inputRate, targetRate);
+
+                StreamingFrameExtractor framer(frameSize, frameStep);
+                const bool usePreEmphasis = _config.preemphasis.usePreEmphasis;
+                const float coeff = _config.preemphasis.preEmphasisCoeff;
+                bool firstSample = true;
+                float previous = 0.f;
+
+                // native rate: y[n] = x[n] - coeff * x[n - scale], linearly interpolated like
+                // CepstralExtractor's, with the input before the block carried over (zeros before the start)
+                const auto whole = static_cast<std::size_t>(native ? native->scale : 1.0);
+                const auto frac = static_cast<float>(native ? native->scale - static_cast<double>(whole) : 0.0);
+                std::vector<float> history(whole + 1, 0.f);
+
+                FrameBlock pending;
+                bool prepared = false;
+
+                // frames reach this stage in signal order, which the detector's hangover relies on
+                std::optional<VoiceActivityDetector> vad;
+                if (_config.vad.mode != VadMode::Off)
+                    vad.emplace(_config.vad, workingRate);
+
+                const auto emit = [&](FrameBlock& block)
+                {
+                    if (block.frames.empty())
+                        return true;
+                    if (!prepared)
+                    {
+                        // filters are built once here, before any extract thread can see a frame
+                        feature.prepare(transformer, block.frames.front());
+                        prepared = true;
+                    }
+                    if (vad)
+                    {
+                        for (const auto& frame : block.frames)
+                            block.voiced.push_back(vad->push(frame));
+                    }
+
+                    const std::size_t next = block.firstFrame + block.frames.size();
+                    ++_stats.resample.blocks;
+                    const bool pushed = framed.push(std::move(block));
+                    block = FrameBlock{next, {}, {}};
+                    return pushed;
+                };
+
+                const auto consume = [&](std::vector<float>& samples)
+                {
+                    resampledSamples += samples.size();
+                    _stats.resample.items += samples.size();
+
+                    if (usePreEmphasis && native)
+                    {
+                        const std::size_t reach = history.size();
+                        history.insert(history.end(), samples.begin(), samples.end());
+                        for (std::size_t i = 0; i < samples.size(); ++i)
+                        {
+                            const float near = history[reach + i - whole];
+                            const float far = history[reach + i - whole - 1];
+                            samples[i] = samples[i] - coeff * (near + frac * (far - near));
+                        }
+                        history.erase(history.begin(), history.end() - static_cast<std::ptrdiff_t>(reach));
+                    }
+                    else if (usePreEmphasis)
+                    {
+                        for (auto& s : samples)
+                        {
+                            const float current = s;
+                            if (!firstSample)
+                                s = current - coeff * previous;
+                            previous = current;
+                            firstSample = false;
+                        }
+                    }
+
+                    const std::size_t before = pending.frames.size();
+                    framer.push(samples.data(), samples.size(), pending.frames);
+                    for (std::size_t i = before; i < pending.frames.size(); ++i)
+                        window.apply(pending.frames[i].data);
+                };
+
+                while (auto block = decoded.pop())
+                {
+                    const auto busyStart = Clock::now();
+                    std::vector<float> out;
+                    if (resampler)
+                        resampler->process(*block, false, out);
+                    else
+                        out = std::move(*block);
+                    consume(out);
+                    _stats.resample.busySeconds += secondsSince(busyStart);
+
+                    while (pending.frames.size() >= framesPerBlock)
+                    {
+                        FrameBlock full{pending.firstFrame, {}, {}};
+                        full.frames.assign(std::make_move_iterator(pending.frames.begin()),
+                                           std::make_move_iterator(pending.frames.begin() + framesPerBlock));
+                        pending.frames.erase(pending.frames.begin(), pending.frames.begin() + framesPerBlock);
+                        pending.firstFrame += framesPerBlock;
+                        if (!emit(full))
+                            return;
+                    }
+                }
+
+                if (resampler)
+                {
+                    const auto busyStart = Clock::now();
+                    std::vector<float> out;
+                    resampler->process({}, true, out);
+                    consume(out);
+                    _stats.resample.busySeconds += secondsSince(busyStart);
+                }
+                emit(pending);
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+            framed.close();
+        });
+
+        std::vector<std::thread> extractWorkers;
+        extractWorkers.reserve(static_cast<std::size_t>(extractThreads));
+        for (int t = 0; t < extractThreads; ++t)
+        {
+            extractWorkers.emplace_back([&]()
+            {
+                StageStats local;
+                try
+                {
+                    while (auto block = framed.pop())
+                    {
+                        const auto busyStart = Clock::now();
+                        auto rows = feature.computeFrames(block->frames, 0, block->frames.size(), transformer,
+                                                          block->voiced);
+                        local.busySeconds += secondsSince(busyStart);
+                        local.items += rows.size();
+                        ++local.blocks;
+
+                        std::lock_guard<std::mutex> lock(mutex);
+                        onBlock(block->firstFrame, std::move(rows), std::move(block->voiced));
+                    }
+                }
+                catch (...)
+                {
+                    fail(std::current_exception());
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                _stats.extract.blocks += local.blocks;
+                _stats.extract.items += local.items;
+                _stats.extract.busySeconds += local.busySeconds;
+            });
+        }
+
+        decodeThread.join();
+        resampleThread.join();
+        for (auto& worker : extractWorkers)
+            worker.join();
+
+        _stats.resample.maxQueueDepth = decoded.maxDepth();
+        _stats.resample.meanQueueDepth = decoded.meanDepth();
+        _stats.extract.maxQueueDepth = framed.maxDepth();
+        _stats.extract.meanQueueDepth = framed.meanDepth();
+
+        if (firstError)
+            std::rethrow_exception(firstError);
+
+        if (resampledSamples == 0)
+            throw std::invalid_argument("Resampling is failed");
+
+        _stats.wallSeconds = secondsSince(wallStart);
+    }
+}
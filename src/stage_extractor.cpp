@@ -0,0 +1,140 @@
+#include "libvoicefeat/stage_extractor.h"
+
+#include "libvoicefeat/audio/audio_reader.h"
+#include "libvoicefeat/features/feature_builder.h"
+#include "libvoicefeat/features/pncc.h"
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace libvoicefeat
+{
+    namespace
+    {
+        std::shared_ptr<ThreadPool> makePool(const CepstralConfig& config)
+        {
+            if (config.threading.numThreads > 1)
+                return std::make_shared<ThreadPool>(static_cast<std::size_t>(config.threading.numThreads));
+            return nullptr;
+        }
+
+        FeatureVector toRow(const std::vector<double>& values)
+        {
+            return FeatureVector(values.begin(), values.end());
+        }
+    }
+
+    StageExtractor::StageExtractor(const CepstralConfig& config, const StageSelection& stages)
+        : StageExtractor(config, stages, makePool(config))
+    {
+    }
+
+    StageExtractor::StageExtractor(const CepstralConfig& config, const StageSelection& stages,
+                                   std::shared_ptr<ThreadPool> pool)
+        : _frontEnd(config, std::move(pool)), _stages(stages)
+    {
+        if (!stages.powerSpectrum && !stages.filterbankEnergies && !stages.compressedEnergies && !stages.cepstra)
+            throw std::invalid_argument("At least one stage is required");
+
+        _prototype = FeatureFactory::createDefaultFeature(config);
+        _prototype.setPlan(_prototype.makePlan(static_cast<int>(_frontEnd.getTransformer().size())));
+    }
+
+    StageMatrices StageExtractor::extractFromFile(const std::string& path) const
+    {
+        const auto buffer = createAudioReader(path)->load(path);
+        return extractFromAudioBuffer(buffer);
+    }
+
+    StageMatrices StageExtractor::extractFromAudioBuffer(const AudioBuffer& audio) const
+    {
+        StageMatrices out;
+        Feature feature = _prototype;
+
+        // native-rate input is framed, transformed and planned at its own rate, as CepstralExtractor does it
+        const auto framing = _frontEnd.nativeFraming(audio.sampleRate);
+        std::optional<FFTTransformer> nativeTransformer;
+        if (framing)
+        {
+            nativeTransformer.emplace(static_cast<std::size_t>(framing->frameSize));
+            feature.setPlan(_frontEnd.makeNativePlan(feature, *framing, static_cast<int>(nativeTransformer->size())));
+        }
+
+        const auto frames = framing ? _frontEnd.extractNativeFrames(audio, *framing) : _frontEnd.extractFrames(audio);
+        if (frames.empty())
+            return out;
+
+        const auto& transformer = framing ? *nativeTransformer : _frontEnd.getTransformer();
+        feature.prepare(static_cast<int>(transformer.size()));
+
+        const auto voiced = feature.detectVoiceActivity(frames);
+        const FrameStages silence = voiced.empty() ? FrameStages{} : feature.silenceStages(_stages);
+
+        std::vector<FrameStages> stages(frames.size());
+        const auto computeRange = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const bool speech = voiced.empty() || voiced[i];
+                stages[i] = speech ? feature.computeStages(frames[i], transformer, _stages) : silence;
+            }
+        };
+
+        const auto& pool = _frontEnd.getThreadPool();
+        if (pool)
+            pool->parallelFor(0, frames.size(), computeRange);
+        else
+            computeRange(0, frames.size());
+
+        // PNCC compresses across frames: the channel powers go through the stage finish() runs, rounded to
+        // the float rows it sees
+        const bool powerNormalized = feature.getOptions().compressionType == CompressionType::PowerNormalized;
+        std::unique_ptr<PnccStage> pncc;
+        std::vector<std::vector<double>> normalized;
+        if (powerNormalized && _stages.compressedEnergies)
+            pncc = std::make_unique<PnccStage>(feature.getPlan()->filters.size());
+
+        const bool drop = feature.getVoiceActivity().mode == VadMode::Drop && !voiced.empty();
+        FeatureMatrix rows;
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            auto& frame = stages[i];
+            if (_stages.cepstra)
+                rows.push_back(std::move(frame.row));
+            if (drop && !voiced[i])
+                continue;
+
+            if (_stages.powerSpectrum)
+                out.powerSpectrum.push_back(toRow(frame.power));
+            if (_stages.filterbankEnergies)
+                out.filterbankEnergies.push_back(toRow(frame.bands));
+            if (_stages.compressedEnergies && !pncc)
+                out.compressedEnergies.push_back(toRow(frame.compressed));
+            if (pncc)
+            {
+                std::vector<double> power(frame.bands.size());
+                for (std::size_t m = 0; m < power.size(); ++m)
+                    power[m] = static_cast<float>(frame.bands[m]);
+                pncc->push(power, normalized);
+            }
+        }
+        if (pncc)
+        {
+            pncc->finish(normalized);
+            for (const auto& values : normalized)
+                out.compressedEnergies.push_back(toRow(values));
+        }
+
+        if (_stages.cepstra)
+        {
+            if (pool)
+                feature.finish(std::move(rows), voiced, *pool);
+            else
+                feature.finish(std::move(rows), voiced);
+            out.cepstra = std::move(feature);
+        }
+
+        return out;
+    }
+}
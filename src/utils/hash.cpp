@@ -0,0 +1,141 @@
+#include "libvoicefeat/utils/hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace libvoicefeat::utils
+{
+    namespace
+    {
+        constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ull;
+        constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+        inline std::uint64_t rotl(std::uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline std::uint64_t read64(const unsigned char* p)
+        {
+            std::uint64_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline std::uint32_t read32(const unsigned char* p)
+        {
+            std::uint32_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline std::uint64_t round(std::uint64_t acc, std::uint64_t input)
+        {
+            acc += input * kPrime2;
+            acc = rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        inline std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t lane)
+        {
+            acc ^= round(0, lane);
+            return acc * kPrime1 + kPrime4;
+        }
+
+        inline void consumeStripe(std::uint64_t lanes[4], const unsigned char* p)
+        {
+            lanes[0] = round(lanes[0], read64(p));
+            lanes[1] = round(lanes[1], read64(p + 8));
+            lanes[2] = round(lanes[2], read64(p + 16));
+            lanes[3] = round(lanes[3], read64(p + 24));
+        }
+    }
+
+    Hasher::Hasher(std::uint64_t seed)
+        : _seed(seed)
+    {
+        _lanes[0] = seed + kPrime1 + kPrime2;
+        _lanes[1] = seed + kPrime2;
+        _lanes[2] = seed;
+        _lanes[3] = seed - kPrime1;
+    }
+
+    void Hasher::update(const void* data, std::size_t size)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        _total += size;
+
+        if (_stripeSize > 0)
+        {
+            const std::size_t take = std::min(size, sizeof(_stripe) - _stripeSize);
+            std::memcpy(_stripe + _stripeSize, p, take);
+            _stripeSize += take;
+            p += take;
+            size -= take;
+            if (_stripeSize < sizeof(_stripe))
+                return;
+            consumeStripe(_lanes, _stripe);
+            _stripeSize = 0;
+        }
+
+        for (; size >= sizeof(_stripe); p += sizeof(_stripe), size -= sizeof(_stripe))
+        {
+            consumeStripe(_lanes, p);
+        }
+
+        std::memcpy(_stripe, p, size);
+        _stripeSize = size;
+    }
+
+    void Hasher::add(const std::string& value)
+    {
+        add(static_cast<std::uint64_t>(value.size()));
+        update(value.data(), value.size());
+    }
+
+    std::uint64_t Hasher::digest() const
+    {
+        std::uint64_t h = 0;
+        if (_total >= sizeof(_stripe))
+        {
+            h = rotl(_lanes[0], 1) + rotl(_lanes[1], 7) + rotl(_lanes[2], 12) + rotl(_lanes[3], 18);
+            for (const auto lane : _lanes)
+                h = mergeRound(h, lane);
+        }
+        else
+        {
+            h = _seed + kPrime5;
+        }
+        h += _total;
+
+        const unsigned char* p = _stripe;
+        std::size_t left = _stripeSize;
+        for (; left >= 8; p += 8, left -= 8)
+        {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * kPrime1 + kPrime4;
+        }
+        if (left >= 4)
+        {
+            h ^= static_cast<std::uint64_t>(read32(p)) * kPrime1;
+            h = rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+            left -= 4;
+        }
+        for (; left > 0; ++p, --left)
+        {
+            h ^= static_cast<std::uint64_t>(*p) * kPrime5;
+            h = rotl(h, 11) * kPrime1;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+}
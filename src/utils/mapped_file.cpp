@@ -0,0 +1,99 @@
+#include "libvoicefeat/utils/mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBVOICEFEAT_HAS_MMAP 1
+#endif
+
+namespace libvoicefeat::utils
+{
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+#if defined(LIBVOICEFEAT_HAS_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open file: " + path.string());
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file: " + path.string());
+        }
+
+        _size = static_cast<std::size_t>(st.st_size);
+        if (_size > 0)
+        {
+            void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Cannot map file: " + path.string());
+            }
+            _data = static_cast<const unsigned char*>(addr);
+            _mapped = true;
+        }
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+            throw std::runtime_error("Cannot open file: " + path.string());
+
+        _fallback.resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(_fallback.data()), static_cast<std::streamsize>(_fallback.size()));
+        if (!in)
+            throw std::runtime_error("Cannot read file: " + path.string());
+
+        _data = _fallback.data();
+        _size = _fallback.size();
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release();
+        _fallback = std::move(other._fallback);
+        _data = other._mapped ? other._data : _fallback.data();
+        _size = other._size;
+        _mapped = other._mapped;
+
+        other._data = nullptr;
+        other._size = 0;
+        other._mapped = false;
+        return *this;
+    }
+
+    void MappedFile::release() noexcept
+    {
+#if defined(LIBVOICEFEAT_HAS_MMAP)
+        if (_mapped)
+            ::munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+        _mapped = false;
+        _fallback.clear();
+    }
+}
@@ -0,0 +1,113 @@
+#include "libvoicefeat/utils/path.h"
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace libvoicefeat::utils
+{
+    namespace
+    {
+        struct ResolutionState
+        {
+            std::mutex mutex;
+            PathResolutionPolicy policy{};
+            // (call-site directory, parent of the relative path) -> directory the walk matched in
+            std::map<std::pair<std::string, std::string>, std::filesystem::path> searchCache;
+        };
+
+        ResolutionState& state()
+        {
+            static ResolutionState instance;
+            return instance;
+        }
+
+        // The directory resolve_from_callsite() joined p to, given the path it returned.
+        std::filesystem::path matchedBase(const std::filesystem::path& resolved, const std::filesystem::path& p)
+        {
+            auto base = resolved;
+            for (auto it = p.begin(); it != p.end(); ++it)
+                base = base.parent_path();
+            return base;
+        }
+    }
+
+    void set_path_resolution(const PathResolutionPolicy& policy)
+    {
+        if (policy.mode == PathResolution::BaseDirectory && policy.baseDirectory.empty())
+            throw std::invalid_argument("BaseDirectory resolution needs a base directory");
+
+        auto& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.policy = policy;
+        s.searchCache.clear();
+    }
+
+    PathResolutionPolicy get_path_resolution()
+    {
+        auto& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.policy;
+    }
+
+    std::filesystem::path resolve_path(const std::filesystem::path& p, libvoicefeat::compat::source_location loc)
+    {
+        auto& s = state();
+        std::unique_lock<std::mutex> lock(s.mutex);
+        const auto policy = s.policy;
+
+        switch (policy.mode)
+        {
+        case PathResolution::Literal:
+            return p;
+        case PathResolution::BaseDirectory:
+            return p.is_absolute() ? p : policy.baseDirectory / p;
+        case PathResolution::SearchFromCallsite:
+            break;
+        }
+
+        if (p.is_absolute() || p.empty())
+        {
+            lock.unlock();
+            return resolve_from_callsite(p, loc);
+        }
+
+        // only relative paths made of plain names map cleanly back to the directory they matched in
+        const auto normal = p.lexically_normal();
+        const bool cacheable = *normal.begin() != "..";
+        const std::pair<std::string, std::string> key{std::filesystem::path(loc.file_name()).parent_path().string(),
+                                                      normal.parent_path().string()};
+        std::optional<std::filesystem::path> cachedBase;
+        if (cacheable)
+        {
+            const auto it = s.searchCache.find(key);
+            if (it != s.searchCache.end())
+                cachedBase = it->second;
+        }
+        lock.unlock();
+
+        // filesystem probes stay outside the process-wide lock
+        if (cachedBase)
+        {
+            auto candidate = *cachedBase / normal;
+            std::error_code ec;
+            if (std::filesystem::exists(candidate, ec))
+                return candidate;
+        }
+
+        auto resolved = resolve_from_callsite(p, loc);
+
+        // symlinks inside p can make the canonical path differ from base / p; those are not cached
+        const auto base = matchedBase(resolved, normal);
+        std::error_code ec;
+        if (cacheable && base / normal == resolved && std::filesystem::exists(resolved, ec))
+        {
+            lock.lock();
+            s.searchCache[key] = base;
+        }
+        return resolved;
+    }
+}
@@ -0,0 +1,210 @@
+#include "libvoicefeat/utils/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace libvoicefeat::utils
+{
+    namespace
+    {
+        struct WorkerContext
+        {
+            const ThreadPool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        thread_local WorkerContext tlsWorker{};
+    }
+
+    ThreadPool::ThreadPool(std::size_t numThreads)
+    {
+        numThreads = std::max<std::size_t>(1, numThreads);
+        _queues.reserve(numThreads);
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            _queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        _workers.reserve(numThreads);
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            _workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stopping = true;
+        }
+        _cv.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::enqueue(std::function<void()> task)
+    {
+        auto& queue = tlsWorker.pool == this ? *_queues[tlsWorker.index] : _injected;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        _pending.fetch_add(1);
+
+        {
+            // a worker that saw _pending == 0 is either already waiting or will see the new count
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _cv.notify_one();
+    }
+
+    bool ThreadPool::popTask(std::function<void()>& task)
+    {
+        const auto take = [&task](WorkQueue& queue, bool fromBack)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+            if (fromBack)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return true;
+        };
+
+        const bool isWorker = tlsWorker.pool == this;
+        const std::size_t self = isWorker ? tlsWorker.index : 0;
+
+        // newest local work first keeps nested blocks cache-warm; stealing takes the oldest, largest work
+        if (isWorker && take(*_queues[self], true))
+            return true;
+        if (take(_injected, false))
+            return true;
+
+        const std::size_t n = _queues.size();
+        for (std::size_t i = 1; i <= n; ++i)
+        {
+            const std::size_t victim = (self + i) % n;
+            if (isWorker && victim == self)
+                continue;
+            if (take(*_queues[victim], false))
+                return true;
+        }
+        return false;
+    }
+
+    bool ThreadPool::runPendingTask()
+    {
+        std::function<void()> task;
+        if (!popTask(task))
+            return false;
+
+        _pending.fetch_sub(1);
+        task();
+        return true;
+    }
+
+    void ThreadPool::workerLoop(std::size_t index)
+    {
+        tlsWorker = WorkerContext{this, index};
+
+        while (true)
+        {
+            if (runPendingTask())
+                continue;
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _cv.wait(lock, [this]() { return _stopping || _pending.load() > 0; });
+            if (_stopping && _pending.load() == 0)
+                return;
+        }
+    }
+
+    void ThreadPool::parallelFor(std::size_t begin, std::size_t end,
+                                 const std::function<void(std::size_t, std::size_t)>& body,
+                                 std::size_t grain)
+    {
+        if (begin >= end)
+            return;
+
+        const std::size_t count = end - begin;
+        if (grain == 0)
+        {
+            // a few blocks per thread keeps the tail short when blocks run at different speeds
+            const std::size_t targetBlocks = (_workers.size() + 1) * 4;
+            grain = (count + targetBlocks - 1) / targetBlocks;
+        }
+        grain = std::max<std::size_t>(1, grain);
+
+        const std::size_t numBlocks = (count + grain - 1) / grain;
+        if (numBlocks == 1)
+        {
+            body(begin, end);
+            return;
+        }
+
+        // Blocks are claimed from a shared counter. The caller claims blocks too, but never runs other queued
+        // work while it waits: helping with an unrelated task (another file, another extraction) could put
+        // a whole job on this stack, and the wait would then be bounded by that job instead of these blocks.
+        struct BlockState
+        {
+            std::atomic<std::size_t> next{0};
+            std::mutex mutex;
+            std::condition_variable done;
+            std::size_t remaining = 0;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<BlockState>();
+        state->remaining = numBlocks;
+
+        // stale copies left in the queues after the last block is claimed return at once and never touch body
+        const auto runBlocks = [state, &body, begin, end, grain, numBlocks]()
+        {
+            for (std::size_t b = state->next++; b < numBlocks; b = state->next++)
+            {
+                const std::size_t blockBegin = begin + b * grain;
+                const std::size_t blockEnd = std::min(end, blockBegin + grain);
+
+                std::exception_ptr error;
+                try
+                {
+                    body(blockBegin, blockEnd);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (error && !state->error)
+                    state->error = error;
+                if (--state->remaining == 0)
+                    state->done.notify_all();
+            }
+        };
+
+        const std::size_t helpers = std::min(numBlocks - 1, _workers.size());
+        for (std::size_t i = 0; i < helpers; ++i)
+            enqueue(runBlocks);
+
+        runBlocks();
+
+        // every block left is running on a thread that claimed it
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->done.wait(lock, [&state]() { return state->remaining == 0; });
+        }
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+}
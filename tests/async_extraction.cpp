@@ -0,0 +1,258 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/dsp/resampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTestTone(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.4f * std::sin(2.0f * kPi * (300.0f + 40.0f * std::sin(t)) * t);
+        }
+
+        return buffer;
+    }
+
+    // Wall time of an uncancelled blocking run. A cancelled call must stop within a fraction of it: a bound
+    // that scales with machine load, where a fixed number of milliseconds would measure CPU contention.
+    std::chrono::milliseconds runTime(const libvoicefeat::CepstralExtractor& extractor,
+                                      const libvoicefeat::audio::AudioBuffer& audio)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        static_cast<void>(extractor.extractFromAudioBuffer(audio));
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    double maxDifference(const libvoicefeat::FeatureMatrix& a, const libvoicefeat::FeatureMatrix& b)
+    {
+        double worst = a.size() == b.size() ? 0.0 : INFINITY;
+        for (std::size_t t = 0; t < std::min(a.size(), b.size()); ++t)
+            for (std::size_t i = 0; i < std::min(a[t].size(), b[t].size()); ++i)
+                worst = std::max(worst, static_cast<double>(std::abs(a[t][i] - b[t][i])));
+        return worst;
+    }
+
+    template <typename Error>
+    bool failsWith(std::future<libvoicefeat::Feature>& future)
+    {
+        try
+        {
+            static_cast<void>(future.get());
+        }
+        catch (const Error&)
+        {
+            return true;
+        }
+        catch (...)
+        {
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int sampleRate = 16000;
+    const auto shortBuffer = buildTestTone(sampleRate * 2, sampleRate);
+    const std::string audioPath = "data/common_voice_en_42698961.wav";
+
+    for (int threads : {1, 4})
+    {
+        CepstralConfig config;
+        config.feature.sampleRate = sampleRate;
+        config.delta.useDeltas = true;
+        config.threading.numThreads = threads;
+        const CepstralExtractor extractor(config);
+
+        // -----------------------------
+        // Futures match the blocking calls, for files and buffers
+        // -----------------------------
+        {
+            auto fromFile = extractor.extractAsync(audioPath);
+            auto fromBuffer = extractor.extractAsync(shortBuffer);
+            const auto fileFeature = fromFile.get();
+            const auto bufferFeature = fromBuffer.get();
+
+            if (fileFeature.getComputedMatrix() != extractor.extractFromFile(audioPath).getComputedMatrix()
+                || bufferFeature.getComputedMatrix() != extractor.extractFromAudioBuffer(shortBuffer).getComputedMatrix())
+            {
+                std::cerr << "Async result differs from blocking extraction" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // -----------------------------
+        // Completion callback on a user-supplied executor
+        // -----------------------------
+        {
+            ThreadPool userPool(2);
+            std::atomic<int> posted{0};
+            AsyncOptions options;
+            options.executor = [&](std::function<void()> task)
+            {
+                ++posted;
+                static_cast<void>(userPool.submit(std::move(task)));
+            };
+
+            std::promise<bool> done;
+            extractor.extractAsync(shortBuffer, options, [&](Feature feature, std::exception_ptr error)
+            {
+                done.set_value(!error && !feature.getComputedMatrix().empty());
+            });
+
+            if (!done.get_future().get() || posted != 1)
+            {
+                std::cerr << "Callback extraction failed or did not use the supplied executor" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // -----------------------------
+        // Pre-cancelled tokens and expired deadlines fail without extracting
+        // -----------------------------
+        {
+            AsyncOptions cancelled;
+            cancelled.cancellation.cancel();
+            auto future = extractor.extractAsync(shortBuffer, cancelled);
+            if (!failsWith<OperationCancelled>(future))
+            {
+                std::cerr << "Cancelled call did not fail with OperationCancelled" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            AsyncOptions expired;
+            expired.deadline = Clock::now() - std::chrono::milliseconds(1);
+            auto late = extractor.extractAsync(audioPath, expired);
+            if (!failsWith<DeadlineExceeded>(late))
+            {
+                std::cerr << "Expired deadline did not fail with DeadlineExceeded" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // -----------------------------
+        // Cancelling a running call stops it promptly
+        // -----------------------------
+        {
+            const auto longBuffer = buildTestTone(sampleRate * 60 * 5, sampleRate);
+            const auto fullRun = runTime(extractor, longBuffer);
+
+            AsyncOptions options;
+            auto future = extractor.extractAsync(longBuffer, options);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            const auto cancelledAt = Clock::now();
+            options.cancellation.cancel();
+            future.wait();
+            const auto stopDelay = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - cancelledAt);
+
+            if (!failsWith<OperationCancelled>(future))
+            {
+                std::cerr << "Running call was not cancelled" << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (stopDelay > fullRun / 4)
+            {
+                std::cerr << "Cancelled call kept running for " << stopDelay.count() << " ms of a "
+                          << fullRun.count() << " ms run" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // -----------------------------
+        // A cancelled call with other calls queued behind it does not run them before it stops
+        // -----------------------------
+        {
+            const auto longBuffer = buildTestTone(sampleRate * 60 * 2, sampleRate);
+            const auto fullRun = runTime(extractor, longBuffer);
+
+            std::vector<AsyncOptions> options(8);
+            std::vector<std::future<Feature>> futures;
+            for (const auto& option : options)
+                futures.push_back(extractor.extractAsync(longBuffer, option));
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            const auto cancelledAt = Clock::now();
+            options.front().cancellation.cancel();
+            futures.front().wait();
+            const auto stopDelay = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - cancelledAt);
+
+            for (auto& option : options)
+                option.cancellation.cancel();
+            for (auto& future : futures)
+                future.wait();
+
+            // running a queued job inline would take about a whole run
+            if (!failsWith<OperationCancelled>(futures.front()) || stopDelay > fullRun / 4)
+            {
+                std::cerr << "Cancelled call with queued neighbours stopped after " << stopDelay.count()
+                          << " ms; one run takes " << fullRun.count() << " ms" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // -----------------------------
+        // Resampled input: same rows as the blocking call, both within float rounding of the one-shot
+        // resampler, and resampling stops on cancel
+        // -----------------------------
+        {
+            constexpr int inputRate = 48000;
+            const auto resampled = buildTestTone(inputRate * 2, inputRate);
+            const auto blocking = extractor.extractFromAudioBuffer(resampled).getComputedMatrix();
+            auto future = extractor.extractAsync(resampled);
+            if (future.get().getComputedMatrix() != blocking)
+            {
+                std::cerr << "Async result differs from blocking extraction on resampled input" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            const auto oneShot = extractor.extractFromAudioBuffer(Resampler::resampleTo(resampled, sampleRate))
+                                     .getComputedMatrix();
+            const double drift = maxDifference(blocking, oneShot);
+            if (drift > 1e-3)
+            {
+                std::cerr << "Block-wise resampling drifts from Resampler::resampleTo by " << drift << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            const auto longBuffer = buildTestTone(inputRate * 80, inputRate);
+            const auto fullRun = runTime(extractor, longBuffer);
+            AsyncOptions options;
+            auto running = extractor.extractAsync(longBuffer, options);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            const auto cancelledAt = Clock::now();
+            options.cancellation.cancel();
+            running.wait();
+            const auto stopDelay = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - cancelledAt);
+            if (!failsWith<OperationCancelled>(running) || stopDelay > fullRun / 4)
+            {
+                std::cerr << "Resampling call stopped after " << stopDelay.count() << " ms of a "
+                          << fullRun.count() << " ms run" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
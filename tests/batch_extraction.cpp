@@ -0,0 +1,60 @@
+#include "libvoicefeat/batch_extractor.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::filesystem::path wavPath{"data/common_voice_en_42698961.wav"};
+    const std::filesystem::path mp3Path{"data/common_voice_en_42698961.mp3"};
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+
+    // -----------------------------
+    // Results keep input order and failing files do not abort the batch
+    // -----------------------------
+    {
+        BatchOptions options;
+        options.maxConcurrency = 2;
+        options.maxInFlightBytes = 1; // forces files through one at a time
+
+        BatchExtractor batch(config, options, std::make_shared<ThreadPool>(4));
+        const std::vector<std::filesystem::path> paths{wavPath, "data/missing.wav", mp3Path, "data/notes.txt", wavPath};
+        const auto results = batch.extract(paths);
+
+        if (results.size() != paths.size())
+        {
+            std::cerr << "Unexpected number of batch results" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            if (results[i].path != paths[i])
+            {
+                std::cerr << "Batch result out of order at index " << i << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (!results[0].ok() || results[1].ok() || !results[2].ok() || results[3].ok() || !results[4].ok())
+        {
+            std::cerr << "Unexpected per-file status in batch" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        CepstralExtractor single(config);
+        const auto expected = single.extractFromFile(wavPath.string()).getComputedMatrix();
+        if (results[0].feature.getComputedMatrix() != expected || results[4].feature.getComputedMatrix() != expected)
+        {
+            std::cerr << "Batch result differs from single-file extraction" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
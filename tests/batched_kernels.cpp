@@ -0,0 +1,132 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/features/batch_kernels.h"
+#include "libvoicefeat/features/delta.h"
+#include "libvoicefeat/features/feature_builder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTestChirp(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.5f * std::sin(2.0f * kPi * (120.0f + 1800.0f * t) * t);
+        }
+
+        return buffer;
+    }
+
+    // Reference delta with the clamped regression formula, row by row.
+    libvoicefeat::FeatureMatrix referenceDelta(const libvoicefeat::FeatureMatrix& m, int N)
+    {
+        double norm = 0.0;
+        for (int n = 1; n <= N; ++n)
+            norm += static_cast<double>(n * n);
+        norm = 1.0 / (2.0 * norm);
+
+        const int T = static_cast<int>(m.size());
+        libvoicefeat::FeatureMatrix out(m.size(), libvoicefeat::FeatureVector(m.front().size()));
+        for (int t = 0; t < T; ++t)
+        {
+            for (std::size_t d = 0; d < m.front().size(); ++d)
+            {
+                double num = 0.0;
+                for (int n = 1; n <= N; ++n)
+                    num += static_cast<double>(n) * (m[std::min(t + n, T - 1)][d] - m[std::max(t - n, 0)][d]);
+                out[t][d] = static_cast<float>(num * norm);
+            }
+        }
+        return out;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    constexpr int sampleRate = 16000;
+    // 13 frames plus a partial one, so the final lane group is never full
+    const auto buffer = buildTestChirp(sampleRate + 1234, sampleRate);
+
+    const std::size_t width = batch::laneWidth();
+    if (width != 2 && width != 4 && width != 8)
+    {
+        std::cerr << "Unexpected lane width " << width << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Batched rows are bitwise identical to per-frame rows for every type and compression
+    // -----------------------------
+    for (auto type : {CepstralType::MFCC, CepstralType::LFCC, CepstralType::GFCC, CepstralType::PNCC, CepstralType::PLP})
+    {
+        for (auto compression : {CompressionType::Log, CompressionType::CubeRoot, CompressionType::PowerNormalized})
+        {
+            for (auto transform : {CepstralTransform::DCT, CepstralTransform::LPC})
+            {
+                CepstralConfig config;
+                config.type = type;
+                config.feature.sampleRate = sampleRate;
+                config.feature.compressionType = compression;
+
+                CepstralExtractor extractor(config);
+                const auto frames = extractor.extractFrames(buffer);
+
+                auto feature = FeatureFactory::createDefaultFeature(config);
+                feature.setCompressionType(compression);
+                feature.setCepstralTransform(transform);
+                feature.prepare(extractor.getTransformer(), frames.front());
+
+                for (std::size_t begin : {std::size_t{0}, std::size_t{3}})
+                {
+                    const auto batched = feature.computeFrames(frames, begin, frames.size(),
+                                                               extractor.getTransformer());
+                    for (std::size_t i = begin; i < frames.size(); ++i)
+                    {
+                        if (batched[i - begin] != feature.computeFrame(frames[i], extractor.getTransformer()))
+                        {
+                            std::cerr << "Batched row " << i << " differs for type " << static_cast<int>(type)
+                                      << ", compression " << static_cast<int>(compression) << ", transform "
+                                      << static_cast<int>(transform) << std::endl;
+                            return EXIT_FAILURE;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // -----------------------------
+    // Track-wise deltas match the row-wise formula, including short inputs that are all edge
+    // -----------------------------
+    for (std::size_t frames : {std::size_t{1}, std::size_t{3}, std::size_t{5}, std::size_t{37}})
+    {
+        FeatureMatrix m(frames, FeatureVector(13));
+        for (std::size_t t = 0; t < frames; ++t)
+            for (std::size_t d = 0; d < 13; ++d)
+                m[t][d] = std::sin(0.37f * static_cast<float>(t * 13 + d));
+
+        for (int N : {1, 2, 3})
+        {
+            if (features::computeDelta(m, N) != referenceDelta(m, N))
+            {
+                std::cerr << "Delta differs for " << frames << " frames, N = " << N << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
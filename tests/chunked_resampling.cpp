@@ -0,0 +1,72 @@
+#include "libvoicefeat/dsp/resampler.h"
+#include "libvoicefeat/utils/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+    constexpr float kTolerance = 1e-4f;
+
+    libvoicefeat::audio::AudioBuffer buildTestSignal(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.3f * std::sin(2.0f * kPi * (100.0f + 1500.0f * t) * t)
+                              + 0.2f * std::sin(2.0f * kPi * 3100.0f * t);
+        }
+
+        return buffer;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using namespace libvoicefeat::dsp;
+
+    utils::ThreadPool pool(4);
+
+    // -----------------------------
+    // Chunked output matches single-pass resampling (down- and upsampling, uneven rate ratios)
+    // -----------------------------
+    const std::vector<std::pair<int, int>> rates{{48000, 16000}, {44100, 16000}, {16000, 22050}, {32000, 16000}};
+    for (const auto& [inputRate, targetRate] : rates)
+    {
+        const auto input = buildTestSignal(inputRate * 3 + 123, inputRate);
+        const auto expected = Resampler::resampleTo(input, targetRate);
+
+        for (std::size_t chunk : {std::size_t{0}, std::size_t{10000}, std::size_t{30011}})
+        {
+            const auto chunked = Resampler::resampleTo(input, targetRate, pool, chunk);
+            if (chunked.sampleRate != targetRate || chunked.samples.size() != expected.samples.size())
+            {
+                std::cerr << "Chunked resampling length mismatch for " << inputRate << " -> " << targetRate
+                          << ": " << chunked.samples.size() << " vs " << expected.samples.size() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            float maxError = 0.0f;
+            for (std::size_t i = 0; i < expected.samples.size(); ++i)
+                maxError = std::max(maxError, std::fabs(chunked.samples[i] - expected.samples[i]));
+
+            if (maxError > kTolerance)
+            {
+                std::cerr << "Chunked resampling differs for " << inputRate << " -> " << targetRate
+                          << " (chunk " << chunk << "): max error " << maxError << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
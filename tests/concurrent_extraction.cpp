@@ -0,0 +1,101 @@
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTone(int totalSamples, float freq, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.6f * std::sin(2.0f * kPi * freq * t) + 0.2f * std::sin(2.0f * kPi * 2.7f * freq * t);
+        }
+
+        return buffer;
+    }
+
+    // Hammers one shared extractor from many threads and checks every result against a reference.
+    bool hammer(const libvoicefeat::CepstralExtractor& extractor,
+                const std::vector<libvoicefeat::audio::AudioBuffer>& inputs,
+                int numThreads, int iterations)
+    {
+        std::vector<libvoicefeat::FeatureMatrix> expected;
+        for (const auto& input : inputs)
+            expected.push_back(extractor.extractFromAudioBuffer(input).getComputedMatrix());
+
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (int i = 0; i < iterations; ++i)
+                {
+                    const std::size_t which = static_cast<std::size_t>(t + i) % inputs.size();
+                    const auto actual = extractor.extractFromAudioBuffer(inputs[which]).getComputedMatrix();
+                    if (actual != expected[which])
+                        ++mismatches;
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        return mismatches.load() == 0;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    constexpr int sampleRate = 16000;
+    const std::vector<audio::AudioBuffer> inputs{
+        buildTone(sampleRate, 220.0f, sampleRate),
+        buildTone(sampleRate / 2, 1250.0f, sampleRate),
+        buildTone(sampleRate, 310.0f, 22050),           // exercises the resampling path as well
+    };
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    config.delta.useDeltaDeltas = true;
+
+    // -----------------------------
+    // One const extractor shared by many request threads gives deterministic results
+    // -----------------------------
+    {
+        const CepstralExtractor extractor(config);
+        if (!hammer(extractor, inputs, 16, 12))
+        {
+            std::cerr << "Shared extractor produced non-deterministic results" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Same with frame-parallel compute, so request threads share the extractor's pool as well
+    // -----------------------------
+    {
+        config.threading.numThreads = 4;
+        const CepstralExtractor extractor(config);
+        if (!hammer(extractor, inputs, 8, 8))
+        {
+            std::cerr << "Shared parallel extractor produced non-deterministic results" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/io/feature_archive.h"
+
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <typename Fn>
+    bool throws(Fn&& fn)
+    {
+        try
+        {
+            fn();
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const auto path = std::filesystem::temp_directory_path() / "libvoicefeat_feature_archive_test.lvfa";
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    config.delta.useDeltaDeltas = true;
+    CepstralExtractor extractor(config);
+
+    std::vector<std::string> keys{"wav", "mp3", "noise", "constant", "empty", "single"};
+    std::vector<FeatureMatrix> matrices{
+        extractor.extractFromFile("data/common_voice_en_42698961.wav").getComputedMatrix(),
+        extractor.extractFromFile("data/common_voice_en_42698961.mp3").getComputedMatrix(),
+        FeatureMatrix(300, FeatureVector(13)),
+        FeatureMatrix(600, FeatureVector(20, -3.25f)),
+        FeatureMatrix{},
+        FeatureMatrix{{1.0f, std::nanf(""), -0.0f, INFINITY}},
+    };
+    std::mt19937 rng(7);
+    std::normal_distribution<float> normal;
+    for (auto& row : matrices[2])
+        for (auto& value : row)
+            value = normal(rng);
+
+    // -----------------------------
+    // Lossless round trip, smaller than float32 on real features
+    // -----------------------------
+    std::uint64_t rawBytes = 0, storedBytes = 0;
+    {
+        io::FeatureArchiveWriter writer(path);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            writer.write(keys[i], matrices[i]);
+
+        if (!throws([&] { writer.write("wav", matrices[0]); }) || !throws([&] { writer.write("", matrices[0]); }))
+        {
+            std::cerr << "Duplicate or empty key was accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+        rawBytes = writer.getRawBytes();
+        storedBytes = writer.getStoredBytes();
+    }
+
+    io::FeatureArchiveReader reader(path);
+    if (reader.getKeys() != keys || reader.getChunkFrames() != 256)
+    {
+        std::cerr << "Archive index does not list the written keys" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        const auto restored = reader.read(keys[i]);
+        bool same = restored.size() == matrices[i].size();
+        for (std::size_t r = 0; same && r < restored.size(); ++r)
+            same = std::memcmp(restored[r].data(), matrices[i][r].data(), restored[r].size() * sizeof(float)) == 0 &&
+                   restored[r].size() == matrices[i][r].size();
+        if (!same)
+        {
+            std::cerr << "Matrix '" << keys[i] << "' did not round-trip bit for bit" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "Stored " << storedBytes << " of " << rawBytes << " float32 bytes ("
+              << 100.0 * static_cast<double>(storedBytes) / static_cast<double>(rawBytes) << " %)" << std::endl;
+    if (storedBytes >= rawBytes)
+    {
+        std::cerr << "Archive did not compress the features" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Frame ranges only decode the chunks they overlap
+    // -----------------------------
+    const auto& wav = matrices[0];
+    const std::size_t before = reader.getNumChunksDecoded();
+    const auto range = reader.readFrames("wav", 1000, 200);
+    if (range != FeatureMatrix(wav.begin() + 1000, wav.begin() + 1200) || reader.getNumChunksDecoded() - before != 2)
+    {
+        std::cerr << "readFrames(1000, 200) decoded " << reader.getNumChunksDecoded() - before
+                  << " chunks or returned the wrong rows" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto tail = reader.readFrames("wav", wav.size() - 3, 3);
+    if (tail != FeatureMatrix(wav.end() - 3, wav.end()) || !reader.readFrames("wav", wav.size(), 0).empty())
+    {
+        std::cerr << "Tail range returned the wrong rows" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Invalid lookups and damaged files
+    // -----------------------------
+    if (!throws([&] { (void)reader.read("missing"); }) ||
+        !throws([&] { (void)reader.readFrames("wav", wav.size() - 1, 2); }))
+    {
+        std::cerr << "Invalid lookup was accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 5);
+    if (!throws([&] { io::FeatureArchiveReader damaged(path); }))
+    {
+        std::cerr << "Truncated archive was opened" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}
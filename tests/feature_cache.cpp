@@ -0,0 +1,238 @@
+#include "libvoicefeat/feature_cache.h"
+#include "libvoicefeat/utils/hash.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::size_t countEntries(const std::filesystem::path& dir)
+    {
+        std::size_t n = 0;
+        for (const auto& file : std::filesystem::directory_iterator(dir))
+            n += file.path().extension() == ".lvfc" ? 1 : 0;
+        return n;
+    }
+
+    std::uint64_t xxh64(const std::string& text)
+    {
+        libvoicefeat::utils::Hasher h;
+        h.update(text.data(), text.size());
+        return h.digest();
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "libvoicefeat_cache_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // the data file resolves from this test's directory; copies go to a scratch directory
+    const auto source = utils::resolve_from_callsite("data/common_voice_en_42698961.wav");
+    const auto copyA = root / "a.wav";
+    const auto copyB = root / "b.wav";
+    fs::copy_file(source, copyA);
+    fs::copy_file(source, copyB);
+
+    // -----------------------------
+    // Hasher is XXH64 (reference vectors, and split updates agree with one-shot)
+    // -----------------------------
+    const std::string longText(1000, 'x');
+    utils::Hasher split;
+    split.update(longText.data(), 7);
+    split.update(longText.data() + 7, 993);
+    if (xxh64("") != 0xEF46DB3751D8E999ull || xxh64("a") != 0xD24EC4F1A98C6E5Bull ||
+        xxh64("abc") != 0x44BC2CF5AD770999ull || split.digest() != xxh64(longText))
+    {
+        std::cerr << "Hasher does not match XXH64" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Config hash: equal configs agree, any changed field disagrees
+    // -----------------------------
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    {
+        const auto base = hashConfig(config);
+        if (hashConfig(CepstralConfig(config)) != base)
+        {
+            std::cerr << "Equal configs hash differently" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto differs = [&](auto mutate)
+        {
+            CepstralConfig changed = config;
+            mutate(changed);
+            return hashConfig(changed) != base;
+        };
+        if (!differs([](CepstralConfig& c) { c.type = CepstralType::LFCC; }) ||
+            !differs([](CepstralConfig& c) { c.framing.frameStep = 161; }) ||
+            !differs([](CepstralConfig& c) { c.feature.maxFreq = 7999.0; }) ||
+            !differs([](CepstralConfig& c) { c.feature.melScale = MelScale::HTK; }) ||
+            !differs([](CepstralConfig& c) { c.delta.useDeltaDeltas = true; }) ||
+            !differs([](CepstralConfig& c) { c.preemphasis.preEmphasisCoeff = 0.95f; }) ||
+            !differs([](CepstralConfig& c) { c.threading.chunkedResampling = true; }) ||
+            !differs([](CepstralConfig& c) { c.resampling.nativeRate = true; }) ||
+            !differs([](CepstralConfig& c) { c.vad.mode = VadMode::Floor; }))
+        {
+            std::cerr << "Config change did not change the hash" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // the thread count only matters to chunked resampling
+        CepstralConfig chunked = config;
+        chunked.threading.chunkedResampling = true;
+        CepstralConfig chunkedWide = chunked;
+        chunkedWide.threading.numThreads = 4;
+        if (differs([](CepstralConfig& c) { c.threading.numThreads = 4; }) ||
+            hashConfig(chunked) == hashConfig(chunkedWide))
+        {
+            std::cerr << "Thread count hashed without chunked resampling, or ignored with it" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto expected = CepstralExtractor(config).extractFromFile(source.string()).getComputedMatrix();
+
+    // -----------------------------
+    // Content keys: miss, then hits for the same file and for a byte-identical copy
+    // -----------------------------
+    {
+        FeatureCacheOptions options;
+        options.directory = root / "content";
+        CachedExtractor cached(config, options);
+
+        const auto missStart = std::chrono::steady_clock::now();
+        const auto first = cached.extractFromFile(copyA.string()).getComputedMatrix();
+        const auto missTime = std::chrono::steady_clock::now() - missStart;
+
+        const auto hitStart = std::chrono::steady_clock::now();
+        const auto second = cached.extractFromFile(copyA.string()).getComputedMatrix();
+        const auto hitTime = std::chrono::steady_clock::now() - hitStart;
+
+        const auto third = cached.extractFromFile(copyB.string()).getComputedMatrix();
+        const auto stats = cached.getStats();
+        if (first != expected || second != expected || third != expected || stats.misses != 1 || stats.hits != 2)
+        {
+            std::cerr << "Content-keyed cache returned wrong results or counts" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (hitTime >= missTime)
+        {
+            std::cerr << "Cache hit was not faster than extraction" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // a new instance over the same directory sees the stored entry
+        CachedExtractor reopened(config, options);
+        if (reopened.extractFromFile(copyA.string()).getComputedMatrix() != expected || reopened.getStats().hits != 1)
+        {
+            std::cerr << "Entry did not survive a new cache instance" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // a different config is a different entry
+        CepstralConfig other = config;
+        other.delta.useDeltaDeltas = true;
+        CachedExtractor otherCache(other, options);
+        if (otherCache.extractFromFile(copyA.string()).getComputedMatrix().front().size() != expected.front().size() * 3 / 2 ||
+            otherCache.getStats().misses != 1 || countEntries(options.directory) != 2)
+        {
+            std::cerr << "Config change did not create a new entry" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Stat keys: hit until the file's mtime changes
+    // -----------------------------
+    {
+        FeatureCacheOptions options;
+        options.directory = root / "stat";
+        options.keyMode = CacheKeyMode::FileStat;
+        CachedExtractor cached(config, options);
+
+        (void)cached.extractFromFile(copyA.string());
+        (void)cached.extractFromFile(copyA.string());
+        fs::last_write_time(copyA, fs::last_write_time(copyA) + std::chrono::seconds(5));
+        (void)cached.extractFromFile(copyA.string());
+        (void)cached.extractFromFile(copyB.string());
+
+        const auto stats = cached.getStats();
+        if (stats.hits != 1 || stats.misses != 3)
+        {
+            std::cerr << "Stat-keyed cache: " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // LRU cap evicts the least recently used entry
+    // -----------------------------
+    {
+        FeatureCacheOptions options;
+        options.directory = root / "lru";
+        CachedExtractor probe(config, options);
+        (void)probe.extractFromFile(copyA.string());
+        const auto entrySize = fs::file_size(fs::directory_iterator(options.directory)->path());
+        probe.clear();
+
+        // room for two entries of this size
+        options.maxBytes = 2 * entrySize + entrySize / 2;
+        const auto withStep = [&](int step)
+        {
+            CepstralConfig c = config;
+            c.framing.frameStep = step;
+            return std::make_shared<const CepstralExtractor>(c);
+        };
+        // larger steps give smaller entries, so all three fit the cap pairwise
+        CachedExtractor first(withStep(160), options);
+        CachedExtractor second(withStep(170), options);
+        CachedExtractor third(withStep(180), options);
+
+        (void)first.extractFromFile(copyA.string());
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        (void)second.extractFromFile(copyA.string());
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        (void)first.extractFromFile(copyA.string());        // refresh: second is now the oldest
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        (void)third.extractFromFile(copyA.string());
+
+        (void)first.extractFromFile(copyA.string());
+        (void)second.extractFromFile(copyA.string());
+        if (third.getStats().evictions != 1 || first.getStats().hits != 2 || second.getStats().misses != 2)
+        {
+            std::cerr << "LRU eviction removed the wrong entry" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // temporaries of dead writers go at the next eviction scan, ones still being written stay
+        const auto stale = options.directory / "0123456789abcdef.lvfc.tmp0000000000000001";
+        const auto fresh = options.directory / "0123456789abcdef.lvfc.tmp0000000000000002";
+        std::ofstream(stale) << "partial";
+        std::ofstream(fresh) << "partial";
+        fs::last_write_time(stale, fs::file_time_type::clock::now() - std::chrono::hours(2));
+
+        CachedExtractor fourth(withStep(190), options);
+        (void)fourth.extractFromFile(copyA.string());
+        if (fs::exists(stale) || !fs::exists(fresh) || fourth.getStats().evictions != 1)
+        {
+            std::cerr << "Eviction scan kept a stale temporary or removed a fresh one" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    fs::remove_all(root);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/features/filterbanks/filterbank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    // |DFT| of the sampled 4th-order gammatone impulse response at the given frequencies, peak-normalized.
+    std::vector<double> impulseResponseMagnitude(double fc, int sampleRate, const std::vector<double>& freqs)
+    {
+        const double b = 1.019 * 24.7 * (4.37e-3 * fc + 1.0);
+        const int length = sampleRate / 5;      // 200 ms, far past the decay for b > 25 Hz
+
+        std::vector<double> g(static_cast<std::size_t>(length));
+        for (int n = 0; n < length; ++n)
+        {
+            const double t = static_cast<double>(n) / sampleRate;
+            g[n] = t * t * t * std::exp(-2.0 * kPi * b * t) * std::cos(2.0 * kPi * fc * t);
+        }
+
+        std::vector<double> mag;
+        for (double f : freqs)
+        {
+            std::complex<double> sum{};
+            for (int n = 0; n < length; ++n)
+                sum += g[n] * std::polar(1.0, -2.0 * kPi * f * n / sampleRate);
+            mag.push_back(std::abs(sum));
+        }
+
+        std::complex<double> peak{};
+        for (int n = 0; n < length; ++n)
+            peak += g[n] * std::polar(1.0, -2.0 * kPi * fc * n / sampleRate);
+        for (auto& m : mag)
+            m /= std::abs(peak);
+        return mag;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using namespace libvoicefeat::features;
+
+    FilterbankParams params;
+    params.sampleRate = 16000;
+    params.nFft = 512;
+    params.numFilters = 32;
+    params.minFreq = 50.0;
+    params.maxFreq = 8000.0;
+
+    const auto filters = createFilterbank(FilterbankType::Gammatone, MelScale::Slaney)->build(params);
+    if (filters.size() != 32 || filters.front().size() != 257)
+    {
+        std::cerr << "Unexpected gammatone bank shape" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Every channel follows the response of the time-domain gammatone
+    // -----------------------------
+    std::vector<double> freqs(257);
+    for (std::size_t k = 0; k < freqs.size(); ++k)
+        freqs[k] = static_cast<double>(k) * params.sampleRate / params.nFft;
+
+    double previousCentre = 0.0;
+    for (std::size_t m = 0; m < filters.size(); ++m)
+    {
+        const auto& f = filters[m];
+        double sum = 0.0;
+        for (double weight : f)
+            sum += weight;
+        const double peakBin = static_cast<double>(std::max_element(f.begin(), f.end()) - f.begin());
+        if (sum <= 0.0 || peakBin * params.sampleRate / params.nFft <= previousCentre)
+        {
+            std::cerr << "Channel " << m << " is empty or out of order" << std::endl;
+            return EXIT_FAILURE;
+        }
+        previousCentre = peakBin * params.sampleRate / params.nFft;
+
+        // ERB-rate spacing of the centres (Glasberg & Moore), end points excluded
+        const auto erbRate = [](double hz) { return 21.4 * std::log10(4.37e-3 * hz + 1.0); };
+        const double lo = erbRate(params.minFreq), hi = erbRate(params.maxFreq);
+        const double rate = lo + (hi - lo) * static_cast<double>(m + 1) / (params.numFilters + 1);
+        const double fc = (std::pow(10.0, rate / 21.4) - 1.0) / 4.37e-3;
+        // Away from 0 Hz and Nyquist, where the impulse response's negative-frequency image and the aliasing
+        // of its sampled spectrum are negligible; compared within 2 b of the centre.
+        const double b = 1.019 * 24.7 * (4.37e-3 * fc + 1.0);
+        if (fc < 300.0 || fc + 4.0 * b > params.sampleRate / 2.0)
+            continue;
+        const auto expected = impulseResponseMagnitude(fc, params.sampleRate, freqs);
+        for (std::size_t k = 0; k < f.size(); ++k)
+        {
+            if (std::fabs(freqs[k] - fc) <= 2.0 * b && std::fabs(f[k] - expected[k]) > 0.02)
+            {
+                std::cerr << "Channel " << m << " (" << fc << " Hz), bin " << k << ": weight " << f[k]
+                          << ", impulse response " << expected[k] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // The half-power bandwidth is 0.887 ERB
+    // -----------------------------
+    {
+        FilterbankParams fine = params;
+        fine.nFft = 1 << 16;
+        fine.numFilters = 1;
+        fine.minFreq = 0.0;
+        const auto single = createFilterbank(FilterbankType::Gammatone, MelScale::Slaney)->build(fine).front();
+
+        const auto peak = std::max_element(single.begin(), single.end()) - single.begin();
+        const double binHz = static_cast<double>(fine.sampleRate) / fine.nFft;
+        const double fc = static_cast<double>(peak) * binHz;
+        const double erb = 24.7 * (4.37e-3 * fc + 1.0);
+
+        std::size_t lo = static_cast<std::size_t>(peak), hi = static_cast<std::size_t>(peak);
+        while (lo > 0 && single[lo] * single[lo] >= 0.5)
+            --lo;
+        while (hi + 1 < single.size() && single[hi] * single[hi] >= 0.5)
+            ++hi;
+        const double width = static_cast<double>(hi - lo) * binHz;
+        if (std::fabs(width / erb - 0.887) > 0.01)
+        {
+            std::cerr << "3 dB bandwidth is " << width / erb << " ERB" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // GFCC extraction runs on the new bank
+    // -----------------------------
+    {
+        CepstralConfig config;
+        config.type = CepstralType::GFCC;
+        CepstralExtractor extractor(config);
+        const auto gfcc = extractor.extractFromFile("data/common_voice_en_42698961.wav").getComputedMatrix();
+        if (gfcc.empty() || !std::all_of(gfcc.begin(), gfcc.end(), [](const FeatureVector& row)
+        {
+            return std::all_of(row.begin(), row.end(), [](float v) { return std::isfinite(v); });
+        }))
+        {
+            std::cerr << "GFCC rows are missing or not finite" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/io/kaldi_archive.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTestTone(int totalSamples, int sampleRate, float freq)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            buffer.samples[n] = 0.4f * std::sin(2.0f * kPi * freq * static_cast<float>(n) / sampleRate);
+        }
+
+        return buffer;
+    }
+
+    std::vector<char> readBytes(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto arkPath = dir / "libvoicefeat_kaldi_test.ark";
+    const auto scpPath = dir / "libvoicefeat_kaldi_test.scp";
+
+    // -----------------------------
+    // Byte layout matches Kaldi's binary float matrix
+    // -----------------------------
+    {
+        io::KaldiArchiveWriter writer(arkPath);
+        writer.write("utt", FeatureMatrix{{1.0f, 2.0f}});
+    }
+
+    std::vector<char> expected{'u', 't', 't', ' ', '\0', 'B', 'F', 'M', ' ', 4, 1, 0, 0, 0, 4, 2, 0, 0, 0};
+    const float values[2] = {1.0f, 2.0f};
+    expected.insert(expected.end(), reinterpret_cast<const char*>(values), reinterpret_cast<const char*>(values) + sizeof(values));
+    if (readBytes(arkPath) != expected)
+    {
+        std::cerr << "Archive bytes do not match the Kaldi binary layout" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Streaming write of extracted features, read back through the ark and the scp
+    // -----------------------------
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    CepstralExtractor extractor(config);
+
+    std::vector<std::string> keys{"spk1utt1", "spk1-utt02", "spk2-utt003", "empty"};
+    std::vector<FeatureMatrix> matrices;
+    for (std::size_t i = 0; i + 1 < keys.size(); ++i)
+    {
+        const auto audio = buildTestTone(8000 + 1700 * static_cast<int>(i), config.feature.sampleRate,
+                                         300.0f + 450.0f * static_cast<float>(i));
+        matrices.push_back(extractor.extractFromAudioBuffer(audio).getComputedMatrix());
+    }
+    matrices.emplace_back();
+
+    {
+        io::KaldiArchiveWriter writer(arkPath, scpPath);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            writer.write(keys[i], matrices[i]);
+        }
+        if (writer.getNumWritten() != keys.size())
+        {
+            std::cerr << "Writer miscounted matrices" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const bool viaScp : {false, true})
+    {
+        const auto reader = viaScp ? io::KaldiArchiveReader::openScp(scpPath)
+                                   : io::KaldiArchiveReader::openArchive(arkPath);
+        if (reader.getKeys() != keys)
+        {
+            std::cerr << "Reader keys differ from the written order (scp: " << viaScp << ")" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // reverse order exercises random access
+        for (std::size_t i = keys.size(); i-- > 0;)
+        {
+            const auto view = reader.get(keys[i]);
+            if (view.toMatrix() != matrices[i])
+            {
+                std::cerr << "Matrix " << keys[i] << " did not round-trip (scp: " << viaScp << ")" << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (!view.empty() && view.at(view.rows() - 1, view.cols() - 1) != matrices[i].back().back())
+            {
+                std::cerr << "Element access mismatch for " << keys[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // an 8-character first key puts its data at offset 24, so the raw pointer is usable directly
+        const auto aligned = reader.get("spk1utt1");
+        if (!aligned.isAligned() || std::memcmp(aligned.data(), matrices[0][0].data(), aligned.cols() * sizeof(float)) != 0)
+        {
+            std::cerr << "Zero-copy view does not point at the matrix data" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (reader.contains("missing"))
+        {
+            std::cerr << "Reader reports a key that was never written" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Invalid keys and truncated archives are rejected
+    // -----------------------------
+    bool rejected = false;
+    try
+    {
+        io::KaldiArchiveWriter writer(arkPath);
+        writer.write("two words", FeatureMatrix{{0.0f}});
+    }
+    catch (const std::invalid_argument&)
+    {
+        rejected = true;
+    }
+    if (!rejected)
+    {
+        std::cerr << "Key with whitespace was accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    {
+        io::KaldiArchiveWriter writer(arkPath);
+        writer.write("utt", matrices[0]);
+    }
+    std::filesystem::resize_file(arkPath, std::filesystem::file_size(arkPath) - 3);
+    rejected = false;
+    try
+    {
+        (void)io::KaldiArchiveReader::openArchive(arkPath);
+    }
+    catch (const std::runtime_error&)
+    {
+        rejected = true;
+    }
+    if (!rejected)
+    {
+        std::cerr << "Truncated archive was accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(arkPath);
+    std::filesystem::remove(scpPath);
+    return EXIT_SUCCESS;
+}
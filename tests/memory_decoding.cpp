@@ -0,0 +1,134 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<unsigned char> readBytes(const std::filesystem::path& path)
+    {
+        std::ifstream in(libvoicefeat::utils::resolve_from_callsite(path), std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    template <typename Fn>
+    bool throwsInvalidOrRuntime(Fn&& fn)
+    {
+        try
+        {
+            fn();
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+    const std::string mp3Path{"data/common_voice_en_42698961.mp3"};
+    const auto wavBytes = readBytes(wavPath);
+    const auto mp3Bytes = readBytes(mp3Path);
+    if (wavBytes.empty() || mp3Bytes.empty())
+    {
+        std::cerr << "Test audio not found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Format detection from the leading bytes
+    // -----------------------------
+    if (detectAudioFormat(wavBytes.data(), wavBytes.size()) != AudioFormat::Wav ||
+        detectAudioFormat(mp3Bytes.data(), mp3Bytes.size()) != AudioFormat::Mp3)
+    {
+        std::cerr << "Format detection failed on the bundled audio" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const unsigned char frameSync[] = {0xFF, 0xFB, 0x90, 0x64};
+    const std::string notAudio = "just some text";
+    if (detectAudioFormat(frameSync, sizeof(frameSync)) != AudioFormat::Mp3 ||
+        !throwsInvalidOrRuntime([&] { (void)detectAudioFormat(notAudio.data(), notAudio.size()); }) ||
+        !throwsInvalidOrRuntime([&] { (void)detectAudioFormat(nullptr, 0); }))
+    {
+        std::cerr << "Format detection accepted or rejected the wrong bytes" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Memory decoding matches file decoding, sample for sample
+    // -----------------------------
+    const auto wavFromFile = createAudioReader(wavPath)->loadChannels(wavPath);
+    const auto wavStream = createAudioReader(AudioFormat::Wav)->openMemory(wavBytes.data(), wavBytes.size());
+    if (wavStream->sampleRate() != wavFromFile.sampleRate || wavStream->totalFrames() != wavFromFile.channels.front().size() ||
+        readAllPlanar(*wavStream).channels != wavFromFile.channels)
+    {
+        std::cerr << "WAV decoded from memory differs from the file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto mp3FromFile = createAudioReader(mp3Path)->load(mp3Path);
+    const auto mp3FromMemory = createAudioReader(AudioFormat::Mp3)->loadMemory(mp3Bytes.data(), mp3Bytes.size());
+    if (mp3FromMemory.sampleRate != mp3FromFile.sampleRate || mp3FromMemory.samples != mp3FromFile.samples)
+    {
+        std::cerr << "MP3 decoded from memory differs from the file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // extractFromMemory matches extractFromFile, detected and explicit
+    // -----------------------------
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    CepstralExtractor extractor(config);
+
+    for (const auto& [path, bytes] : {std::make_pair(wavPath, &wavBytes), std::make_pair(mp3Path, &mp3Bytes)})
+    {
+        const auto expected = extractor.extractFromFile(path).getComputedMatrix();
+        const auto detected = extractor.extractFromMemory(bytes->data(), bytes->size()).getComputedMatrix();
+        const auto format = bytes == &wavBytes ? AudioFormat::Wav : AudioFormat::Mp3;
+        const auto explicitFormat = extractor.extractFromMemory(bytes->data(), bytes->size(), format).getComputedMatrix();
+        if (expected.empty() || detected != expected || explicitFormat != expected)
+        {
+            std::cerr << "extractFromMemory differs from extractFromFile for " << path << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Truncated and mislabeled buffers
+    // -----------------------------
+    const std::size_t cut = wavBytes.size() - 1001;
+    const auto truncated = createAudioReader(AudioFormat::Wav)->openMemory(wavBytes.data(), cut);
+    if (truncated->totalFrames() >= wavStream->totalFrames() || readAllMono(*truncated).samples.size() != truncated->totalFrames())
+    {
+        std::cerr << "Truncated WAV buffer was not cut at its last whole frame" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!throwsInvalidOrRuntime([&] { (void)extractor.extractFromMemory(mp3Bytes.data(), mp3Bytes.size(), AudioFormat::Wav); }) ||
+        !throwsInvalidOrRuntime([&] { (void)extractor.extractFromMemory(wavBytes.data(), 20); }) ||
+        !throwsInvalidOrRuntime([&] { (void)extractor.extractFromMemory(notAudio.data(), notAudio.size(), AudioFormat::Mp3); }))
+    {
+        std::cerr << "Invalid memory input was accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+#include "libvoicefeat/multi_feature_extractor.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTestSweep(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.4f * std::sin(2.0f * kPi * (150.0f + 2000.0f * t) * t);
+        }
+
+        return buffer;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    constexpr int sampleRate = 16000;
+    const auto buffer = buildTestSweep(sampleRate * 2, sampleRate);
+    const std::vector<CepstralType> types{CepstralType::MFCC, CepstralType::LFCC, CepstralType::GFCC, CepstralType::PNCC};
+
+    // -----------------------------
+    // Every head matches a dedicated single-type extraction, serial and frame-parallel
+    // -----------------------------
+    for (int threads : {1, 4})
+    {
+        CepstralConfig config;
+        config.feature.sampleRate = sampleRate;
+        config.delta.useDeltas = true;
+        config.threading.numThreads = threads;
+
+        MultiFeatureExtractor multi(config, types);
+        const auto results = multi.extractFromAudioBuffer(buffer);
+        if (results.size() != types.size())
+        {
+            std::cerr << "Unexpected number of feature matrices" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        for (auto type : types)
+        {
+            CepstralConfig single = config;
+            single.type = type;
+            const auto expected = CepstralExtractor(single).extractFromAudioBuffer(buffer).getComputedMatrix();
+
+            const auto it = results.find(type);
+            if (it == results.end() || expected.empty() || it->second.getComputedMatrix() != expected)
+            {
+                std::cerr << "Multi-feature output differs for type " << static_cast<int>(type) << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // A type requested twice is rejected rather than collapsed into one result
+    // -----------------------------
+    {
+        bool threw = false;
+        try
+        {
+            static_cast<void>(MultiFeatureExtractor(CepstralConfig{}, {CepstralType::MFCC, CepstralType::GFCC,
+                                                                       CepstralType::MFCC}));
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::cerr << "A duplicate cepstral type was accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
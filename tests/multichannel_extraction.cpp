@@ -0,0 +1,129 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    void writeLe(std::ofstream& out, uint32_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    // 16-bit PCM, interleaved from planar channels.
+    void writeWav16(const std::filesystem::path& path, const std::vector<std::vector<int16_t>>& channels, int sampleRate)
+    {
+        const uint32_t numChannels = static_cast<uint32_t>(channels.size());
+        const uint32_t frames = static_cast<uint32_t>(channels.front().size());
+        const uint32_t dataSize = frames * numChannels * 2;
+
+        std::ofstream out(path, std::ios::binary);
+        out.write("RIFF", 4);
+        writeLe(out, 36 + dataSize, 4);
+        out.write("WAVE", 4);
+        out.write("fmt ", 4);
+        writeLe(out, 16, 4);
+        writeLe(out, 1, 2);
+        writeLe(out, numChannels, 2);
+        writeLe(out, static_cast<uint32_t>(sampleRate), 4);
+        writeLe(out, static_cast<uint32_t>(sampleRate) * numChannels * 2, 4);
+        writeLe(out, numChannels * 2, 2);
+        writeLe(out, 16, 2);
+        out.write("data", 4);
+        writeLe(out, dataSize, 4);
+        for (uint32_t i = 0; i < frames; ++i)
+            for (const auto& channel : channels)
+                writeLe(out, static_cast<uint16_t>(channel[i]), 2);
+    }
+
+    std::vector<int16_t> tone(int totalSamples, int sampleRate, float freq, float amplitude)
+    {
+        std::vector<int16_t> samples(totalSamples);
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            samples[n] = static_cast<int16_t>(std::lround(amplitude * 32767.0f * std::sin(2.0f * kPi * freq * t)));
+        }
+        return samples;
+    }
+
+    libvoicefeat::audio::AudioBuffer toBuffer(const std::vector<int16_t>& pcm, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        for (auto s : pcm)
+            buffer.samples.push_back(s / 32768.f);
+        return buffer;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    constexpr int sampleRate = 16000;
+    const std::vector<std::vector<int16_t>> pcm{
+        tone(sampleRate, sampleRate, 440.0f, 0.5f),
+        tone(sampleRate, sampleRate, 2500.0f, 0.3f),
+    };
+
+    const auto path = std::filesystem::temp_directory_path() / "libvoicefeat_multichannel_test.wav";
+    writeWav16(path, pcm, sampleRate);
+
+    // -----------------------------
+    // Channel-preserving reader keeps the planar layout
+    // -----------------------------
+    const auto planar = createAudioReader(path)->loadChannels(path);
+    if (planar.channels.size() != 2 || planar.sampleRate != sampleRate || planar.channels[1] != toBuffer(pcm[1], sampleRate).samples)
+    {
+        std::cerr << "loadChannels did not preserve the channels" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Each channel matches a mono extraction of that channel, serial and parallel
+    // -----------------------------
+    for (int threads : {1, 4})
+    {
+        CepstralConfig config;
+        config.feature.sampleRate = sampleRate;
+        config.delta.useDeltas = true;
+        config.threading.numThreads = threads;
+
+        CepstralExtractor extractor(config);
+        const auto features = extractor.extractChannelsFromFile(path.string());
+        if (features.size() != pcm.size())
+        {
+            std::cerr << "Expected one feature per channel" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        for (std::size_t c = 0; c < pcm.size(); ++c)
+        {
+            const auto expected = extractor.extractFromAudioBuffer(toBuffer(pcm[c], sampleRate)).getComputedMatrix();
+            if (expected.empty() || features[c].getComputedMatrix() != expected)
+            {
+                std::cerr << "Channel " << c << " differs from its mono extraction" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (features[0].getComputedMatrix() == features[1].getComputedMatrix())
+        {
+            std::cerr << "Distinct channels produced identical features" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/multi_feature_extractor.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    // Content stays below 6 kHz, so resampling to 16 kHz removes nothing the features look at.
+    libvoicefeat::audio::AudioBuffer buildTestSignal(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            const float envelope = 0.5f + 0.4f * std::sin(2.0f * kPi * 3.0f * t);
+            buffer.samples[n] = envelope * (0.3f * std::sin(2.0f * kPi * (200.0f + 900.0f * t) * t)
+                                          + 0.1f * std::sin(2.0f * kPi * 2300.0f * t)
+                                          + 0.05f * std::sin(2.0f * kPi * (5500.0f - 700.0f * t) * t));
+        }
+
+        return buffer;
+    }
+
+    double relativeDistance(const libvoicefeat::FeatureVector& a, const libvoicefeat::FeatureVector& b)
+    {
+        double diff = 0.0, norm = 0.0;
+        for (std::size_t k = 1; k < a.size(); ++k)
+        {
+            diff += (a[k] - b[k]) * (a[k] - b[k]);
+            norm += a[k] * a[k];
+        }
+        return std::sqrt(diff / std::max(norm, 1e-12));
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    for (int inputRate : {32000, 48000})
+    {
+        const auto buffer = buildTestSignal(inputRate * 2, inputRate);
+
+        CepstralConfig config;
+        const auto resampled = CepstralExtractor(config).extractFromAudioBuffer(buffer).getComputedMatrix();
+
+        config.resampling.nativeRate = true;
+        const auto native = CepstralExtractor(config).extractFromAudioBuffer(buffer).getComputedMatrix();
+
+        // -----------------------------
+        // Same frame grid as the resampled path
+        // -----------------------------
+        if (resampled.empty() || native.size() != resampled.size() || native.front().size() != resampled.front().size())
+        {
+            std::cerr << "Native-rate output shape differs at " << inputRate << " Hz" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // -----------------------------
+        // Cepstra and log energy close to the resampled path
+        // -----------------------------
+        double meanDistance = 0.0, meanEnergyError = 0.0;
+        for (std::size_t i = 0; i < native.size(); ++i)
+        {
+            meanDistance += relativeDistance(resampled[i], native[i]);
+            meanEnergyError += std::fabs(resampled[i][0] - native[i][0]);
+        }
+        meanDistance /= static_cast<double>(native.size());
+        meanEnergyError /= static_cast<double>(native.size());
+
+        if (meanDistance > 0.1 || meanEnergyError > 0.01)
+        {
+            std::cerr << "Native-rate features too far from resampled ones at " << inputRate << " Hz: cepstral "
+                      << meanDistance << ", log energy " << meanEnergyError << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // -----------------------------
+        // Multi-feature extraction takes the same native path, bitwise
+        // -----------------------------
+        const std::vector<CepstralType> types{CepstralType::MFCC, CepstralType::GFCC, CepstralType::PNCC,
+                                              CepstralType::PLP};
+        for (int threads : {1, 3})
+        {
+            CepstralConfig multiConfig = config;
+            multiConfig.threading.numThreads = threads;
+            const auto multi = MultiFeatureExtractor(multiConfig, types).extractFromAudioBuffer(buffer);
+            for (auto type : types)
+            {
+                CepstralConfig single = multiConfig;
+                single.type = type;
+                if (multi.at(type).getComputedMatrix() !=
+                    CepstralExtractor(single).extractFromAudioBuffer(buffer).getComputedMatrix())
+                {
+                    std::cerr << "Native-rate multi-feature rows differ for type " << static_cast<int>(type)
+                              << " at " << inputRate << " Hz" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+#include "libvoicefeat/pipeline_extractor.h"
+#include "libvoicefeat/features/delta.h"
+#include "libvoicefeat/io/npy.h"
+#include "libvoicefeat/utils/float16.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<unsigned char> readBytes(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    std::uint32_t readLE(const std::vector<unsigned char>& bytes, std::size_t pos, int count)
+    {
+        std::uint32_t value = 0;
+        for (int i = 0; i < count; ++i)
+            value |= static_cast<std::uint32_t>(bytes[pos + i]) << (8 * i);
+        return value;
+    }
+
+    // Header text of a .npy image, or empty when the preamble is wrong.
+    std::string npyDict(const std::vector<unsigned char>& bytes)
+    {
+        if (bytes.size() < 10 || std::memcmp(bytes.data(), "\x93NUMPY\x01\x00", 8) != 0)
+            return {};
+        const std::size_t length = readLE(bytes, 8, 2);
+        return std::string(bytes.begin() + 10, bytes.begin() + 10 + static_cast<std::ptrdiff_t>(length));
+    }
+
+    libvoicefeat::FeatureMatrix randomMatrix(std::size_t rows, std::size_t cols, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> dist(0.0f, 3.0f);
+        libvoicefeat::FeatureMatrix m(rows, libvoicefeat::FeatureVector(cols));
+        for (auto& row : m)
+            for (auto& v : row)
+                v = dist(rng);
+        return m;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const auto dir = std::filesystem::temp_directory_path();
+
+    // -----------------------------
+    // .npy layout: preamble, padded dict, C-order data
+    // -----------------------------
+    const FeatureMatrix small{{1.0f, -2.5f, 3.0f}, {0.5f, 0.0f, -7.0f}};
+    const auto bytes = io::serializeNpy(small);
+    const std::string dict = npyDict(bytes);
+    if (dict.find("'descr': '<f4'") == std::string::npos || dict.find("'fortran_order': False") == std::string::npos ||
+        dict.find("'shape': (2, 3)") == std::string::npos || dict.back() != '\n' || (10 + dict.size()) % 64 != 0)
+    {
+        std::cerr << "Unexpected npy header: " << dict << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (bytes.size() != 10 + dict.size() + 6 * sizeof(float) ||
+        std::memcmp(bytes.data() + 10 + dict.size() + 3 * sizeof(float), small[1].data(), 3 * sizeof(float)) != 0)
+    {
+        std::cerr << "npy data is not the row-major matrix" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto npyPath = dir / "libvoicefeat_npy_test.npy";
+    io::writeNpy(npyPath, small);
+    if (readBytes(npyPath) != bytes)
+    {
+        std::cerr << "writeNpy differs from serializeNpy" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // float16: exact encodings and round-trip error
+    // -----------------------------
+    const std::pair<float, std::uint16_t> known[] = {
+        {1.0f, 0x3c00}, {-2.0f, 0xc000}, {0.1f, 0x2e66}, {65504.0f, 0x7bff}, {65520.0f, 0x7c00},
+        {std::ldexp(1.0f, -24), 0x0001}, {std::ldexp(1.0f, -26), 0x0000}, {std::ldexp(1.0f, -14), 0x0400},
+        {1.0f + std::ldexp(1.0f, -11), 0x3c00}, {1.0f + 3.0f * std::ldexp(1.0f, -11), 0x3c02},
+    };
+    for (const auto& [value, half] : known)
+    {
+        if (utils::floatToHalf(value) != half)
+        {
+            std::cerr << "floatToHalf(" << value << ") = " << std::hex << utils::floatToHalf(value) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto noisy = randomMatrix(50, 13, 7);
+    const auto halfBytes = io::serializeNpy(noisy, io::NpyDType::Float16);
+    const std::size_t halfData = 10 + npyDict(halfBytes).size();
+    if (npyDict(halfBytes).find("'<f2'") == std::string::npos || halfBytes.size() != halfData + 50 * 13 * 2)
+    {
+        std::cerr << "Unexpected float16 npy layout" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < 50 * 13; ++i)
+    {
+        const float original = noisy[i / 13][i % 13];
+        const float decoded = utils::halfToFloat(static_cast<std::uint16_t>(readLE(halfBytes, halfData + 2 * i, 2)));
+        if (std::abs(decoded - original) > std::abs(original) * std::ldexp(1.0f, -11) + std::ldexp(1.0f, -24))
+        {
+            std::cerr << "float16 round trip error too large at " << i << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // .npz: stored entries whose payloads are the .npy images
+    // -----------------------------
+    const auto npzPath = dir / "libvoicefeat_npz_test.npz";
+    {
+        io::NpzWriter npz(npzPath);
+        npz.add("mfcc", small);
+        npz.add("noisy.npy", noisy, io::NpyDType::Float16);
+    }
+    const auto zip = readBytes(npzPath);
+    const std::size_t eocd = zip.size() - 22;
+    if (readLE(zip, eocd, 4) != 0x06054b50u || readLE(zip, eocd + 10, 2) != 2)
+    {
+        std::cerr << "npz end of central directory missing" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::size_t central = readLE(zip, eocd + 16, 4);
+    const std::pair<std::string, std::vector<unsigned char>> expectedEntries[] = {
+        {"mfcc.npy", bytes}, {"noisy.npy", halfBytes}};
+    for (const auto& [name, payload] : expectedEntries)
+    {
+        const std::size_t nameLength = readLE(zip, central + 28, 2);
+        const std::string entryName(zip.begin() + static_cast<std::ptrdiff_t>(central + 46),
+                                    zip.begin() + static_cast<std::ptrdiff_t>(central + 46 + nameLength));
+        const std::size_t local = readLE(zip, central + 42, 4);
+        const std::size_t size = readLE(zip, central + 24, 4);
+        const std::size_t dataStart = local + 30 + readLE(zip, local + 26, 2) + readLE(zip, local + 28, 2);
+        if (entryName != name || size != payload.size() || readLE(zip, local + 18, 4) != size ||
+            readLE(zip, local + 14, 4) != readLE(zip, central + 16, 4) ||
+            !std::equal(payload.begin(), payload.end(), zip.begin() + static_cast<std::ptrdiff_t>(dataStart)))
+        {
+            std::cerr << "npz entry " << name << " is malformed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        central += 46 + nameLength;
+    }
+
+    // -----------------------------
+    // Streaming deltas match the batch computation
+    // -----------------------------
+    for (const std::size_t rows : {1, 3, 4, 5, 9, 40})
+    {
+        const auto base = randomMatrix(rows, 6, static_cast<unsigned>(rows));
+        for (const auto [useDelta, useDeltaDelta] : {std::pair{true, false}, {false, true}, {true, true}})
+        {
+            StreamingDeltas streaming(useDelta, useDeltaDelta);
+            FeatureMatrix out;
+            for (const auto& row : base)
+                streaming.push(row, out);
+            streaming.finish(out);
+            if (out != appendDeltas(base, useDelta, useDeltaDelta))
+            {
+                std::cerr << "Streaming deltas differ for " << rows << " rows" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Pipeline rows streamed into NpyWriter equal writeNpy of the collected matrix
+    // -----------------------------
+    {
+        CepstralConfig config;
+        config.delta.useDeltas = true;
+        config.delta.useDeltaDeltas = true;
+
+        PipelineOptions options;
+        options.framesPerBlock = 23;
+        options.extractThreads = 3;
+
+        const std::string wavPath{"data/common_voice_en_42698961.wav"};
+        PipelineExtractor pipeline(config, options);
+        const auto expected = pipeline.extractFromFile(wavPath).getComputedMatrix();
+
+        const auto streamedPath = dir / "libvoicefeat_npy_streamed.npy";
+        std::size_t delivered = 0;
+        {
+            io::NpyWriter writer(streamedPath);
+            delivered = pipeline.extractFromFile(wavPath, [&writer](const FeatureVector& row) { writer.appendRow(row); });
+        }
+
+        io::writeNpy(npyPath, expected);
+        if (expected.empty() || delivered != expected.size())
+        {
+            std::cerr << "Row sink delivered " << delivered << " of " << expected.size() << " rows" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // same data; the streamed header only differs by its reserved padding
+        const auto streamed = readBytes(streamedPath);
+        const auto collected = readBytes(npyPath);
+        const std::size_t streamedHeader = 10 + npyDict(streamed).size();
+        const std::size_t collectedHeader = 10 + npyDict(collected).size();
+        if (npyDict(streamed).find("'shape': (" + std::to_string(expected.size()) + ", ") == std::string::npos ||
+            streamedHeader % 64 != 0 || streamed.size() - streamedHeader != collected.size() - collectedHeader ||
+            !std::equal(streamed.begin() + static_cast<std::ptrdiff_t>(streamedHeader), streamed.end(),
+                        collected.begin() + static_cast<std::ptrdiff_t>(collectedHeader)))
+        {
+            std::cerr << "Streamed npy differs from the collected matrix" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::filesystem::remove(streamedPath);
+    }
+
+    std::filesystem::remove(npyPath);
+    std::filesystem::remove(npzPath);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "libvoicefeat/libvoicefeat.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    libvoicefeat::audio::AudioBuffer buildTestChirp(int totalSamples, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(totalSamples);
+
+        for (int n = 0; n < totalSamples; ++n)
+        {
+            const float t = static_cast<float>(n) / sampleRate;
+            buffer.samples[n] = 0.5f * std::sin(2.0f * kPi * (200.0f + 900.0f * t) * t)
+                              + 0.1f * std::sin(2.0f * kPi * 3100.0f * t);
+        }
+
+        return buffer;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    constexpr int sampleRate = 16000;
+    const auto buffer = buildTestChirp(sampleRate * 3, sampleRate);
+
+    // -----------------------------
+    // Frame-parallel compute is bitwise identical to the serial path for every feature type
+    // -----------------------------
+    for (auto type : {CepstralType::MFCC, CepstralType::LFCC, CepstralType::GFCC, CepstralType::PNCC, CepstralType::PLP})
+    {
+        CepstralConfig config;
+        config.type = type;
+        config.feature.sampleRate = sampleRate;
+        config.delta.useDeltas = true;
+        config.delta.useDeltaDeltas = true;
+
+        CepstralExtractor serialExtractor(config);
+        const auto serial = serialExtractor.extractFromAudioBuffer(buffer).getComputedMatrix();
+
+        for (int threads : {2, 3, 8})
+        {
+            config.threading.numThreads = threads;
+            CepstralExtractor parallelExtractor(config);
+            const auto parallel = parallelExtractor.extractFromAudioBuffer(buffer).getComputedMatrix();
+
+            if (serial.empty() || parallel != serial)
+            {
+                std::cerr << "Parallel result differs from serial with " << threads << " threads" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Errors thrown inside a parallel block reach the caller
+    // -----------------------------
+    {
+        utils::ThreadPool pool(4);
+        bool thrown = false;
+        try
+        {
+            pool.parallelFor(0, 100, [](std::size_t begin, std::size_t)
+            {
+                if (begin == 0)
+                    throw std::runtime_error("block failed");
+            }, 10);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        if (!thrown)
+        {
+            std::cerr << "parallelFor swallowed a block exception" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // A waiting parallelFor runs only its own blocks, never an unrelated queued task
+    // -----------------------------
+    {
+        utils::ThreadPool pool(4);
+        static thread_local int depth = 0;
+        std::atomic<int> deepest{0};
+
+        pool.parallelFor(0, 32, [&](std::size_t, std::size_t)
+        {
+            ++depth;
+            int seen = deepest.load();
+            while (depth > seen && !deepest.compare_exchange_weak(seen, depth))
+            {
+            }
+            pool.parallelFor(0, 16, [](std::size_t, std::size_t)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }, 1);
+            --depth;
+        }, 1);
+
+        if (deepest.load() != 1)
+        {
+            std::cerr << "An outer block ran inside another one's wait (depth " << deepest.load() << ")"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
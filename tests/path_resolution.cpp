@@ -0,0 +1,122 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/utils/path.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    bool extractionFails(const libvoicefeat::CepstralExtractor& extractor, const std::string& path)
+    {
+        try
+        {
+            (void)extractor.extractFromFile(path);
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string relative{"data/common_voice_en_42698961.wav"};
+    const auto absolute = resolve_from_callsite(relative);
+    const auto root = absolute.parent_path().parent_path();
+    const auto originalCwd = std::filesystem::current_path();
+
+    CepstralExtractor extractor(CepstralConfig{});
+    const auto expected = extractor.extractFromFile(absolute.string()).getComputedMatrix();
+
+    // -----------------------------
+    // Default policy: the call-site search, cached
+    // -----------------------------
+    if (get_path_resolution().mode != PathResolution::SearchFromCallsite)
+    {
+        std::cerr << "Default resolution is not the call-site search" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        if (resolve_path(relative) != absolute)
+        {
+            std::cerr << "Search resolution differs from resolve_from_callsite on call " << i << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (extractor.extractFromFile(relative).getComputedMatrix() != expected)
+    {
+        std::cerr << "Search resolution changed the extracted features" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // a cached directory is re-checked: a file only present elsewhere still resolves through the walk
+    const auto scratch = std::filesystem::temp_directory_path() / "libvoicefeat_path_test";
+    std::filesystem::remove_all(scratch);
+    std::filesystem::create_directories(scratch / "data");
+    std::ofstream(scratch / "data" / "only_here.txt") << "x";
+    std::filesystem::current_path(scratch);
+    if (resolve_path("data/only_here.txt") != std::filesystem::weakly_canonical(scratch / "data" / "only_here.txt"))
+    {
+        std::cerr << "Search resolution returned a stale cached directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Literal: relative paths are taken against the working directory, nothing else
+    // -----------------------------
+    set_path_resolution({PathResolution::Literal, {}});
+    if (resolve_path(relative) != std::filesystem::path(relative) || !extractionFails(extractor, relative))
+    {
+        std::cerr << "Literal resolution searched for the file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::current_path(root);
+    if (extractor.extractFromFile(relative).getComputedMatrix() != expected)
+    {
+        std::cerr << "Literal resolution did not open the path against the working directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // BaseDirectory: relative paths under the base, absolute paths untouched
+    // -----------------------------
+    std::filesystem::current_path(scratch);
+    set_path_resolution({PathResolution::BaseDirectory, root});
+    if (resolve_path(relative) != root / relative || resolve_path(absolute) != absolute ||
+        extractor.extractFromFile(relative).getComputedMatrix() != expected ||
+        !extractionFails(extractor, "data/only_here.wav"))
+    {
+        std::cerr << "BaseDirectory resolution did not use the base directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool threw = false;
+    try
+    {
+        set_path_resolution({PathResolution::BaseDirectory, {}});
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    if (!threw || get_path_resolution().baseDirectory != root)
+    {
+        std::cerr << "An empty base directory was accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    set_path_resolution({});
+    std::filesystem::current_path(originalCwd);
+    std::filesystem::remove_all(scratch);
+    return EXIT_SUCCESS;
+}
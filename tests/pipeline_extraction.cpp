@@ -0,0 +1,105 @@
+#include "libvoicefeat/pipeline_extractor.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    config.delta.useDeltaDeltas = true;
+
+    PipelineOptions options;
+    options.decodeBlockFrames = 3000;
+    options.framesPerBlock = 37;
+    options.queueCapacity = 2;
+    options.extractThreads = 3;
+
+    // -----------------------------
+    // Without resampling the pipeline is bitwise identical to the one-shot extractor
+    // -----------------------------
+    {
+        const std::string wavPath{"data/common_voice_en_42698961.wav"};
+        CepstralExtractor extractor(config);
+        const auto expected = extractor.extractFromFile(wavPath).getComputedMatrix();
+
+        PipelineExtractor pipeline(config, options);
+        const auto actual = pipeline.extractFromFile(wavPath).getComputedMatrix();
+        if (expected.empty() || actual != expected)
+        {
+            std::cerr << "Pipeline output differs from one-shot extraction" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto& stats = pipeline.getStats();
+        if (stats.extract.items != actual.size() || stats.decode.blocks == 0 || stats.resample.blocks == 0)
+        {
+            std::cerr << "Unexpected pipeline statistics" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (stats.resample.maxQueueDepth > options.queueCapacity || stats.extract.maxQueueDepth > options.queueCapacity)
+        {
+            std::cerr << "Queue depth exceeded its capacity" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // With resampling (32 kHz mp3) the frame grid matches and values stay close
+    // -----------------------------
+    {
+        const std::string mp3Path{"data/common_voice_en_42698961.mp3"};
+        CepstralExtractor extractor(config);
+        const auto expected = extractor.extractFromFile(mp3Path).getComputedMatrix();
+
+        PipelineExtractor pipeline(config, options);
+        const auto actual = pipeline.extractFromFile(mp3Path).getComputedMatrix();
+        if (expected.size() != actual.size() || expected.empty())
+        {
+            std::cerr << "Pipeline frame count differs (got " << actual.size() << ", expected "
+                      << expected.size() << ")" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // skip the tail frames touched by the resampler flush
+        for (std::size_t t = 0; t + 4 < expected.size(); ++t)
+        {
+            for (std::size_t d = 0; d < static_cast<std::size_t>(config.feature.numCoeffs); ++d)
+            {
+                if (std::fabs(expected[t][d] - actual[t][d]) > 1e-2f * (1.0f + std::fabs(expected[t][d])))
+                {
+                    std::cerr << "Pipeline value mismatch at frame " << t << ", coefficient " << d << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    // -----------------------------
+    // Native-rate mode frames the 32 kHz mp3 at its own rate, bitwise as the one-shot extractor does
+    // -----------------------------
+    for (auto type : {CepstralType::MFCC, CepstralType::PNCC})
+    {
+        CepstralConfig native = config;
+        native.type = type;
+        native.resampling.nativeRate = true;
+        native.vad.mode = VadMode::Floor;
+
+        const std::string mp3Path{"data/common_voice_en_42698961.mp3"};
+        const auto expected = CepstralExtractor(native).extractFromFile(mp3Path).getComputedMatrix();
+
+        PipelineExtractor pipeline(native, options);
+        const auto actual = pipeline.extractFromFile(mp3Path).getComputedMatrix();
+        if (expected.empty() || actual != expected)
+        {
+            std::cerr << "Native-rate pipeline output differs from one-shot extraction for type "
+                      << static_cast<int>(type) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/features/feature_builder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    libvoicefeat::audio::AudioBuffer buildTone(double hz, double gain, int sampleRate)
+    {
+        libvoicefeat::audio::AudioBuffer buffer;
+        buffer.sampleRate = sampleRate;
+        buffer.samples.resize(static_cast<std::size_t>(sampleRate / 2));
+        for (std::size_t n = 0; n < buffer.samples.size(); ++n)
+        {
+            const double t = static_cast<double>(n) / sampleRate;
+            // a little broadband content keeps the all-pole fit well conditioned
+            buffer.samples[n] = static_cast<float>(gain * (0.5 * std::sin(2.0 * kPi * hz * t) +
+                                                           0.01 * std::sin(2.0 * kPi * 2917.0 * t * t)));
+        }
+        return buffer;
+    }
+
+    // PLP of one magnitude spectrum written out directly: a dense real IDFT of the padded band spectrum, the
+    // normal equations solved by elimination, and the cepstrum integrated from the model's log spectrum.
+    std::vector<double> referencePlp(const std::vector<double>& mag, const libvoicefeat::features::FeaturePlan& plan)
+    {
+        const std::size_t M = plan.filters.size();
+        const int order = plan.options.numCoeffs - 1;
+
+        std::vector<double> padded(M + 2);
+        for (std::size_t m = 0; m < M; ++m)
+        {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < mag.size(); ++k)
+                sum += plan.filters[m][k] * mag[k] * mag[k];
+            padded[m + 1] = std::cbrt(sum);
+        }
+        padded[0] = padded[1];
+        padded[M + 1] = padded[M];
+
+        // the full symmetric spectrum has 2 (M + 1) points
+        const std::size_t L = 2 * (M + 1);
+        std::vector<double> r(order + 1, 0.0);
+        for (int lag = 0; lag <= order; ++lag)
+        {
+            for (std::size_t j = 0; j < L; ++j)
+            {
+                const double value = padded[j <= M + 1 ? j : L - j];
+                r[lag] += value * std::cos(2.0 * kPi * static_cast<double>(lag * j) / static_cast<double>(L));
+            }
+            r[lag] /= static_cast<double>(L);
+        }
+
+        // R a = r[1..order] with R[i][j] = r[|i - j|]
+        std::vector<std::vector<double>> A(order, std::vector<double>(order + 1));
+        for (int i = 0; i < order; ++i)
+        {
+            for (int j = 0; j < order; ++j)
+                A[i][j] = r[std::abs(i - j)];
+            A[i][order] = r[i + 1];
+        }
+        for (int col = 0; col < order; ++col)
+        {
+            for (int row = col + 1; row < order; ++row)
+            {
+                const double f = A[row][col] / A[col][col];
+                for (int c = col; c <= order; ++c)
+                    A[row][c] -= f * A[col][c];
+            }
+        }
+        std::vector<double> a(order + 1, 0.0);
+        for (int i = order - 1; i >= 0; --i)
+        {
+            double sum = A[i][order];
+            for (int j = i + 1; j < order; ++j)
+                sum -= A[i][j] * a[j + 1];
+            a[i + 1] = sum / A[i][i];
+        }
+
+        double error = r[0];
+        for (int k = 1; k <= order; ++k)
+            error -= a[k] * r[k];
+
+        std::vector<double> c(static_cast<std::size_t>(plan.options.numCoeffs), 0.0);
+        c[0] = std::log(error);
+        constexpr int steps = 1 << 14;
+        for (int s = 0; s < steps; ++s)
+        {
+            const double w = kPi * (s + 0.5) / steps;
+            double re = 1.0, im = 0.0;
+            for (int k = 1; k <= order; ++k)
+            {
+                re -= a[k] * std::cos(k * w);
+                im += a[k] * std::sin(k * w);
+            }
+            const double logPower = -std::log(re * re + im * im);
+            for (std::size_t n = 1; n < c.size(); ++n)
+                c[n] += logPower * std::cos(static_cast<double>(n) * w) / steps;
+        }
+        return c;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using namespace libvoicefeat::features;
+
+    constexpr int sampleRate = 16000;
+
+    CepstralConfig config;
+    config.type = CepstralType::PLP;
+    config.feature.includeEnergy = false;
+
+    // -----------------------------
+    // The recursions match a direct solution of the same all-pole model
+    // -----------------------------
+    {
+        auto feature = FeatureFactory::createDefaultFeature(config);
+        feature.prepare(512);
+        const auto& plan = *feature.getPlan();
+        if (plan.options.transform != CepstralTransform::LPC || plan.idft.size() != 13)
+        {
+            std::cerr << "Default PLP does not use a 12th-order LPC transform" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<double> mag(static_cast<std::size_t>(plan.nFreqs));
+        for (std::size_t k = 0; k < mag.size(); ++k)
+        {
+            const double f = static_cast<double>(k) * sampleRate / plan.nFft;
+            mag[k] = 1.0 / (1.0 + std::pow((f - 700.0) / 150.0, 2.0)) + 0.3 / (1.0 + std::pow((f - 2400.0) / 300.0, 2.0)) +
+                     0.01;
+        }
+
+        const auto got = feature.computeFromSpectrum(dsp::Frame{std::vector<float>(400, 0.1f)}, mag);
+        const auto expected = referencePlp(mag, plan);
+        if (got.size() != expected.size())
+        {
+            std::cerr << "PLP produced " << got.size() << " coefficients" << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (std::size_t n = 0; n < got.size(); ++n)
+        {
+            if (std::fabs(got[n] - expected[n]) > 1e-4 * std::max(1.0, std::fabs(expected[n])))
+            {
+                std::cerr << "PLP c" << n << " is " << got[n] << ", expected " << expected[n] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Gain only moves c0, by the cube root of the power ratio
+    // -----------------------------
+    {
+        CepstralExtractor extractor(config);
+        const auto quiet = extractor.extractFromAudioBuffer(buildTone(440.0, 0.25, sampleRate)).getComputedMatrix();
+        const auto loud = extractor.extractFromAudioBuffer(buildTone(440.0, 0.5, sampleRate)).getComputedMatrix();
+        const double shift = std::log(4.0) / 3.0;
+
+        for (std::size_t t = 0; t < quiet.size(); ++t)
+        {
+            if (std::fabs(loud[t][0] - quiet[t][0] - shift) > 1e-4)
+            {
+                std::cerr << "Frame " << t << ": c0 moved by " << loud[t][0] - quiet[t][0] << std::endl;
+                return EXIT_FAILURE;
+            }
+            for (std::size_t n = 1; n < quiet[t].size(); ++n)
+            {
+                if (std::fabs(loud[t][n] - quiet[t][n]) > 1e-4)
+                {
+                    std::cerr << "Frame " << t << ": c" << n << " depends on the gain" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    // -----------------------------
+    // c1 follows the spectral tilt
+    // -----------------------------
+    {
+        CepstralExtractor extractor(config);
+        const auto low = extractor.extractFromAudioBuffer(buildTone(300.0, 0.5, sampleRate)).getComputedMatrix();
+        const auto high = extractor.extractFromAudioBuffer(buildTone(6000.0, 0.5, sampleRate)).getComputedMatrix();
+        if (low[10][1] <= 0.f || high[10][1] >= 0.f)
+        {
+            std::cerr << "c1 is " << low[10][1] << " for a low tone and " << high[10][1] << " for a high one"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Speech and silence give finite rows of the configured width
+    // -----------------------------
+    {
+        config.feature.includeEnergy = true;
+        config.delta.useDeltas = true;
+        CepstralExtractor extractor(config);
+
+        const auto speech = extractor.extractFromFile("data/common_voice_en_42698961.wav").getComputedMatrix();
+        audio::AudioBuffer silence{std::vector<float>(sampleRate, 0.f), sampleRate};
+        const auto quiet = extractor.extractFromAudioBuffer(silence).getComputedMatrix();
+
+        for (const auto* matrix : {&speech, &quiet})
+        {
+            if (matrix->empty())
+            {
+                std::cerr << "PLP produced no frames" << std::endl;
+                return EXIT_FAILURE;
+            }
+            for (const auto& row : *matrix)
+            {
+                if (row.size() != 26 ||
+                    !std::all_of(row.begin(), row.end(), [](float v) { return std::isfinite(v); }))
+                {
+                    std::cerr << "PLP row is malformed" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
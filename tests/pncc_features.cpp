@@ -0,0 +1,172 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/pipeline_extractor.h"
+#include "libvoicefeat/features/feature_builder.h"
+#include "libvoicefeat/features/pncc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Mean over coefficients of the RMS difference between two matrices, relative to each column's spread in a.
+    double relativeDistance(const libvoicefeat::FeatureMatrix& a, const libvoicefeat::FeatureMatrix& b)
+    {
+        const std::size_t cols = a.front().size();
+        double total = 0.0;
+        for (std::size_t c = 0; c < cols; ++c)
+        {
+            double mean = 0.0;
+            for (const auto& row : a)
+                mean += row[c];
+            mean /= static_cast<double>(a.size());
+
+            double var = 0.0, err = 0.0;
+            for (std::size_t t = 0; t < a.size(); ++t)
+            {
+                var += (a[t][c] - mean) * (a[t][c] - mean);
+                err += (a[t][c] - b[t][c]) * (a[t][c] - b[t][c]);
+            }
+            total += std::sqrt(err / std::max(var, 1e-30));
+        }
+        return total / static_cast<double>(cols);
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using namespace libvoicefeat::features;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+
+    CepstralConfig config;
+    config.type = CepstralType::PNCC;
+    config.feature.includeEnergy = false;
+    CepstralExtractor extractor(config);
+    const auto clean = createAudioReader(wavPath)->load(wavPath);
+    const auto reference = extractor.extractFromAudioBuffer(clean).getComputedMatrix();
+
+    // -----------------------------
+    // Rows streamed one at a time match finish() bitwise, M frames behind the input
+    // -----------------------------
+    {
+        const auto frames = extractor.extractFrames(clean);
+        auto feature = FeatureFactory::createDefaultFeature(config);
+        feature.prepare(extractor.getTransformer(), frames.front());
+
+        StreamingCepstra stream(feature);
+        FeatureMatrix streamed;
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            stream.push(feature.computeFrame(frames[i], extractor.getTransformer()), streamed);
+            const std::size_t expected = i + 1 > PnccStage::kMediumWindow ? i + 1 - PnccStage::kMediumWindow : 0;
+            if (streamed.size() != expected)
+            {
+                std::cerr << "After " << i + 1 << " frames " << streamed.size() << " rows were out" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        stream.finish(streamed);
+        if (streamed != reference)
+        {
+            std::cerr << "Streamed PNCC differs from batch PNCC" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // The pipeline's row sink matches one-shot extraction
+    // -----------------------------
+    {
+        CepstralConfig withDeltas = config;
+        withDeltas.feature.includeEnergy = true;
+        withDeltas.delta.useDeltas = true;
+        const auto expected = CepstralExtractor(withDeltas).extractFromFile(wavPath).getComputedMatrix();
+
+        PipelineOptions options;
+        options.framesPerBlock = 37;
+        options.extractThreads = 3;
+        PipelineExtractor pipeline(withDeltas, options);
+        FeatureMatrix sunk;
+        pipeline.extractFromFile(wavPath, [&](const FeatureVector& row) { sunk.push_back(row); });
+        if (sunk != expected || pipeline.extractFromFile(wavPath).getComputedMatrix() != expected)
+        {
+            std::cerr << "Pipeline PNCC differs from one-shot extraction" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Output does not depend on the input level
+    // -----------------------------
+    {
+        auto loud = clean;
+        for (auto& s : loud.samples)
+            s *= 0.25f;
+        const auto scaled = extractor.extractFromAudioBuffer(loud).getComputedMatrix();
+        for (std::size_t t = 0; t < reference.size(); ++t)
+        {
+            for (std::size_t c = 0; c < reference[t].size(); ++c)
+            {
+                if (std::fabs(scaled[t][c] - reference[t][c]) > 1e-3f * std::max(1.f, std::fabs(reference[t][c])))
+                {
+                    std::cerr << "Frame " << t << ", c" << c << " changes with the input level" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    // -----------------------------
+    // Stationary noise moves PNCC less than MFCC
+    // -----------------------------
+    {
+        double power = 0.0;
+        for (float s : clean.samples)
+            power += static_cast<double>(s) * s;
+        power /= static_cast<double>(clean.samples.size());
+
+        auto noisy = clean;
+        std::mt19937 rng(7);
+        std::normal_distribution<float> noise(0.f, static_cast<float>(std::sqrt(power / 10.0)));   // 10 dB SNR
+        for (auto& s : noisy.samples)
+            s += noise(rng);
+
+        CepstralConfig mfccConfig = config;
+        mfccConfig.type = CepstralType::MFCC;
+        CepstralExtractor mfcc(mfccConfig);
+
+        const double pnccDistance = relativeDistance(reference, extractor.extractFromAudioBuffer(noisy).getComputedMatrix());
+        const double mfccDistance = relativeDistance(mfcc.extractFromAudioBuffer(clean).getComputedMatrix(),
+                                                     mfcc.extractFromAudioBuffer(noisy).getComputedMatrix());
+        std::cout << "Relative distortion at 10 dB SNR: PNCC " << pnccDistance << ", MFCC " << mfccDistance << std::endl;
+        if (!(pnccDistance < mfccDistance))
+        {
+            std::cerr << "PNCC is not more robust to noise than MFCC" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Time ranges settle close to the full-file rows (the warm-up starts 1.5 s into the file)
+    // -----------------------------
+    {
+        const auto range = extractor.extractRange(wavPath, 11.5, 13.0).getComputedMatrix();
+        const auto first = static_cast<std::size_t>(std::ceil(11.5 * 16000 / 160));
+        const FeatureMatrix full(reference.begin() + static_cast<std::ptrdiff_t>(first),
+                                 reference.begin() + static_cast<std::ptrdiff_t>(first + range.size()));
+        const double distance = relativeDistance(full, range);
+        std::cout << "Range rows differ by " << distance << " of the column spread" << std::endl;
+        if (range.size() != 150 || distance > 0.1)
+        {
+            std::cerr << "PNCC range rows are too far from the full-file rows" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
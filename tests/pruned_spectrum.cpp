@@ -0,0 +1,189 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/multi_feature_extractor.h"
+#include "libvoicefeat/dsp/fft_transformer.h"
+#include "libvoicefeat/dsp/pruned_transformer.h"
+#include "libvoicefeat/features/feature_builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Largest |a - b| over the bins, relative to the largest |b| of the frame.
+    double spectrumError(const std::vector<std::complex<float>>& a, const std::vector<std::complex<float>>& b,
+                         std::size_t begin, std::size_t end)
+    {
+        double peak = 0.0, error = 0.0;
+        for (const auto& v : b)
+            peak = std::max(peak, static_cast<double>(std::abs(v)));
+        for (std::size_t k = begin; k < end; ++k)
+            error = std::max(error, static_cast<double>(std::abs(a[k] - b[k])));
+        return error / peak;
+    }
+
+    double maxDifference(const libvoicefeat::FeatureMatrix& a, const libvoicefeat::FeatureMatrix& b)
+    {
+        double worst = a.size() == b.size() ? 0.0 : INFINITY;
+        for (std::size_t t = 0; t < std::min(a.size(), b.size()); ++t)
+            for (std::size_t i = 0; i < std::min(a[t].size(), b[t].size()); ++i)
+                worst = std::max(worst, static_cast<double>(std::abs(a[t][i] - b[t][i])));
+        return worst;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+    using dsp::PrunedTransformer;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+
+    // -----------------------------
+    // Pruned bins match the full FFT, for both methods and any frame length up to the FFT size
+    // -----------------------------
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+
+        for (std::size_t length : {400u, 512u, 37u})
+        {
+            std::vector<float> frame(length);
+            for (auto& x : frame)
+                x = uniform(rng);
+
+            std::vector<float> padded = frame;
+            padded.resize(512, 0.f);
+            const auto full = FFTTransformer(512).transform(padded);
+            for (auto method : {PrunedTransformer::Method::HalfLength, PrunedTransformer::Method::Goertzel})
+            {
+                for (auto range : {std::pair<std::size_t, std::size_t>{1, 128}, {7, 9}, {0, 257}, {200, 512}})
+                {
+                    const PrunedTransformer pruned(512, range.first, range.second, method);
+                    const auto spec = pruned.transform(frame);
+                    const double error = spectrumError(spec, full, range.first, range.second);
+                    bool zeroOutside = spec.size() == full.size();
+                    for (std::size_t k = 0; zeroOutside && k < spec.size(); ++k)
+                        zeroOutside = (k >= range.first && k < range.second) || spec[k] == std::complex<float>{};
+                    if (error > 1e-4 || !zeroOutside)
+                    {
+                        std::cerr << "Pruned bins [" << range.first << ", " << range.second << ") of a " << length
+                                  << "-sample frame are off by " << error << std::endl;
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+
+        // a handful of bins is cheaper one at a time, a wide band through the half-length FFT; widening a
+        // Goertzel range (as multi-feature groups do) must switch the choice once the band grows
+        if (PrunedTransformer(512, 10, 12).getMethod() != PrunedTransformer::Method::Goertzel ||
+            PrunedTransformer(512, 1, 128).getMethod() != PrunedTransformer::Method::HalfLength ||
+            PrunedTransformer::cheaperMethod(512, 10, 12) != PrunedTransformer::Method::Goertzel ||
+            PrunedTransformer::cheaperMethod(512, 10, 60) != PrunedTransformer::Method::HalfLength)
+        {
+            std::cerr << "Unexpected pruning method choice" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // A 4 kHz band on 16 kHz audio prunes; full-band plans do not
+    // -----------------------------
+    CepstralConfig narrow;
+    narrow.feature.maxFreq = 4000.0;
+    {
+        for (auto type : {CepstralType::MFCC, CepstralType::LFCC, CepstralType::GFCC, CepstralType::PNCC,
+                          CepstralType::PLP})
+        {
+            CepstralConfig config = narrow;
+            config.type = type;
+            const auto plan = CepstralExtractor(config).extractFromFile(wavPath).getPlan();
+            CepstralConfig wide = config;
+            wide.feature.maxFreq = 8000.0;
+            const auto widePlan = CepstralExtractor(wide).extractFromFile(wavPath).getPlan();
+
+            if (!plan->pruned || plan->binEnd > 129 || widePlan->pruned || widePlan->binEnd < 250)
+            {
+                std::cerr << "Unexpected pruning for type " << static_cast<int>(type) << ": bins ["
+                          << plan->binBegin << ", " << plan->binEnd << ")" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Features agree with the full FFT to rounding
+    // -----------------------------
+    const auto audio = createAudioReader(wavPath)->load(wavPath);
+    {
+        const CepstralExtractor extractor(narrow);
+        const auto pruned = extractor.extractFromAudioBuffer(audio);
+
+        // same tables without the pruned transform, so every frame goes through the full FFT
+        const auto& transformer = extractor.getTransformer();
+        auto feature = FeatureFactory::createDefaultFeature(narrow);
+        auto plan = std::make_shared<features::FeaturePlan>(*feature.makePlan(static_cast<int>(transformer.size())));
+        plan->pruned.reset();
+        feature.setPlan(plan);
+        const auto& reference = feature.compute(extractor.extractFrames(audio), transformer);
+
+        const double difference = maxDifference(pruned.getComputedMatrix(), reference);
+        std::cout << "Largest difference to the full FFT: " << difference << std::endl;
+        if (difference > 1e-3)
+        {
+            std::cerr << "Pruned features drift from the full FFT" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Multi-feature extraction shares pruned spectra and still matches separate runs bitwise
+    // -----------------------------
+    {
+        const std::vector<CepstralType> types{CepstralType::MFCC, CepstralType::GFCC, CepstralType::PNCC,
+                                              CepstralType::PLP};
+        const auto multi = MultiFeatureExtractor(narrow, types).extractFromAudioBuffer(audio);
+        for (auto type : types)
+        {
+            CepstralConfig config = narrow;
+            config.type = type;
+            const auto separate = CepstralExtractor(config).extractFromAudioBuffer(audio);
+            if (multi.at(type).getComputedMatrix() != separate.getComputedMatrix())
+            {
+                std::cerr << "Multi-feature rows differ for type " << static_cast<int>(type) << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Timing (informational)
+    // -----------------------------
+    {
+        const PrunedTransformer pruned(512, 1, 128);
+        const FFTTransformer full(512);
+        std::vector<float> frame(400, 0.25f);
+
+        const auto time = [&](const dsp::ITransformer& transformer)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            float sink = 0.f;
+            for (int i = 0; i < 2000; ++i)
+                sink += transformer.transform(frame)[5].real();
+            const auto stop = std::chrono::steady_clock::now();
+            static_cast<void>(sink);
+            return std::chrono::duration<double, std::micro>(stop - start).count() / 2000.0;
+        };
+        std::cout << "Full FFT " << time(full) << " us/frame, pruned 0-4 kHz " << time(pruned) << " us/frame"
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
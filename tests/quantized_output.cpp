@@ -0,0 +1,169 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/io/quantized_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* name(libvoicefeat::QuantizationType type)
+    {
+        switch (type)
+        {
+        case libvoicefeat::QuantizationType::Float16: return "float16";
+        case libvoicefeat::QuantizationType::Int8: return "int8";
+        case libvoicefeat::QuantizationType::Int16: return "int16";
+        }
+        return "?";
+    }
+
+    // Worst RMS reconstruction error over the columns, relative to the column's standard deviation.
+    double worstRelativeRms(const libvoicefeat::FeatureMatrix& got, const libvoicefeat::FeatureMatrix& expected)
+    {
+        double worst = 0.0;
+        const std::size_t cols = expected.front().size();
+        const auto rows = static_cast<double>(expected.size());
+        for (std::size_t c = 0; c < cols; ++c)
+        {
+            double mean = 0.0;
+            for (const auto& row : expected)
+                mean += row[c];
+            mean /= rows;
+
+            double variance = 0.0, squaredError = 0.0;
+            for (std::size_t r = 0; r < expected.size(); ++r)
+            {
+                variance += (expected[r][c] - mean) * (expected[r][c] - mean);
+                squaredError += static_cast<double>(got[r][c] - expected[r][c]) * (got[r][c] - expected[r][c]);
+            }
+            worst = std::max(worst, std::sqrt(squaredError / rows) / std::max(1e-9, std::sqrt(variance / rows)));
+        }
+        return worst;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+    const auto filePath = std::filesystem::temp_directory_path() / "libvoicefeat_quantized_test.lvfq";
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    config.delta.useDeltaDeltas = true;
+    CepstralExtractor extractor(config);
+    const auto reference = extractor.extractFromFile(wavPath).getComputedMatrix();
+    const std::size_t cols = reference.front().size();
+
+    // -----------------------------
+    // Reconstruction error per type, against the float32 features
+    // -----------------------------
+    struct Expectation
+    {
+        QuantizationType type;
+        std::size_t compression;
+        double maxRelativeRms;
+    };
+    for (const auto& expectation : {Expectation{QuantizationType::Float16, 2, 1e-3},
+                                    Expectation{QuantizationType::Int8, 4, 2e-2},
+                                    Expectation{QuantizationType::Int16, 2, 1e-4}})
+    {
+        const auto quantized = extractor.extractQuantized(wavPath, expectation.type);
+        if (quantized.rows != reference.size() || quantized.cols != cols ||
+            quantized.data.size() * expectation.compression != reference.size() * cols * sizeof(float))
+        {
+            std::cerr << name(expectation.type) << ": unexpected shape or storage size" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto restored = quantized.dequantize();
+        for (std::size_t r = 0; r < reference.size(); ++r)
+        {
+            for (std::size_t c = 0; c < cols; ++c)
+            {
+                const float expected = reference[r][c];
+                const float error = std::abs(restored[r][c] - expected);
+                // half: 11 significant bits; affine: half a step, plus float rounding of offset + scale * q
+                const float bound = expectation.type == QuantizationType::Float16
+                                        ? std::max(std::abs(expected) * 0x1p-11f, 0x1p-25f)
+                                        : quantized.scale[c] * 0.5f * 1.001f + std::abs(expected) * 1e-6f;
+                if (!(error <= bound) || quantized.at(r, c) != restored[r][c])
+                {
+                    std::cerr << name(expectation.type) << ": element (" << r << ", " << c << ") off by " << error
+                              << ", bound " << bound << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        const double relativeRms = worstRelativeRms(restored, reference);
+        std::cout << name(expectation.type) << ": " << expectation.compression << "x smaller, worst column RMS error "
+                  << relativeRms * 100.0 << " % of its standard deviation" << std::endl;
+        if (relativeRms > expectation.maxRelativeRms)
+        {
+            std::cerr << name(expectation.type) << ": reconstruction error too large" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // -----------------------------
+        // File round trip
+        // -----------------------------
+        io::writeQuantized(filePath, quantized);
+        const auto loaded = io::readQuantized(filePath);
+        const std::size_t parameterBytes = expectation.type == QuantizationType::Float16 ? 0 : 2 * cols * sizeof(float);
+        if (loaded.type != quantized.type || loaded.rows != quantized.rows || loaded.cols != quantized.cols ||
+            loaded.scale != quantized.scale || loaded.offset != quantized.offset || loaded.data != quantized.data ||
+            io::readDequantized(filePath) != restored ||
+            std::filesystem::file_size(filePath) != 32 + parameterBytes + quantized.data.size())
+        {
+            std::cerr << name(expectation.type) << ": file round trip changed the matrix" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Edge cases: constant and extreme columns, empty and ragged input
+    // -----------------------------
+    const FeatureMatrix edges{{3.5f, -1000.0f, 0.0f}, {3.5f, 1000.0f, 1e-3f}, {3.5f, 0.0f, 2e-3f}};
+    for (const auto type : {QuantizationType::Int8, QuantizationType::Int16})
+    {
+        const auto restored = quantize(edges, type).dequantize();
+        if (restored[0][0] != 3.5f || restored[1][0] != 3.5f || restored[0][1] != -1000.0f ||
+            std::abs(restored[1][1] - 1000.0f) > 1e-3f)
+        {
+            std::cerr << name(type) << ": column extremes or constants not reconstructed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!quantize(FeatureMatrix{}, QuantizationType::Int8).empty())
+    {
+        std::cerr << "Empty matrix did not quantize to an empty matrix" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool threw = false;
+    try
+    {
+        (void)quantize(FeatureMatrix{{1.0f, 2.0f}, {1.0f}}, QuantizationType::Int16);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        std::cerr << "Ragged matrix was quantized" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(filePath);
+    return EXIT_SUCCESS;
+}
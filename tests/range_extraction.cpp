@@ -0,0 +1,179 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Rows [first, first + count) of the full matrix.
+    libvoicefeat::FeatureMatrix slice(const libvoicefeat::FeatureMatrix& full, std::size_t first, std::size_t count)
+    {
+        first = std::min(first, full.size());
+        count = std::min(count, full.size() - first);
+        return {full.begin() + static_cast<std::ptrdiff_t>(first), full.begin() + static_cast<std::ptrdiff_t>(first + count)};
+    }
+
+    // Largest difference relative to the spread of each column of the reference.
+    double maxRelativeError(const libvoicefeat::FeatureMatrix& got, const libvoicefeat::FeatureMatrix& expected)
+    {
+        double worst = 0.0;
+        const std::size_t cols = expected.front().size();
+        for (std::size_t c = 0; c < cols; ++c)
+        {
+            float lo = expected.front()[c], hi = lo;
+            for (const auto& row : expected)
+            {
+                lo = std::min(lo, row[c]);
+                hi = std::max(hi, row[c]);
+            }
+            const double spread = std::max(1e-3, static_cast<double>(hi - lo));
+            for (std::size_t r = 0; r < expected.size(); ++r)
+                worst = std::max(worst, std::abs(static_cast<double>(got[r][c] - expected[r][c])) / spread);
+        }
+        return worst;
+    }
+
+    struct Range
+    {
+        double start;
+        double end;
+    };
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+    const std::string mp3Path{"data/common_voice_en_42698961.mp3"};
+
+    // -----------------------------
+    // Seeking: reading after seek(k) gives the frames a full decode has at k
+    // -----------------------------
+    for (const auto& path : {wavPath, mp3Path})
+    {
+        const auto full = createAudioReader(path)->load(path);
+        auto stream = createAudioReader(path)->open(path);
+        for (const std::size_t frame : {std::size_t{12345}, std::size_t{777}, full.samples.size() - 100})
+        {
+            stream->seek(frame);
+            const auto part = readMono(*stream, 4000);
+            const std::vector<float> expected(full.samples.begin() + static_cast<std::ptrdiff_t>(frame),
+                                              full.samples.begin() + static_cast<std::ptrdiff_t>(std::min(full.samples.size(), frame + 4000)));
+            if (part.samples != expected)
+            {
+                std::cerr << "Read after seek(" << frame << ") differs from the full decode of " << path << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        stream->seek(full.samples.size() + 10);
+        if (readMono(*stream, 10).samples.size() != 0)
+        {
+            std::cerr << "Seek past the end did not end the stream" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::vector<Range> ranges{{0.0, 0.4}, {1.0, 2.5}, {3.017, 3.9}, {12.5, 20.0}};
+
+    // -----------------------------
+    // Same rate and native-rate mode: rows are identical to the full-file ones
+    // -----------------------------
+    for (const bool nativeMp3 : {false, true})
+    {
+        CepstralConfig config;
+        config.delta.useDeltas = true;
+        config.delta.useDeltaDeltas = true;
+        config.resampling.nativeRate = nativeMp3;
+        CepstralExtractor extractor(config);
+
+        const auto& path = nativeMp3 ? mp3Path : wavPath;
+        const int workingRate = nativeMp3 ? 32000 : 16000;
+        const int step = nativeMp3 ? 320 : 160;
+        const auto full = extractor.extractFromFile(path).getComputedMatrix();
+
+        for (const auto& range : ranges)
+        {
+            const auto first = static_cast<std::size_t>(std::ceil(range.start * workingRate / step));
+            const auto last = static_cast<std::size_t>(std::ceil(range.end * workingRate / step));
+            const auto expected = slice(full, first, last - first);
+            const auto got = extractor.extractRange(path, range.start, range.end).getComputedMatrix();
+            if (expected.empty() || got != expected)
+            {
+                std::cerr << path << (nativeMp3 ? " (native rate)" : "") << " range [" << range.start << ", "
+                          << range.end << "): " << got.size() << " rows, expected " << expected.size() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Resampled input: same frame grid, values within the sinc filter's rounding
+    // -----------------------------
+    {
+        CepstralConfig config;
+        config.delta.useDeltas = true;
+        CepstralExtractor extractor(config);
+        const auto full = extractor.extractFromFile(mp3Path).getComputedMatrix();
+
+        for (const auto& range : ranges)
+        {
+            const auto first = static_cast<std::size_t>(std::ceil(range.start * 100.0));
+            const auto last = static_cast<std::size_t>(std::ceil(range.end * 100.0));
+            const auto expected = slice(full, first, last - first);
+            const auto got = extractor.extractRange(mp3Path, range.start, range.end).getComputedMatrix();
+            if (got.size() != expected.size())
+            {
+                std::cerr << "Resampled range [" << range.start << ", " << range.end << ") has " << got.size()
+                          << " rows, expected " << expected.size() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            const double error = maxRelativeError(got, expected);
+            if (error > 1e-3)
+            {
+                std::cerr << "Resampled range [" << range.start << ", " << range.end << ") differs by " << error
+                          << " of the column spread" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Empty and invalid ranges
+    // -----------------------------
+    CepstralExtractor extractor(CepstralConfig{});
+    if (!extractor.extractRange(wavPath, 2.0, 2.0).getComputedMatrix().empty() ||
+        !extractor.extractRange(wavPath, 100.0, 110.0).getComputedMatrix().empty())
+    {
+        std::cerr << "Empty ranges produced rows" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (const auto& range : {Range{-1.0, 2.0}, Range{3.0, 2.0}, Range{std::nan(""), 1.0}})
+    {
+        bool threw = false;
+        try
+        {
+            (void)extractor.extractRange(wavPath, range.start, range.end);
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::cerr << "Invalid range [" << range.start << ", " << range.end << ") was accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
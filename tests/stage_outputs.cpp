@@ -0,0 +1,225 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/stage_extractor.h"
+#include "libvoicefeat/utils/constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // DCT-II of one row with the plan's basis, as the extractor's per-frame path computes it
+    std::vector<double> dct(const libvoicefeat::FeatureVector& row, const libvoicefeat::features::FeaturePlan& plan)
+    {
+        std::vector<double> out(plan.dct.size(), 0.0);
+        for (std::size_t k = 0; k < plan.dct.size(); ++k)
+            for (std::size_t n = 0; n < row.size(); ++n)
+                out[k] += row[n] * plan.dct[k][n];
+        return out;
+    }
+
+    // Largest |DCT(compressed) - cepstra| over the columns after c0.
+    double cepstraMismatch(const libvoicefeat::StageMatrices& stages)
+    {
+        const auto& rows = stages.cepstra.getComputedMatrix();
+        const auto& plan = *stages.cepstra.getPlan();
+        double worst = rows.size() == stages.compressedEnergies.size() ? 0.0 : INFINITY;
+        for (std::size_t t = 0; t < std::min(rows.size(), stages.compressedEnergies.size()); ++t)
+        {
+            const auto coeffs = dct(stages.compressedEnergies[t], plan);
+            for (std::size_t k = 1; k < coeffs.size(); ++k)
+                worst = std::max(worst, std::abs(coeffs[k] - rows[t][k]));
+        }
+        return worst;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+    const auto audio = createAudioReader(wavPath)->load(wavPath);
+
+    StageSelection all;
+    all.powerSpectrum = all.filterbankEnergies = all.compressedEnergies = true;
+
+    // -----------------------------
+    // Every stage of MFCC from one pass, consistent with each other and with CepstralExtractor
+    // -----------------------------
+    {
+        CepstralConfig config;
+        config.delta.useDeltas = true;
+        const CepstralExtractor extractor(config);
+        const auto stages = StageExtractor(config, all).extractFromAudioBuffer(audio);
+        const auto expected = extractor.extractFromAudioBuffer(audio);
+
+        const auto& plan = *stages.cepstra.getPlan();
+        const auto frames = extractor.extractFrames(audio);
+        if (stages.cepstra.getComputedMatrix() != expected.getComputedMatrix() ||
+            stages.powerSpectrum.size() != frames.size() || stages.filterbankEnergies.size() != frames.size() ||
+            stages.powerSpectrum.front().size() != static_cast<std::size_t>(plan.nFreqs) ||
+            stages.filterbankEnergies.front().size() != plan.filters.size())
+        {
+            std::cerr << "Stage matrices have the wrong shape or cepstra differ" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const std::size_t t = frames.size() / 2;
+        const auto spec = extractor.getTransformer().transform(frames[t].data);
+        double worst = 0.0;
+        for (std::size_t k = 0; k < stages.powerSpectrum[t].size(); ++k)
+        {
+            const double power = std::norm(spec[k]);
+            worst = std::max(worst, std::abs(stages.powerSpectrum[t][k] - power) / (power + 1e-6));
+        }
+        for (std::size_t m = 0; m < plan.filters.size(); ++m)
+        {
+            double band = 0.0;
+            for (std::size_t k = 0; k < plan.filters[m].size(); ++k)
+                band += std::abs(spec[k]) * plan.filters[m][k];
+            worst = std::max(worst, std::abs(stages.filterbankEnergies[t][m] - band) / (band + 1e-6));
+            const double logBand = std::log(band + constants::K_LOG_EPS);
+            worst = std::max(worst, std::abs(stages.compressedEnergies[t][m] - logBand));
+        }
+
+        const double mismatch = cepstraMismatch(stages);
+        std::cout << "Stage error " << worst << ", DCT of log-mel vs cepstra " << mismatch << std::endl;
+        if (worst > 1e-4 || mismatch > 1e-3)
+        {
+            std::cerr << "Stages are not the intermediate values of the cepstra" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // A log-mel request stops before the DCT
+    // -----------------------------
+    {
+        StageSelection logMel;
+        logMel.compressedEnergies = true;
+        logMel.cepstra = false;
+
+        CepstralConfig config;
+        config.threading.numThreads = 3;
+        const auto stages = StageExtractor(config, logMel).extractFromAudioBuffer(audio);
+        const auto full = StageExtractor(config, all).extractFromAudioBuffer(audio);
+        if (stages.compressedEnergies != full.compressedEnergies || !stages.powerSpectrum.empty() ||
+            !stages.filterbankEnergies.empty() || !stages.cepstra.getComputedMatrix().empty() ||
+            stages.cepstra.getPlan())
+        {
+            std::cerr << "Log-mel request returned other stages or different energies" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        bool threw = false;
+        try
+        {
+            static_cast<void>(StageExtractor(config, StageSelection{false, false, false, false}));
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::cerr << "An empty stage selection was accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Band-limited GFCC, PNCC and PLP: cepstra match the extractor, compressed energies are their DCT input
+    // -----------------------------
+    for (auto type : {CepstralType::PNCC, CepstralType::PLP, CepstralType::GFCC})
+    {
+        CepstralConfig config;
+        config.type = type;
+        config.feature.maxFreq = 4000.0;        // pruned spectrum unless the power spectrum is selected
+
+        StageSelection compressed;
+        compressed.compressedEnergies = true;
+        const auto stages = StageExtractor(config, compressed).extractFromAudioBuffer(audio);
+        const auto expected = CepstralExtractor(config).extractFromAudioBuffer(audio);
+        if (stages.cepstra.getComputedMatrix() != expected.getComputedMatrix() ||
+            stages.compressedEnergies.size() != expected.getComputedMatrix().size())
+        {
+            std::cerr << "Cepstra differ for type " << static_cast<int>(type) << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (type != CepstralType::PLP && cepstraMismatch(stages) > 1e-3)
+        {
+            std::cerr << "Compressed energies do not give the cepstra for type " << static_cast<int>(type)
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // The voice activity gate applies to every matrix
+    // -----------------------------
+    for (auto mode : {VadMode::Floor, VadMode::Drop})
+    {
+        CepstralConfig config;
+        config.type = CepstralType::PNCC;
+        config.vad.mode = mode;
+        config.vad.energyThresholdDb = -35.0;
+        const auto stages = StageExtractor(config, all).extractFromAudioBuffer(audio);
+        const auto expected = CepstralExtractor(config).extractFromAudioBuffer(audio);
+
+        const std::size_t rows = expected.getComputedMatrix().size();
+        if (stages.cepstra.getComputedMatrix() != expected.getComputedMatrix() ||
+            stages.cepstra.getVoicedFrames() != expected.getVoicedFrames() || stages.powerSpectrum.size() != rows ||
+            stages.filterbankEnergies.size() != rows || stages.compressedEnergies.size() != rows ||
+            cepstraMismatch(stages) > 1e-3)
+        {
+            std::cerr << "Gated stages disagree in mode " << static_cast<int>(mode) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Native-rate input is framed and planned at the input rate, as CepstralExtractor does it
+    // -----------------------------
+    {
+        AudioBuffer upsampled;
+        upsampled.sampleRate = 2 * audio.sampleRate;
+        upsampled.samples.resize(2 * audio.samples.size());
+        for (std::size_t n = 0; n < upsampled.samples.size(); ++n)
+        {
+            const std::size_t i = n / 2;
+            const float next = i + 1 < audio.samples.size() ? audio.samples[i + 1] : audio.samples[i];
+            upsampled.samples[n] = n % 2 == 0 ? audio.samples[i] : 0.5f * (audio.samples[i] + next);
+        }
+
+        // the band-limited native plan prunes the spectrum, so leave the power spectrum out for bitwise cepstra
+        StageSelection bands = all;
+        bands.powerSpectrum = false;
+        for (auto type : {CepstralType::MFCC, CepstralType::PNCC})
+        {
+            CepstralConfig config;
+            config.type = type;
+            config.resampling.nativeRate = true;
+            config.threading.numThreads = 2;
+            const auto stages = StageExtractor(config, bands).extractFromAudioBuffer(upsampled);
+            const auto spectra = StageExtractor(config, all).extractFromAudioBuffer(upsampled);
+            const auto expected = CepstralExtractor(config).extractFromAudioBuffer(upsampled);
+
+            const auto& plan = *stages.cepstra.getPlan();
+            if (stages.cepstra.getComputedMatrix() != expected.getComputedMatrix() ||
+                plan.options.sampleRate != upsampled.sampleRate || plan.nFft != expected.getPlan()->nFft ||
+                spectra.powerSpectrum.size() != stages.filterbankEnergies.size() ||
+                spectra.powerSpectrum.front().size() != static_cast<std::size_t>(plan.nFreqs) ||
+                (type == CepstralType::MFCC && cepstraMismatch(stages) > 1e-3))
+            {
+                std::cerr << "Native-rate stages disagree for type " << static_cast<int>(type) << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
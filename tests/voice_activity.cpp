@@ -0,0 +1,242 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/multi_feature_extractor.h"
+#include "libvoicefeat/pipeline_extractor.h"
+#include "libvoicefeat/dsp/voice_activity.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    libvoicefeat::dsp::Frame tone(double hz, double amplitude)
+    {
+        libvoicefeat::dsp::Frame frame;
+        for (int n = 0; n < 400; ++n)
+            frame.data.push_back(static_cast<float>(amplitude * std::sin(2.0 * kPi * hz * n / 16000.0)));
+        return frame;
+    }
+
+    libvoicefeat::dsp::Frame noise(double rms, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> gaussian(0.0, rms);
+        libvoicefeat::dsp::Frame frame;
+        for (int n = 0; n < 400; ++n)
+            frame.data.push_back(static_cast<float>(gaussian(rng)));
+        return frame;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const std::string wavPath{"data/common_voice_en_42698961.wav"};
+
+    // -----------------------------
+    // Energy, zero crossings and hangover decide each frame
+    // -----------------------------
+    {
+        VadOptions options;
+        options.hangoverFrames = 2;
+
+        // -55 dB is a mean power of 3.2e-6; a sine's mean power is amplitude^2 / 2
+        const std::vector<bool> single{
+            VoiceActivityDetector(options, 16000).push(tone(300.0, 0.1)),       // -23 dB
+            VoiceActivityDetector(options, 16000).push(tone(300.0, 1.5e-3)),    // -59 dB, few crossings
+            VoiceActivityDetector(options, 16000).push(noise(1.2e-3, 1)),       // -58 dB, many crossings
+            VoiceActivityDetector(options, 16000).push(noise(2e-4, 2)),         // -74 dB
+            VoiceActivityDetector(options, 16000).push(dsp::Frame{std::vector<float>(400, 0.f)})};
+        if (single != std::vector<bool>{true, false, true, false, false})
+        {
+            std::cerr << "Unexpected single-frame decisions" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const dsp::Frame silent{std::vector<float>(400, 0.f)};
+        const std::vector<dsp::Frame> frames{silent, tone(300.0, 0.1), silent, silent, silent, tone(300.0, 0.1), silent};
+        const auto voiced = VoiceActivityDetector::detect(frames, options, 16000);
+        if (voiced != std::vector<bool>{false, true, true, true, false, true, true})
+        {
+            std::cerr << "Hangover does not extend speech by two frames" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    CepstralConfig config;
+    config.delta.useDeltas = true;
+    const auto speech = createAudioReader(wavPath)->load(wavPath);
+
+    // one second of digital silence on each side of the recording
+    AudioBuffer padded;
+    padded.sampleRate = speech.sampleRate;
+    padded.samples.assign(static_cast<std::size_t>(speech.sampleRate), 0.f);
+    padded.samples.insert(padded.samples.end(), speech.samples.begin(), speech.samples.end());
+    padded.samples.insert(padded.samples.end(), static_cast<std::size_t>(speech.sampleRate), 0.f);
+
+    CepstralConfig plain = config;
+    plain.delta.useDeltas = false;
+    const auto ungated = CepstralExtractor(plain).extractFromAudioBuffer(padded).getComputedMatrix();
+
+    // -----------------------------
+    // Floor: speech rows are untouched, every other row is the silence row
+    // -----------------------------
+    {
+        CepstralConfig floorConfig = plain;
+        floorConfig.vad.mode = VadMode::Floor;
+        const CepstralExtractor extractor(floorConfig);
+        const auto feature = extractor.extractFromAudioBuffer(padded);
+        const auto& rows = feature.getComputedMatrix();
+        const auto& voiced = feature.getVoicedFrames();
+        const auto& silence = feature.getPlan()->silence;
+
+        std::cout << "Gated " << rows.size() - voiced.size() << " of " << rows.size() << " frames" << std::endl;
+        if (rows.size() != ungated.size() || voiced.empty() || voiced.front() < 90 ||
+            voiced.back() >= rows.size() - 90)
+        {
+            std::cerr << "Padding around the speech was not gated" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::size_t next = 0;
+        for (std::size_t t = 0; t < rows.size(); ++t)
+        {
+            const bool isSpeech = next < voiced.size() && voiced[next] == t;
+            next += isSpeech ? 1 : 0;
+            if (rows[t] != (isSpeech ? ungated[t] : silence))
+            {
+                std::cerr << "Floor row " << t << " is wrong" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Drop: rows are the speech frames' rows, with deltas over the speech sequence; threads do not matter
+    // -----------------------------
+    CepstralConfig dropConfig = config;
+    dropConfig.vad.mode = VadMode::Drop;
+    const auto dropped = CepstralExtractor(dropConfig).extractFromAudioBuffer(padded);
+    {
+        CepstralConfig dropPlain = plain;
+        dropPlain.vad.mode = VadMode::Drop;
+        const auto statics = CepstralExtractor(dropPlain).extractFromAudioBuffer(padded);
+        const auto& voiced = statics.getVoicedFrames();
+        if (statics.getComputedMatrix().size() != voiced.size() || voiced != dropped.getVoicedFrames())
+        {
+            std::cerr << "Drop mode kept the wrong number of rows" << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (std::size_t i = 0; i < voiced.size(); ++i)
+        {
+            if (statics.getComputedMatrix()[i] != ungated[voiced[i]])
+            {
+                std::cerr << "Dropped row " << i << " is not frame " << voiced[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        CepstralConfig threaded = dropConfig;
+        threaded.threading.numThreads = 4;
+        const auto parallel = CepstralExtractor(threaded).extractFromAudioBuffer(padded);
+        const auto async = CepstralExtractor(dropConfig).extractAsync(padded).get();
+        if (parallel.getComputedMatrix() != dropped.getComputedMatrix() ||
+            async.getComputedMatrix() != dropped.getComputedMatrix() || async.getVoicedFrames() != voiced)
+        {
+            std::cerr << "Threaded or async extraction differs from the serial one" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // The pipeline and multi-feature extraction gate the same frames
+    // -----------------------------
+    for (auto mode : {VadMode::Floor, VadMode::Drop})
+    {
+        CepstralConfig gated = config;
+        gated.vad.mode = mode;
+        gated.vad.energyThresholdDb = -35.0;       // gates pauses inside the recording too
+        const auto expected = CepstralExtractor(gated).extractFromFile(wavPath);
+
+        PipelineOptions options;
+        options.framesPerBlock = 100;
+        options.extractThreads = 3;
+        PipelineExtractor pipeline(gated, options);
+        const auto collected = pipeline.extractFromFile(wavPath);
+
+        FeatureMatrix streamed;
+        pipeline.extractFromFile(wavPath, [&](const FeatureVector& row) { streamed.push_back(row); });
+
+        const auto multi = MultiFeatureExtractor(gated, {CepstralType::MFCC, CepstralType::PNCC}).extractFromFile(wavPath);
+        CepstralConfig pncc = gated;
+        pncc.type = CepstralType::PNCC;
+        const auto expectedPncc = CepstralExtractor(pncc).extractFromFile(wavPath);
+
+        if (expected.getVoicedFrames().size() * 10 > expected.getComputedMatrix().size() * 9 && mode == VadMode::Floor)
+        {
+            std::cerr << "A -35 dB threshold gated almost nothing" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (collected.getComputedMatrix() != expected.getComputedMatrix() ||
+            collected.getVoicedFrames() != expected.getVoicedFrames() || streamed != expected.getComputedMatrix() ||
+            multi.at(CepstralType::MFCC).getComputedMatrix() != expected.getComputedMatrix() ||
+            multi.at(CepstralType::PNCC).getComputedMatrix() != expectedPncc.getComputedMatrix())
+        {
+            std::cerr << "Pipeline or multi-feature rows differ in mode " << static_cast<int>(mode) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // Ranges see the hangover of the frames before them
+    // -----------------------------
+    {
+        CepstralConfig gated = config;
+        gated.vad.mode = VadMode::Floor;
+        gated.vad.energyThresholdDb = -35.0;
+        const CepstralExtractor extractor(gated);
+        const auto full = extractor.extractFromFile(wavPath);
+        const auto range = extractor.extractRange(wavPath, 3.0, 6.0);
+
+        const std::size_t first = 300;
+        const auto& rows = range.getComputedMatrix();
+        bool same = rows.size() == 300;
+        for (std::size_t i = 0; same && i < rows.size(); ++i)
+            same = rows[i] == full.getComputedMatrix()[first + i];
+
+        std::vector<std::size_t> expected;
+        for (std::size_t frame : full.getVoicedFrames())
+        {
+            if (frame >= first && frame < first + rows.size())
+                expected.push_back(frame - first);
+        }
+        if (!same || range.getVoicedFrames() != expected)
+        {
+            std::cerr << "Gated range differs from the full-file rows" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        bool threw = false;
+        try
+        {
+            static_cast<void>(CepstralExtractor(dropConfig).extractRange(wavPath, 3.0, 6.0));
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::cerr << "Drop mode ranges were accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,267 @@
+#include "libvoicefeat/libvoicefeat.h"
+#include "libvoicefeat/audio/audio_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+
+    void appendLe(std::vector<uint8_t>& bytes, uint64_t value, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            bytes.push_back(static_cast<uint8_t>((value >> (8 * i)) & 0xFF));
+    }
+
+    void writeLe(std::ofstream& out, uint32_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    struct WavLayout
+    {
+        uint16_t formatTag = 1;
+        uint16_t bitsPerSample = 16;
+        uint16_t channels = 1;
+        bool extensible = false;
+        bool oddChunkBeforeData = false;
+    };
+
+    void writeWav(const std::filesystem::path& path, const WavLayout& layout, const std::vector<uint8_t>& data)
+    {
+        const uint32_t sampleRate = 8000;
+        const uint32_t blockAlign = layout.channels * layout.bitsPerSample / 8u;
+        const uint32_t fmtSize = layout.extensible ? 40 : 16;
+
+        std::ofstream out(path, std::ios::binary);
+        out.write("RIFF", 4);
+        writeLe(out, 0, 4);     // the reader does not rely on the RIFF size
+        out.write("WAVE", 4);
+        out.write("fmt ", 4);
+        writeLe(out, fmtSize, 4);
+        writeLe(out, layout.extensible ? 0xFFFE : layout.formatTag, 2);
+        writeLe(out, layout.channels, 2);
+        writeLe(out, sampleRate, 4);
+        writeLe(out, sampleRate * blockAlign, 4);
+        writeLe(out, blockAlign, 2);
+        writeLe(out, layout.bitsPerSample, 2);
+        if (layout.extensible)
+        {
+            static const uint8_t guidTail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                                 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+            writeLe(out, 22, 2);
+            writeLe(out, layout.bitsPerSample, 2);
+            writeLe(out, layout.channels == 1 ? 0x4 : 0x3, 4);
+            writeLe(out, layout.formatTag, 2);
+            out.write(reinterpret_cast<const char*>(guidTail), sizeof(guidTail));
+        }
+        if (layout.oddChunkBeforeData)
+        {
+            out.write("LIST", 4);
+            writeLe(out, 5, 4);
+            out.write("abcde", 5);
+            out.put('\0');
+        }
+        out.write("data", 4);
+        writeLe(out, static_cast<uint32_t>(data.size()), 4);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    // Interleaved samples in [-1, 1) that exercise both the vector blocks and the scalar tail.
+    std::vector<double> testSignal(std::size_t count)
+    {
+        std::vector<double> signal(count);
+        for (std::size_t n = 0; n < count; ++n)
+            signal[n] = 0.9 * std::sin(2.0 * kPi * 0.0137 * static_cast<double>(n) + 0.3);
+        signal[0] = -1.0;
+        return signal;
+    }
+
+    std::vector<float> decodeInterleaved(const std::filesystem::path& path, int& channels)
+    {
+        const auto reader = libvoicefeat::createAudioReader(path);
+        const auto planar = reader->loadChannels(path);
+        channels = static_cast<int>(planar.channels.size());
+        const std::size_t frames = planar.channels.empty() ? 0 : planar.channels.front().size();
+
+        std::vector<float> interleaved(frames * planar.channels.size());
+        for (std::size_t c = 0; c < planar.channels.size(); ++c)
+            for (std::size_t i = 0; i < frames; ++i)
+                interleaved[i * planar.channels.size() + c] = planar.channels[c][i];
+        return interleaved;
+    }
+
+    bool check(const std::string& name, const std::vector<float>& got, const std::vector<float>& expected)
+    {
+        if (got != expected)
+        {
+            std::cerr << name << ": decoded samples do not match" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    using namespace libvoicefeat;
+
+    const auto path = std::filesystem::temp_directory_path() / "libvoicefeat_wav_formats_test.wav";
+    constexpr std::size_t frames = 37;
+    constexpr uint16_t channels = 2;
+    const auto signal = testSignal(frames * channels);
+
+    // -----------------------------
+    // Integer PCM and IEEE float, every width, plain and extensible
+    // -----------------------------
+    for (const bool extensible : {false, true})
+    {
+        for (const uint16_t bits : {8, 16, 24, 32})
+        {
+            std::vector<uint8_t> data;
+            std::vector<float> expected;
+            for (double s : signal)
+            {
+                const auto full = static_cast<int64_t>(std::llround(std::ldexp(s, bits - 1)));
+                const int64_t value = std::min<int64_t>(full, (int64_t{1} << (bits - 1)) - 1);
+                appendLe(data, static_cast<uint64_t>(bits == 8 ? value + 128 : value), bits / 8);
+                expected.push_back(static_cast<float>(static_cast<double>(value) / std::ldexp(1.0, bits - 1)));
+            }
+
+            writeWav(path, WavLayout{1, bits, channels, extensible, bits == 24}, data);
+            int decodedChannels = 0;
+            const auto got = decodeInterleaved(path, decodedChannels);
+            if (decodedChannels != channels ||
+                !check("PCM " + std::to_string(bits) + (extensible ? " extensible" : ""), got, expected))
+                return EXIT_FAILURE;
+        }
+
+        for (const uint16_t bits : {32, 64})
+        {
+            std::vector<uint8_t> data;
+            std::vector<float> expected;
+            for (double s : signal)
+            {
+                uint64_t raw = 0;
+                if (bits == 32)
+                {
+                    const auto f = static_cast<float>(s);
+                    uint32_t b;
+                    std::memcpy(&b, &f, sizeof(b));
+                    raw = b;
+                }
+                else
+                {
+                    std::memcpy(&raw, &s, sizeof(raw));
+                }
+                appendLe(data, raw, bits / 8);
+                expected.push_back(static_cast<float>(s));
+            }
+
+            writeWav(path, WavLayout{3, bits, channels, extensible, true}, data);
+            int decodedChannels = 0;
+            if (!check("Float " + std::to_string(bits) + (extensible ? " extensible" : ""),
+                       decodeInterleaved(path, decodedChannels), expected))
+                return EXIT_FAILURE;
+        }
+    }
+
+    // -----------------------------
+    // G.711: every code decodes, with the standard end points and sign symmetry
+    // -----------------------------
+    for (const uint16_t tag : {6, 7})
+    {
+        std::vector<uint8_t> codes(256);
+        for (int c = 0; c < 256; ++c)
+            codes[static_cast<std::size_t>(c)] = static_cast<uint8_t>(c);
+
+        writeWav(path, WavLayout{tag, 8, 1, false, false}, codes);
+        int decodedChannels = 0;
+        const auto got = decodeInterleaved(path, decodedChannels);
+        if (got.size() != 256)
+        {
+            std::cerr << "G.711 file decoded to " << got.size() << " samples" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const bool anchors = tag == 7
+                                 ? got[0x80] == 32124.f / 32768.f && got[0x00] == -32124.f / 32768.f && got[0xFF] == 0.f
+                                 : got[0xD5] == 8.f / 32768.f && got[0x55] == -8.f / 32768.f &&
+                                   got[0xAA] == 32256.f / 32768.f && got[0x2A] == -32256.f / 32768.f;
+        if (!anchors)
+        {
+            std::cerr << (tag == 7 ? "mu-law" : "A-law") << " end points are wrong" << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (int c = 0; c < 128; ++c)
+        {
+            if (got[static_cast<std::size_t>(c)] != -got[static_cast<std::size_t>(c | 0x80)])
+            {
+                std::cerr << (tag == 7 ? "mu-law" : "A-law") << " code " << c << " is not symmetric" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // -----------------------------
+    // Mono load of a 24-bit, 3-channel file averages the channels
+    // -----------------------------
+    {
+        std::vector<uint8_t> data;
+        std::vector<float> expected;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            float sum = 0.f;
+            for (int c = 0; c < 3; ++c)
+            {
+                const int32_t value = (c + 1) * 1000 * static_cast<int32_t>(i) - 400000;
+                appendLe(data, static_cast<uint32_t>(value), 3);
+                sum += static_cast<float>(value) / 8388608.0f;
+            }
+            expected.push_back(sum / 3);
+        }
+
+        writeWav(path, WavLayout{1, 24, 3, true, false}, data);
+        const auto mono = createAudioReader(path)->load(path);
+        if (!check("24-bit downmix", mono.samples, expected))
+            return EXIT_FAILURE;
+    }
+
+    // -----------------------------
+    // Unsupported encodings are rejected
+    // -----------------------------
+    for (const auto& layout : {WavLayout{1, 12, 1, false, false}, WavLayout{3, 16, 1, false, false},
+                               WavLayout{2, 4, 1, false, false}, WavLayout{7, 16, 1, true, false}})
+    {
+        writeWav(path, layout, std::vector<uint8_t>(64, 0));
+        bool threw = false;
+        try
+        {
+            (void)createAudioReader(path)->load(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::cerr << "Format " << layout.formatTag << " with " << layout.bitsPerSample << " bits was accepted"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}